@@ -0,0 +1,107 @@
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "kernel_list.h"
+
+/* Intrusive chained hash table of hlist buckets, like the kernel's include/linux/hashtable.h,
+   but resizable: the bucket array doubles when the table holds more nodes than buckets, so
+   chains stay about one node long however many objects are added.
+
+       struct person { ...; struct hlist_node by_name; };
+       static uint32_t person_hash(const struct hlist_node *n) {
+           return hash_string(hlist_entry(n, struct person, by_name)->name);
+       }
+       struct htable people;
+       htable_init(&people, 4, person_hash);
+       htable_add(&people, &p->by_name, hash_string(p->name));
+       htable_for_each_possible(&people, q, struct person, by_name, hash_string("Bob"))
+           if (strcmp(q->name, "Bob") == 0) ...
+
+   The table owns only its bucket array, never the objects. The caller passes the key's hash
+   on add and lookup (it usually has it at hand); the hash callback is only used to recompute
+   the hashes of existing nodes when the table grows. Not thread safe.
+*/
+
+struct htable {
+    struct hlist_head *buckets;
+    unsigned bits;                                  // 1 << bits buckets
+    size_t count;
+    uint32_t (*hash)(const struct hlist_node *node); // Hash of an already added node
+};
+
+// FNV-1a, for string keys
+static inline uint32_t hash_string(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) h = (h ^ (unsigned char)*s++) * 16777619u;
+    return h;
+}
+
+// Multiplicative hashing (hash_32 in the kernel): the top bits of hash * golden ratio
+static inline uint32_t hash_32(uint32_t val, unsigned bits) {
+    return (val * 0x61C88647u) >> (32 - bits);
+}
+
+static inline int htable_init(struct htable *t, unsigned bits, uint32_t (*hash)(const struct hlist_node *)) {
+    if (bits == 0) bits = 1;
+    t->buckets = (struct hlist_head *)calloc((size_t)1 << bits, sizeof(struct hlist_head));
+    if (!t->buckets) return -ENOMEM;
+    t->bits = bits;
+    t->count = 0;
+    t->hash = hash;
+    return 0;
+}
+
+// Frees the bucket array; the objects are the caller's
+static inline void htable_destroy(struct htable *t) {
+    free(t->buckets);
+    t->buckets = NULL;
+    t->count = 0;
+}
+
+static inline struct hlist_head *htable_bucket(const struct htable *t, uint32_t hash) {
+    return &t->buckets[hash_32(hash, t->bits)];
+}
+
+// Moves every node to a table of 1 << bits buckets
+static inline int htable_resize(struct htable *t, unsigned bits) {
+    struct hlist_head *buckets = (struct hlist_head *)calloc((size_t)1 << bits, sizeof(struct hlist_head));
+    if (!buckets) return -ENOMEM;
+    for (size_t i = 0; i < ((size_t)1 << t->bits); ++i) {
+        struct hlist_node *pos, *n;
+        hlist_for_each_safe(pos, n, &t->buckets[i]) hlist_add_head(pos, &buckets[hash_32(t->hash(pos), bits)]);
+    }
+    free(t->buckets);
+    t->buckets = buckets;
+    t->bits = bits;
+    return 0;
+}
+
+// Duplicate keys are allowed (the table does not compare keys). Fails only if growing fails.
+static inline int htable_add(struct htable *t, struct hlist_node *node, uint32_t hash) {
+    if (t->count >= ((size_t)1 << t->bits) && t->bits < 31) {
+        int err = htable_resize(t, t->bits + 1);
+        if (err) return err;
+    }
+    hlist_add_head(node, htable_bucket(t, hash));
+    t->count++;
+    return 0;
+}
+
+static inline void htable_del(struct htable *t, struct hlist_node *node) {
+    hlist_del(node);
+    t->count--;
+}
+
+// Every object whose key may hash to 'hash': the caller compares keys
+#define htable_for_each_possible(t, pos, type, member, hash) \
+    hlist_for_each_entry(pos, htable_bucket(t, hash), type, member)
+
+// Every object in the table, in no particular order; bkt is a size_t cursor
+#define htable_for_each(t, bkt, pos, type, member) \
+    for (bkt = 0; bkt < ((size_t)1 << (t)->bits); ++bkt) \
+        hlist_for_each_entry(pos, &(t)->buckets[bkt], type, member)
+
+#endif // HASHTABLE_H
@@ -0,0 +1,136 @@
+#ifndef KERNEL_LIST_H
+#define KERNEL_LIST_H
+
+#include <stddef.h>
+
+/* Kernel-style circular doubly linked list (include/linux/list.h), shared by
+   linux_linkedilist.c and the list benchmarks. The node is embedded in the object
+   (struct person { ...; struct list_head list; }) and list_entry() gets back to the object. */
+
+struct list_head {
+    struct list_head *next, *prev;
+};
+
+// Initialize a list head
+#define LIST_HEAD_INIT(name) { &(name), &(name) }
+#define INIT_LIST_HEAD(ptr) do { \
+    (ptr)->next = (ptr); (ptr)->prev = (ptr); \
+} while (0)
+
+// Get the struct from an embedded member
+#define container_of(ptr, type, member) \
+    ((type *)((char *)(ptr) - offsetof(type, member)))
+#define list_entry(ptr, type, member) container_of(ptr, type, member)
+
+static inline void __list_add(struct list_head *new, struct list_head *prev, struct list_head *next) {
+    next->prev = new;
+    new->next = next;
+    new->prev = prev;
+    prev->next = new;
+}
+
+// Add a node right after head (stack order)
+static inline void list_add(struct list_head *new, struct list_head *head) {
+    __list_add(new, head, head->next);
+}
+
+// Add a node right before head (queue order)
+static inline void list_add_tail(struct list_head *new, struct list_head *head) {
+    __list_add(new, head->prev, head);
+}
+
+// Delete a node from the list
+static inline void list_del(struct list_head *entry) {
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+}
+
+static inline int list_empty(const struct list_head *head) {
+    return head->next == head;
+}
+
+// Iterate over the list
+#define list_for_each(pos, head) \
+    for (pos = (head)->next; pos != (head); pos = pos->next)
+
+// Same, safe against removal of pos
+#define list_for_each_safe(pos, n, head) \
+    for (pos = (head)->next, n = pos->next; pos != (head); pos = n, n = pos->next)
+
+/* Same as list_for_each, but asks for the next node while the body works on this one.
+   A list walk is a chain of dependent loads: without the hint each node's cache miss
+   starts only after the previous one has completed. The prefetch overlaps the next miss
+   with the body, so it helps when the body does real work per node; for an empty body the
+   hardware is already waiting on pos->next and the hint changes little. */
+#if defined(__GNUC__) || defined(__clang__)
+#define list_prefetch(x) __builtin_prefetch(x)
+#else
+#define list_prefetch(x) ((void)0)
+#endif
+#define list_for_each_prefetch(pos, head) \
+    for (pos = (head)->next; list_prefetch(pos->next), pos != (head); pos = pos->next)
+
+// Iterate over the objects that embed the nodes
+#define list_for_each_entry(pos, head, type, member) \
+    for (pos = list_entry((head)->next, type, member); &pos->member != (head); \
+         pos = list_entry(pos->member.next, type, member))
+#define list_for_each_entry_prefetch(pos, head, type, member) \
+    for (pos = list_entry((head)->next, type, member); \
+         list_prefetch(pos->member.next), &pos->member != (head); \
+         pos = list_entry(pos->member.next, type, member))
+
+/* hlist: list with a single-pointer head, for hash buckets (half the bucket array of a
+   list_head table). pprev points at the previous node's next field (or the head's first), so
+   a node is removed without knowing its bucket. */
+struct hlist_node {
+    struct hlist_node *next, **pprev;
+};
+
+struct hlist_head {
+    struct hlist_node *first;
+};
+
+#define HLIST_HEAD_INIT { NULL }
+#define INIT_HLIST_HEAD(ptr) ((ptr)->first = NULL)
+
+static inline void INIT_HLIST_NODE(struct hlist_node *h) {
+    h->next = NULL;
+    h->pprev = NULL;
+}
+
+static inline int hlist_unhashed(const struct hlist_node *h) {
+    return !h->pprev;
+}
+
+static inline int hlist_empty(const struct hlist_head *h) {
+    return !h->first;
+}
+
+static inline void hlist_add_head(struct hlist_node *n, struct hlist_head *h) {
+    struct hlist_node *first = h->first;
+    n->next = first;
+    if (first) first->pprev = &n->next;
+    h->first = n;
+    n->pprev = &h->first;
+}
+
+static inline void hlist_del(struct hlist_node *n) {
+    *n->pprev = n->next;
+    if (n->next) n->next->pprev = n->pprev;
+    INIT_HLIST_NODE(n);
+}
+
+#define hlist_entry(ptr, type, member) container_of(ptr, type, member)
+#define hlist_entry_safe(ptr, type, member) ((ptr) ? hlist_entry(ptr, type, member) : NULL)
+
+#define hlist_for_each(pos, head) \
+    for (pos = (head)->first; pos; pos = pos->next)
+
+#define hlist_for_each_safe(pos, n, head) \
+    for (pos = (head)->first; pos && (n = pos->next, 1); pos = n)
+
+#define hlist_for_each_entry(pos, head, type, member) \
+    for (pos = hlist_entry_safe((head)->first, type, member); pos; \
+         pos = hlist_entry_safe(pos->member.next, type, member))
+
+#endif // KERNEL_LIST_H
@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel_list.h"
+#include "slab.h"
+#include "hashtable.h"
+#include "rbtree.h"
+#include "../bench_harness.h"
+
+/* N persons (slab allocated, ages 0-99) on a list_head list, as in linux_linkedilist.c, and
+   also indexed by a resizable hlist hash table on name and an rbtree on age:
+   - lookup_by_name: list_for_each + strcmp until found, vs one hash bucket,
+   - age_range: count persons aged 40-41, full list scan vs rbtree lower bound + in-order walk,
+   - ordered_walk: visit everyone by increasing age; the list must first be copied into an
+     array and sorted (qsort), the rbtree is walked with rb_first/rb_next,
+   - update/erase_insert: remove a random person from all three structures and add a new one.
+   Every structure is then checked after randomized insert/erase phases: the rbtree keeps its
+   red-black invariants (black root, no red node with a red child, same black height on every
+   path) and its order, and the list, hash table and rbtree hold the same persons.
+   Usage: ./linux_index_benchmark [persons] [bench_harness options]   (default 1,000,000) */
+
+struct person {
+    char name[50];
+    int age;
+    struct list_head list;
+    struct hlist_node by_name;
+    struct rb_node by_age;
+};
+
+struct people {
+    struct list_head head;
+    struct htable names;
+    struct rb_root ages;
+    size_t count;
+    char (*queries)[50]; // Names to look up, in random order
+    size_t nqueries, next_query;
+    struct person **sorted; // Scratch array for the list sort
+    unsigned long checksum[2];
+    struct kmem_cache *cache;
+    struct person **members; // Everyone, in no order, to pick whom to erase
+    size_t next_id;          // Names of added persons are never reused
+    uint64_t rng;
+};
+
+static uint32_t person_name_hash(const struct hlist_node *node) {
+    return hash_string(hlist_entry(node, struct person, by_name)->name);
+}
+
+static void add_by_age(struct rb_root *root, struct person *p) {
+    struct rb_node **link = &root->rb_node, *parent = NULL;
+    while (*link) {
+        parent = *link;
+        if (p->age < rb_entry(parent, struct person, by_age)->age) link = &parent->rb_left;
+        else link = &parent->rb_right;
+    }
+    rb_link_node(&p->by_age, parent, link);
+    rb_insert_color(&p->by_age, root);
+}
+
+/* ---------------- lookup by name ---------------- */
+static void bench_lookup_list(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        const char *name = all->queries[all->next_query++ % all->nqueries];
+        struct person *found = NULL;
+        struct list_head *pos;
+        list_for_each(pos, &all->head) {
+            struct person *p = list_entry(pos, struct person, list);
+            if (strcmp(p->name, name) == 0) {
+                found = p;
+                break;
+            }
+        }
+        BENCH_DO_NOT_OPTIMIZE(found);
+        all->checksum[0] += (unsigned long)found->age;
+    }
+}
+
+static void bench_lookup_htable(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        const char *name = all->queries[all->next_query++ % all->nqueries];
+        uint32_t hash = hash_string(name);
+        struct person *found = NULL, *p;
+        htable_for_each_possible(&all->names, p, struct person, by_name, hash) {
+            if (strcmp(p->name, name) == 0) {
+                found = p;
+                break;
+            }
+        }
+        BENCH_DO_NOT_OPTIMIZE(found);
+        all->checksum[1] += (unsigned long)found->age;
+    }
+}
+
+/* ---------------- range query on age ---------------- */
+static void bench_range_list(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        long n = 0;
+        struct list_head *pos;
+        list_for_each(pos, &all->head) {
+            int age = list_entry(pos, struct person, list)->age;
+            n += age >= 40 && age < 42;
+        }
+        BENCH_DO_NOT_OPTIMIZE(n);
+        all->checksum[0] = (unsigned long)n;
+    }
+}
+
+static void bench_range_rbtree(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        struct rb_node *node = all->ages.rb_node, *first = NULL;
+        while (node) {
+            if (rb_entry(node, struct person, by_age)->age >= 40) {
+                first = node;
+                node = node->rb_left;
+            } else {
+                node = node->rb_right;
+            }
+        }
+        long n = 0;
+        for (node = first; node && rb_entry(node, struct person, by_age)->age < 42; node = rb_next(node)) ++n;
+        BENCH_DO_NOT_OPTIMIZE(n);
+        all->checksum[1] = (unsigned long)n;
+    }
+}
+
+/* ---------------- everyone, ordered by age ---------------- */
+static int compare_age(const void *a, const void *b) {
+    int x = (*(struct person *const *)a)->age, y = (*(struct person *const *)b)->age;
+    return (x > y) - (x < y);
+}
+
+static void bench_ordered_list(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        size_t k = 0;
+        struct list_head *pos;
+        list_for_each(pos, &all->head) all->sorted[k++] = list_entry(pos, struct person, list);
+        qsort(all->sorted, k, sizeof(struct person *), compare_age);
+        unsigned long sum = 0;
+        for (size_t j = 0; j < k; ++j) sum = sum * 3 + (unsigned long)all->sorted[j]->age;
+        BENCH_DO_NOT_OPTIMIZE(sum);
+        all->checksum[0] = sum;
+    }
+}
+
+static void bench_ordered_rbtree(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        unsigned long sum = 0;
+        for (struct rb_node *n = rb_first(&all->ages); n; n = rb_next(n))
+            sum = sum * 3 + (unsigned long)rb_entry(n, struct person, by_age)->age;
+        BENCH_DO_NOT_OPTIMIZE(sum);
+        all->checksum[1] = sum;
+    }
+}
+
+/* ---------------- updates ---------------- */
+
+static int add_person(struct people *all) {
+    struct person *p = kmem_cache_alloc(all->cache);
+    if (!p) return -1;
+    snprintf(p->name, sizeof(p->name), "person%zu", all->next_id++);
+    p->age = (int)(bench_next_random(&all->rng) % 100);
+    list_add_tail(&p->list, &all->head);
+    if (htable_add(&all->names, &p->by_name, hash_string(p->name))) return -1;
+    add_by_age(&all->ages, p);
+    all->members[all->count++] = p;
+    return 0;
+}
+
+static void erase_person(struct people *all, size_t k) {
+    struct person *p = all->members[k];
+    list_del(&p->list);
+    htable_del(&all->names, &p->by_name);
+    rb_erase(&p->by_age, &all->ages);
+    kmem_cache_free(all->cache, p);
+    all->members[k] = all->members[--all->count];
+}
+
+static void bench_update(void *ctx, uint64_t iters) {
+    struct people *all = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        erase_person(all, (size_t)(bench_next_random(&all->rng) % all->count));
+        if (add_person(all)) exit(1);
+    }
+}
+
+/* ---------------- consistency ---------------- */
+
+// Black height of the subtree, or -1 if a red-black or parent-link invariant is broken
+static int rb_check(const struct rb_node *n, const struct rb_node *parent) {
+    if (!n) return 1;
+    if (rb_parent(n) != parent) return -1;
+    if (rb_is_red(n) && ((n->rb_left && rb_is_red(n->rb_left)) || (n->rb_right && rb_is_red(n->rb_right))))
+        return -1;
+    int left = rb_check(n->rb_left, n), right = rb_check(n->rb_right, n);
+    if (left < 0 || left != right) return -1;
+    return left + rb_is_black(n);
+}
+
+// Number of broken invariants between the list, the hash table and the rbtree
+static int check_index(const struct people *all) {
+    int bad = 0;
+    if (all->ages.rb_node && !rb_is_black(all->ages.rb_node)) bad++;
+    if (rb_check(all->ages.rb_node, NULL) < 0) bad++;
+
+    size_t in_tree = 0;
+    int previous = -1;
+    for (struct rb_node *n = rb_first(&all->ages); n; n = rb_next(n), ++in_tree) {
+        int age = rb_entry(n, struct person, by_age)->age;
+        if (age < previous) bad++;
+        previous = age;
+    }
+
+    // Each person on the list is found by name in the hash table, and nobody else is in either
+    size_t on_list = 0;
+    struct list_head *pos;
+    list_for_each(pos, &all->head) {
+        struct person *p = list_entry(pos, struct person, list), *q, *found = NULL;
+        htable_for_each_possible(&all->names, q, struct person, by_name, hash_string(p->name)) {
+            if (strcmp(q->name, p->name) == 0) {
+                found = q;
+                break;
+            }
+        }
+        if (found != p) bad++;
+        on_list++;
+    }
+    if (on_list != all->count || in_tree != all->count || all->names.count != all->count) bad++;
+    return bad;
+}
+
+static int report(const struct people *all, const char *what) {
+    printf("    %s results agree: %s\n", what, all->checksum[0] == all->checksum[1] ? "yes" : "NO");
+    return all->checksum[0] != all->checksum[1];
+}
+
+static int report_index(const struct people *all, const char *what) {
+    int bad = check_index(all);
+    printf("    %s: %zu persons, index %s\n", what, all->count, bad ? "INCONSISTENT" : "consistent");
+    return bad != 0;
+}
+
+int main(int argc, char **argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : 1000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    static struct people all;
+    all.cache = kmem_cache_create("person", sizeof(struct person), 0);
+    all.nqueries = 4096;
+    all.queries = malloc(all.nqueries * sizeof(*all.queries));
+    all.sorted = malloc(count * sizeof(struct person *));
+    all.members = malloc(count * sizeof(struct person *));
+    if (!count || !all.cache || !all.queries || !all.sorted || !all.members ||
+        htable_init(&all.names, 4, person_name_hash))
+        return 1;
+    INIT_LIST_HEAD(&all.head);
+    all.ages = RB_ROOT;
+
+    all.rng = 88172645463325252ull;
+    for (size_t i = 0; i < count; ++i)
+        if (add_person(&all)) return 1;
+    for (size_t i = 0; i < all.nqueries; ++i)
+        snprintf(all.queries[i], sizeof(all.queries[i]), "person%zu", (size_t)(bench_next_random(&all.rng) % count));
+    int failures = report_index(&all, "built");
+
+    // The list scan is O(n) per lookup: same query sequence for both, compare the age sums
+    all.next_query = 0;
+    bench_set_items(bench_run(&session, "lookup_by_name/list_scan", bench_lookup_list, &all), 1.0);
+    uint64_t scanned = all.next_query;
+    unsigned long listSum = all.checksum[0];
+    all.next_query = 0;
+    bench_lookup_htable(&all, scanned);
+    all.checksum[0] = listSum;
+    failures += report(&all, "lookup");
+    bench_set_items(bench_run(&session, "lookup_by_name/hash_table", bench_lookup_htable, &all), 1.0);
+
+    bench_set_items(bench_run(&session, "age_range/list_scan", bench_range_list, &all), 1.0);
+    bench_set_items(bench_run(&session, "age_range/rbtree", bench_range_rbtree, &all), 1.0);
+    failures += report(&all, "range");
+
+    bench_set_items(bench_run(&session, "ordered_walk/list_qsort", bench_ordered_list, &all), (double)count);
+    bench_set_items(bench_run(&session, "ordered_walk/rbtree", bench_ordered_rbtree, &all), (double)count);
+    failures += report(&all, "ordered");
+
+    // Every person stays reachable by name until here: the lookups above never miss
+    bench_set_items(bench_run(&session, "update/erase_insert", bench_update, &all), 1.0);
+    failures += report_index(&all, "after updates");
+
+    // Mostly erases, then mostly inserts, so rb_erase rebalances through every case
+    for (int phase = 0; phase < 2; ++phase) {
+        for (size_t i = 0; i < 2 * count; ++i) {
+            int erase = bench_next_random(&all.rng) % 10 < (phase == 0 ? 7u : 3u);
+            if (erase && all.count) erase_person(&all, (size_t)(bench_next_random(&all.rng) % all.count));
+            else if (!erase && all.count < count && add_person(&all)) return 1;
+        }
+        failures += report_index(&all, phase == 0 ? "erase-heavy phase" : "insert-heavy phase");
+    }
+
+    printf("\nper person: %zu bytes object (list_head %zu, hlist_node %zu, rb_node %zu) + %.1f bytes of buckets\n",
+           sizeof(struct person), sizeof(struct list_head), sizeof(struct hlist_node), sizeof(struct rb_node),
+           (double)((size_t)sizeof(struct hlist_head) << all.names.bits) / (double)count);
+
+    struct list_head *pos, *n;
+    list_for_each_safe(pos, n, &all.head) kmem_cache_free(all.cache, list_entry(pos, struct person, list));
+    htable_destroy(&all.names);
+    kmem_cache_destroy(all.cache);
+    free(all.queries);
+    free(all.sorted);
+    free(all.members);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
@@ -13,44 +13,77 @@ Welcome to GDB Online.
 #include <stdlib.h>
 #include <string.h>
 
-// Kernel-style linked list implementation
-struct list_head {
-    struct list_head *next, *prev;
-};
-
-// Initialize a list head
-#define INIT_LIST_HEAD(ptr) do { \
-    (ptr)->next = (ptr); (ptr)->prev = (ptr); \
-} while (0)
-
-// Embedded structure
+// Kernel-style linked list implementation (list_head, list_add, list_del, list_for_each, list_entry)
+#include "kernel_list.h"
+// Per-type object cache: all persons come from packed slabs instead of scattered malloc blocks
+#include "slab.h"
+// Same embedding, other indexes: hash table of hlist buckets by name, red-black tree by age
+#include "hashtable.h"
+#include "rbtree.h"
+
+// Embedded structure: one node per index the person is on
 struct person {
     char name[50];
     int age;
     struct list_head list;
+    struct hlist_node by_name;
+    struct rb_node by_age;
+};
+
+struct people {
+    struct list_head head;
+    struct htable names;
+    struct rb_root ages;
 };
 
-// Add a node to the list
-void list_add(struct list_head *new, struct list_head *head) {
-    head->next->prev = new;
-    new->next = head->next;
-    new->prev = head;
-    head->next = new;
+static uint32_t person_name_hash(const struct hlist_node *node) {
+    return hash_string(hlist_entry(node, struct person, by_name)->name);
 }
 
-// Delete a node from the list
-void list_del(struct list_head *entry) {
-    entry->prev->next = entry->next;
-    entry->next->prev = entry->prev;
+// Link a person into the list and both indexes
+void add_person(struct people *all, struct person *p) {
+    list_add(&p->list, &all->head);
+    htable_add(&all->names, &p->by_name, hash_string(p->name));
+
+    // Equal ages go right, so persons of one age stay in insertion order
+    struct rb_node **link = &all->ages.rb_node, *parent = NULL;
+    while (*link) {
+        parent = *link;
+        if (p->age < rb_entry(parent, struct person, by_age)->age) link = &parent->rb_left;
+        else link = &parent->rb_right;
+    }
+    rb_link_node(&p->by_age, parent, link);
+    rb_insert_color(&p->by_age, &all->ages);
 }
 
-// Iterate over the list
-#define list_for_each(pos, head) \
-    for (pos = (head)->next; pos != (head); pos = pos->next)
+void remove_person(struct people *all, struct person *p) {
+    list_del(&p->list);
+    htable_del(&all->names, &p->by_name);
+    rb_erase(&p->by_age, &all->ages);
+}
+
+// O(1) lookup instead of a list scan
+struct person *find_by_name(struct people *all, const char *name) {
+    uint32_t hash = hash_string(name);
+    struct person *p;
+    htable_for_each_possible(&all->names, p, struct person, by_name, hash)
+        if (strcmp(p->name, name) == 0) return p;
+    return NULL;
+}
 
-// Get the struct from list_head
-#define list_entry(ptr, type, member) \
-    ((type *)((char *)(ptr) - (unsigned long)(&((type *)0)->member)))
+// First person of at least 'age' (NULL if none): the start of an ordered range scan
+struct person *first_aged_at_least(struct people *all, int age) {
+    struct rb_node *n = all->ages.rb_node, *found = NULL;
+    while (n) {
+        if (rb_entry(n, struct person, by_age)->age >= age) {
+            found = n;
+            n = n->rb_left;
+        } else {
+            n = n->rb_right;
+        }
+    }
+    return rb_entry_safe(found, struct person, by_age);
+}
 
 // Display the list contents
 void display_list(struct list_head *head) {
@@ -61,44 +94,68 @@ void display_list(struct list_head *head) {
     }
 }
 
+// Display by increasing age
+void display_by_age(struct rb_root *ages) {
+    for (struct rb_node *n = rb_first(ages); n; n = rb_next(n)) {
+        struct person *p = rb_entry(n, struct person, by_age);
+        printf("Name: %s, Age: %d\n", p->name, p->age);
+    }
+}
+
 int main() {
-    // Initialize the head
-    struct list_head head;
-    INIT_LIST_HEAD(&head);
+    struct kmem_cache *person_cache = kmem_cache_create("person", sizeof(struct person), 0);
+    if (!person_cache) return 1;
+
+    // Initialize the head and the indexes
+    struct people all;
+    INIT_LIST_HEAD(&all.head);
+    all.ages = RB_ROOT;
+    if (htable_init(&all.names, 4, person_name_hash)) return 1;
 
     // Create some persons
-    struct person *p1 = (struct person *)malloc(sizeof(struct person));
+    struct person *p1 = kmem_cache_alloc(person_cache);
     strcpy(p1->name, "Alice");
     p1->age = 30;
-    list_add(&p1->list, &head);
+    add_person(&all, p1);
 
-    struct person *p2 = (struct person *)malloc(sizeof(struct person));
+    struct person *p2 = kmem_cache_alloc(person_cache);
     strcpy(p2->name, "Bob");
     p2->age = 25;
-    list_add(&p2->list, &head);
+    add_person(&all, p2);
 
-    struct person *p3 = (struct person *)malloc(sizeof(struct person));
+    struct person *p3 = kmem_cache_alloc(person_cache);
     strcpy(p3->name, "Charlie");
     p3->age = 35;
-    list_add(&p3->list, &head);
+    add_person(&all, p3);
 
     printf("Initial List:\n");
-    display_list(&head);
+    display_list(&all.head);
+
+    printf("\nBy age:\n");
+    display_by_age(&all.ages);
+
+    struct person *found = find_by_name(&all, "Charlie");
+    printf("\nLookup Charlie: %s\n", found ? "found" : "not found");
+    found = first_aged_at_least(&all, 28);
+    printf("First aged 28 or more: %s\n", found ? found->name : "none");
 
     // Delete one node
     printf("\nDeleting Bob from the list...\n");
-    list_del(&p2->list);
-    free(p2);
+    remove_person(&all, p2);
+    kmem_cache_free(person_cache, p2);
 
     printf("Updated List:\n");
-    display_list(&head);
+    display_list(&all.head);
+    printf("Lookup Bob: %s\n", find_by_name(&all, "Bob") ? "found" : "not found");
 
     // Free remaining memory
-    list_del(&p1->list);
-    free(p1);
+    remove_person(&all, p1);
+    kmem_cache_free(person_cache, p1);
 
-    list_del(&p3->list);
-    free(p3);
+    remove_person(&all, p3);
+    kmem_cache_free(person_cache, p3);
 
+    htable_destroy(&all.names);
+    kmem_cache_destroy(person_cache);
     return 0;
 }
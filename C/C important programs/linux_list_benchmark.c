@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kernel_list.h"
+#include "slab.h"
+#include "../bench_harness.h"
+
+/* The struct person list of linux_linkedilist.c with N nodes, allocated with malloc or from a
+   kmem_cache (slab.h). The program makes other allocations of mixed sizes in between, as a real
+   one does, so malloc'd nodes are spread over the heap while slab nodes stay packed.
+   - walk: list_for_each over all nodes, reading each person,
+   - walk_prefetch: list_for_each_prefetch, the next node is requested while this one is read,
+   - churn: delete a random node and add a new one at the tail (free + alloc + list ops),
+   - walk_after_churn: walk again once every node has been replaced about once, so list order
+     no longer follows allocation order.
+   Usage: ./linux_list_benchmark [nodes] [bench_harness options]   (default 1,000,000) */
+
+struct person {
+    char name[50];
+    int age;
+    struct list_head list;
+};
+
+struct scenario {
+    const char *name;
+    struct kmem_cache *cache; // NULL: malloc
+    struct list_head head;
+    struct person **nodes;    // Every node, for picking random ones to delete
+    size_t count;
+    uint64_t rng;
+    long checksum;
+};
+
+static struct person *new_person(struct scenario *sc, int age) {
+    struct person *p = sc->cache ? kmem_cache_alloc(sc->cache) : malloc(sizeof(struct person));
+    if (!p) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    snprintf(p->name, sizeof(p->name), "person%d", age);
+    p->age = age;
+    return p;
+}
+
+static void delete_person(struct scenario *sc, struct person *p) {
+    if (sc->cache) kmem_cache_free(sc->cache, p);
+    else free(p);
+}
+
+/* ---------------- bodies ---------------- */
+static long walk_list(struct list_head *head) {
+    long sum = 0;
+    struct list_head *pos;
+    list_for_each(pos, head) {
+        struct person *p = list_entry(pos, struct person, list);
+        sum += p->age * 31 + p->name[6];
+    }
+    return sum;
+}
+
+static long walk_list_prefetch(struct list_head *head) {
+    long sum = 0;
+    struct list_head *pos;
+    list_for_each_prefetch(pos, head) {
+        struct person *p = list_entry(pos, struct person, list);
+        sum += p->age * 31 + p->name[6];
+    }
+    return sum;
+}
+
+static void bench_walk(void *ctx, uint64_t iters) {
+    struct scenario *sc = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        long sum = walk_list(&sc->head);
+        BENCH_DO_NOT_OPTIMIZE(sum);
+        sc->checksum = sum;
+    }
+}
+
+static void bench_walk_prefetch(void *ctx, uint64_t iters) {
+    struct scenario *sc = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        long sum = walk_list_prefetch(&sc->head);
+        BENCH_DO_NOT_OPTIMIZE(sum);
+        sc->checksum = sum;
+    }
+}
+
+static void bench_churn(void *ctx, uint64_t iters) {
+    struct scenario *sc = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        size_t k = (size_t)(bench_next_random(&sc->rng) % sc->count);
+        struct person *old = sc->nodes[k];
+        int age = old->age;
+        list_del(&old->list);
+        delete_person(sc, old);
+        struct person *p = new_person(sc, age);
+        list_add_tail(&p->list, &sc->head);
+        sc->nodes[k] = p;
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : 1000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    struct scenario scenarios[2] = {{.name = "malloc"}, {.name = "slab"}};
+    scenarios[1].cache = kmem_cache_create("person", sizeof(struct person), 0);
+    void **other = malloc(count * sizeof(void *)); // The rest of the program's allocations
+    int failures = 0;
+    if (!scenarios[1].cache || !other) return 1;
+
+    for (int s = 0; s < 2; ++s) {
+        struct scenario *sc = &scenarios[s];
+        sc->count = count;
+        sc->rng = 88172645463325252ull;
+        sc->nodes = malloc(count * sizeof(struct person *));
+        if (!sc->nodes) return 1;
+        INIT_LIST_HEAD(&sc->head);
+        uint64_t sizes = 12345;
+        for (size_t i = 0; i < count; ++i) {
+            other[i] = malloc(16 + bench_next_random(&sizes) % 240);
+            sc->nodes[i] = new_person(sc, (int)(i % 100));
+            list_add_tail(&sc->nodes[i]->list, &sc->head);
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "%s/walk", sc->name);
+        bench_set_items(bench_run(&session, name, bench_walk, sc), (double)count);
+        snprintf(name, sizeof(name), "%s/walk_prefetch", sc->name);
+        bench_set_items(bench_run(&session, name, bench_walk_prefetch, sc), (double)count);
+        snprintf(name, sizeof(name), "%s/churn", sc->name);
+        bench_set_items(bench_run(&session, name, bench_churn, sc), 1.0);
+        // Replace every node about once more, so both lists are equally aged
+        bench_churn(sc, count);
+        snprintf(name, sizeof(name), "%s/walk_after_churn", sc->name);
+        bench_set_items(bench_run(&session, name, bench_walk, sc), (double)count);
+        snprintf(name, sizeof(name), "%s/walk_prefetch_after_churn", sc->name);
+        bench_set_items(bench_run(&session, name, bench_walk_prefetch, sc), (double)count);
+
+        for (size_t i = 0; i < count; ++i) free(other[i]);
+        // Churn keeps every age, so the sum does not depend on how many iterations ran
+        sc->checksum = walk_list(&sc->head);
+        if (walk_list_prefetch(&sc->head) != sc->checksum) failures++;
+    }
+
+    if (scenarios[0].checksum != scenarios[1].checksum) failures++;
+    printf("\nchecksums: malloc %ld, slab %ld %s\n", scenarios[0].checksum, scenarios[1].checksum,
+           failures ? "MISMATCH" : "ok");
+    printf("slabinfo:    name       active    total   size  /slab  slabs\n  ");
+    kmem_cache_info(scenarios[1].cache, stdout);
+
+    for (int s = 0; s < 2; ++s) {
+        struct list_head *pos, *n;
+        list_for_each_safe(pos, n, &scenarios[s].head) {
+            list_del(pos);
+            delete_person(&scenarios[s], list_entry(pos, struct person, list));
+        }
+        free(scenarios[s].nodes);
+    }
+    kmem_cache_destroy(scenarios[1].cache);
+    free(other);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
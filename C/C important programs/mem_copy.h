@@ -0,0 +1,273 @@
+#ifndef MEM_COPY_H
+#define MEM_COPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MEM_COPY_X86 1
+#else
+#define MEM_COPY_X86 0
+#endif
+
+/* memmove / memcpy for memmove.c, from the byte loop up to AVX-512.
+       mem_move(dst, src, n)   regions may overlap (memmove)
+       mem_copy(dst, src, n)   regions must not overlap (memcpy); same code, since telling the
+                               direction apart costs one compare
+   Both go through a function pointer chosen once at startup from cpuid:
+   AVX-512 > AVX2 > SSE2 > 64-bit words. mem_copy_isa() names the choice. Each variant can also
+   be called directly (mem_move_bytes, mem_move_words, mem_move_sse2, ...).
+
+   How the vector versions work, with VEC = 16/32/64 bytes:
+   - n <= 8*VEC: load the first and the last 1, 2 or 4 vectors (they overlap in the middle when
+     n is not a multiple), then store them all. All loads come before any store, so this is
+     correct for overlapping regions too, with no branch on the direction.
+   - larger: the first vector and the last four are loaded up front. The loop copies 4 vectors
+     per iteration with stores aligned to VEC (unaligned loads are cheap, stores that split
+     cache lines are not), then the saved head and tail are stored. Forward when dst is below
+     src (or the regions are disjoint), backward otherwise: either way the loop never reads
+     bytes it has already overwritten.
+   - copies larger than 3/4 of the last-level cache use non-temporal (streaming) stores when
+     the regions are disjoint: the destination would not fit in the cache anyway, so writing
+     around it saves the read-for-ownership of every line and keeps the cache for other data.
+   mem_move_impl and mem_copy_nt_threshold are static variables, so each file that includes
+   this header has its own pair, set by its own mem_copy_select().
+*/
+
+// Unaligned, alias-safe word access
+typedef uint64_t __attribute__((may_alias, aligned(1))) mem_u64;
+typedef uint32_t __attribute__((may_alias, aligned(1))) mem_u32;
+typedef uint16_t __attribute__((may_alias, aligned(1))) mem_u16;
+
+static size_t mem_copy_nt_threshold = (size_t)8 << 20;
+
+// Original algorithm of memmove.c: one byte at a time, backwards when dst is above src
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline void *mem_move_bytes(void *dst, const void *src, size_t n) {
+    char *d = (char *)dst;
+    const char *s = (const char *)src;
+    if (d > s) {
+        while (n--) d[n] = s[n];
+    } else {
+        for (size_t i = 0; i != n; ++i) d[i] = s[i];
+    }
+    return dst;
+}
+
+// n < 64. Loads everything before storing, so overlapping regions are fine.
+static inline void mem_move_small(char *d, const char *s, size_t n) {
+    if (n >= 32) {
+        uint64_t a = *(const mem_u64 *)s, b = *(const mem_u64 *)(s + 8);
+        uint64_t c = *(const mem_u64 *)(s + 16), e = *(const mem_u64 *)(s + 24);
+        uint64_t w = *(const mem_u64 *)(s + n - 32), x = *(const mem_u64 *)(s + n - 24);
+        uint64_t y = *(const mem_u64 *)(s + n - 16), z = *(const mem_u64 *)(s + n - 8);
+        *(mem_u64 *)d = a;
+        *(mem_u64 *)(d + 8) = b;
+        *(mem_u64 *)(d + 16) = c;
+        *(mem_u64 *)(d + 24) = e;
+        *(mem_u64 *)(d + n - 32) = w;
+        *(mem_u64 *)(d + n - 24) = x;
+        *(mem_u64 *)(d + n - 16) = y;
+        *(mem_u64 *)(d + n - 8) = z;
+    } else if (n >= 16) {
+        uint64_t a = *(const mem_u64 *)s, b = *(const mem_u64 *)(s + 8);
+        uint64_t y = *(const mem_u64 *)(s + n - 16), z = *(const mem_u64 *)(s + n - 8);
+        *(mem_u64 *)d = a;
+        *(mem_u64 *)(d + 8) = b;
+        *(mem_u64 *)(d + n - 16) = y;
+        *(mem_u64 *)(d + n - 8) = z;
+    } else if (n >= 8) {
+        uint64_t a = *(const mem_u64 *)s, z = *(const mem_u64 *)(s + n - 8);
+        *(mem_u64 *)d = a;
+        *(mem_u64 *)(d + n - 8) = z;
+    } else if (n >= 4) {
+        uint32_t a = *(const mem_u32 *)s, z = *(const mem_u32 *)(s + n - 4);
+        *(mem_u32 *)d = a;
+        *(mem_u32 *)(d + n - 4) = z;
+    } else if (n >= 2) {
+        uint16_t a = *(const mem_u16 *)s, z = *(const mem_u16 *)(s + n - 2);
+        *(mem_u16 *)d = a;
+        *(mem_u16 *)(d + n - 2) = z;
+    } else if (n == 1) {
+        *d = *s;
+    }
+}
+
+// Portable fallback: 8 bytes at a time
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline void *mem_move_words(void *dst, const void *src, size_t n) {
+    char *d = (char *)dst;
+    const char *s = (const char *)src;
+    if (n < 64) {
+        mem_move_small(d, s, n);
+    } else if ((uintptr_t)d - (uintptr_t)s >= n) {
+        // Each word is loaded before it is stored, and stores stay behind the loads
+        size_t i = 0;
+        for (; n - i >= 8; i += 8) *(mem_u64 *)(d + i) = *(const mem_u64 *)(s + i);
+        for (; i < n; ++i) d[i] = s[i];
+    } else {
+        size_t i = n;
+        for (; i >= 8; i -= 8) *(mem_u64 *)(d + i - 8) = *(const mem_u64 *)(s + i - 8);
+        while (i--) d[i] = s[i];
+    }
+    return dst;
+}
+
+/* Body shared by the SIMD versions. V: vector type, VEC: its size, LOAD/STORE unaligned,
+   STORE_A aligned, STREAM non-temporal aligned store. */
+#define MEM_MOVE_VECTOR_BODY(V, VEC, LOAD, STORE, STORE_A, STREAM)                                          \
+    char *d = (char *)dst;                                                                                 \
+    const char *s = (const char *)src;                                                                     \
+    if (n < VEC) {                                                                                         \
+        mem_move_small(d, s, n);                                                                           \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    if (n <= 2 * VEC) {                                                                                    \
+        V a = LOAD(s), z = LOAD(s + n - VEC);                                                              \
+        STORE(d, a);                                                                                       \
+        STORE(d + n - VEC, z);                                                                             \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    if (n <= 4 * VEC) {                                                                                    \
+        V a = LOAD(s), b = LOAD(s + VEC), y = LOAD(s + n - 2 * VEC), z = LOAD(s + n - VEC);                \
+        STORE(d, a);                                                                                       \
+        STORE(d + VEC, b);                                                                                 \
+        STORE(d + n - 2 * VEC, y);                                                                         \
+        STORE(d + n - VEC, z);                                                                             \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    if (n <= 8 * VEC) {                                                                                    \
+        V a = LOAD(s), b = LOAD(s + VEC), c = LOAD(s + 2 * VEC), e = LOAD(s + 3 * VEC);                    \
+        V w = LOAD(s + n - 4 * VEC), x = LOAD(s + n - 3 * VEC);                                            \
+        V y = LOAD(s + n - 2 * VEC), z = LOAD(s + n - VEC);                                                \
+        STORE(d, a);                                                                                       \
+        STORE(d + VEC, b);                                                                                 \
+        STORE(d + 2 * VEC, c);                                                                             \
+        STORE(d + 3 * VEC, e);                                                                             \
+        STORE(d + n - 4 * VEC, w);                                                                         \
+        STORE(d + n - 3 * VEC, x);                                                                         \
+        STORE(d + n - 2 * VEC, y);                                                                         \
+        STORE(d + n - VEC, z);                                                                             \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    if ((uintptr_t)d - (uintptr_t)s >= n) {                                                                \
+        /* Forward: head and tail are saved before the loop can overwrite them */                          \
+        V head = LOAD(s);                                                                                  \
+        V w = LOAD(s + n - 4 * VEC), x = LOAD(s + n - 3 * VEC);                                            \
+        V y = LOAD(s + n - 2 * VEC), z = LOAD(s + n - VEC);                                                \
+        size_t skip = VEC - ((uintptr_t)d & (VEC - 1));                                                    \
+        char *dp = d + skip, *end = d + n - 4 * VEC;                                                       \
+        const char *sp = s + skip;                                                                         \
+        if (n >= mem_copy_nt_threshold && (uintptr_t)s - (uintptr_t)d >= n) {                              \
+            for (; dp < end; dp += 4 * VEC, sp += 4 * VEC) {                                               \
+                V a = LOAD(sp), b = LOAD(sp + VEC), c = LOAD(sp + 2 * VEC), e = LOAD(sp + 3 * VEC);        \
+                STREAM(dp, a);                                                                             \
+                STREAM(dp + VEC, b);                                                                       \
+                STREAM(dp + 2 * VEC, c);                                                                   \
+                STREAM(dp + 3 * VEC, e);                                                                   \
+            }                                                                                              \
+            _mm_sfence(); /* Streaming stores are weakly ordered */                                        \
+        } else {                                                                                           \
+            for (; dp < end; dp += 4 * VEC, sp += 4 * VEC) {                                               \
+                V a = LOAD(sp), b = LOAD(sp + VEC), c = LOAD(sp + 2 * VEC), e = LOAD(sp + 3 * VEC);        \
+                STORE_A(dp, a);                                                                            \
+                STORE_A(dp + VEC, b);                                                                      \
+                STORE_A(dp + 2 * VEC, c);                                                                  \
+                STORE_A(dp + 3 * VEC, e);                                                                  \
+            }                                                                                              \
+        }                                                                                                  \
+        STORE(d, head);                                                                                    \
+        STORE(d + n - 4 * VEC, w);                                                                         \
+        STORE(d + n - 3 * VEC, x);                                                                         \
+        STORE(d + n - 2 * VEC, y);                                                                         \
+        STORE(d + n - VEC, z);                                                                             \
+    } else {                                                                                               \
+        /* Backward (dst above an overlapping src): mirror image */                                        \
+        V tail = LOAD(s + n - VEC);                                                                        \
+        V a = LOAD(s), b = LOAD(s + VEC), c = LOAD(s + 2 * VEC), e = LOAD(s + 3 * VEC);                    \
+        char *dp = (char *)((uintptr_t)(d + n) & ~(uintptr_t)(VEC - 1));                                   \
+        while (dp > d + 4 * VEC) {                                                                         \
+            dp -= 4 * VEC;                                                                                 \
+            const char *sp = s + (dp - d);                                                                 \
+            V p = LOAD(sp), q = LOAD(sp + VEC), r = LOAD(sp + 2 * VEC), t = LOAD(sp + 3 * VEC);            \
+            STORE_A(dp, p);                                                                                \
+            STORE_A(dp + VEC, q);                                                                          \
+            STORE_A(dp + 2 * VEC, r);                                                                      \
+            STORE_A(dp + 3 * VEC, t);                                                                      \
+        }                                                                                                  \
+        STORE(d + n - VEC, tail);                                                                          \
+        STORE(d, a);                                                                                       \
+        STORE(d + VEC, b);                                                                                 \
+        STORE(d + 2 * VEC, c);                                                                             \
+        STORE(d + 3 * VEC, e);                                                                             \
+    }                                                                                                      \
+    return dst;
+
+#if MEM_COPY_X86
+#define MEM_SSE2_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#define MEM_SSE2_STORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define MEM_SSE2_STORE_A(p, v) _mm_store_si128((__m128i *)(p), v)
+#define MEM_SSE2_STREAM(p, v) _mm_stream_si128((__m128i *)(p), v)
+#define MEM_AVX2_LOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+#define MEM_AVX2_STORE(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define MEM_AVX2_STORE_A(p, v) _mm256_store_si256((__m256i *)(p), v)
+#define MEM_AVX2_STREAM(p, v) _mm256_stream_si256((__m256i *)(p), v)
+#define MEM_AVX512_LOAD(p) _mm512_loadu_si512((const void *)(p))
+#define MEM_AVX512_STORE(p, v) _mm512_storeu_si512((void *)(p), v)
+#define MEM_AVX512_STORE_A(p, v) _mm512_store_si512((void *)(p), v)
+#define MEM_AVX512_STREAM(p, v) _mm512_stream_si512((__m512i *)(p), v)
+
+__attribute__((target("sse2")))
+static inline void *mem_move_sse2(void *dst, const void *src, size_t n) {
+    MEM_MOVE_VECTOR_BODY(__m128i, 16, MEM_SSE2_LOAD, MEM_SSE2_STORE, MEM_SSE2_STORE_A, MEM_SSE2_STREAM)
+}
+
+__attribute__((target("avx2")))
+static inline void *mem_move_avx2(void *dst, const void *src, size_t n) {
+    MEM_MOVE_VECTOR_BODY(__m256i, 32, MEM_AVX2_LOAD, MEM_AVX2_STORE, MEM_AVX2_STORE_A, MEM_AVX2_STREAM)
+}
+
+__attribute__((target("avx512f")))
+static inline void *mem_move_avx512(void *dst, const void *src, size_t n) {
+    MEM_MOVE_VECTOR_BODY(__m512i, 64, MEM_AVX512_LOAD, MEM_AVX512_STORE, MEM_AVX512_STORE_A, MEM_AVX512_STREAM)
+}
+#endif
+
+static void *(*mem_move_impl)(void *, const void *, size_t) = mem_move_words;
+static const char *mem_move_impl_name = "words";
+
+// Constructor: the widest vector unit cpuid reports, and streaming above 3/4 of the L3 size
+__attribute__((constructor)) static void mem_copy_select(void) {
+#if MEM_COPY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        mem_move_impl = mem_move_avx512;
+        mem_move_impl_name = "avx512";
+    } else if (__builtin_cpu_supports("avx2")) {
+        mem_move_impl = mem_move_avx2;
+        mem_move_impl_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        mem_move_impl = mem_move_sse2;
+        mem_move_impl_name = "sse2";
+    }
+#endif
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc > 0) mem_copy_nt_threshold = (size_t)llc / 4 * 3;
+#endif
+}
+
+static inline void *mem_move(void *dst, const void *src, size_t n) {
+    return mem_move_impl(dst, src, n);
+}
+
+static inline void *mem_copy(void *dst, const void *src, size_t n) {
+    return mem_move_impl(dst, src, n);
+}
+
+static inline const char *mem_copy_isa(void) {
+    return mem_move_impl_name;
+}
+
+#endif // MEM_COPY_H
@@ -7,36 +7,29 @@ Welcome to GDB Online.
 
 *******************************************************************************/
 #include <stdio.h>
-
-void mem_move(char *dst, char *src, size_t size)
-{
-    if(dst>src)
-    {
-        while(size--)
-        {
-            *(dst+size)=*(src+size);
-        }
-    }
-    else
-    {
-        size_t iter = 0;
-        while(iter!=size)
-        {
-            *(dst+iter)=*(src+iter);
-            iter++;
-        }
-    }
-}
+#include <string.h>
+// mem_move / mem_copy: word-at-a-time and SSE2/AVX2/AVX-512 versions, picked at startup
+#include "mem_copy.h"
 
 int main()
 {
     char source[] = "HelloHello";
 
+    // dst above src, overlapping: copies backwards
     mem_move((source+2), source, 2);
     printf("%s\r\n",source);
 
-    mem_move((source-3), source, 4);
+    // dst below src, overlapping: copies forwards. (Moving to source-3 would write before the
+    // array, which is undefined behavior: both ranges must lie inside the same object.)
+    mem_move(source, (source+3), 4);
     printf("%s\r\n",source);
 
+    // Overlapping move larger than the vector loops' threshold, checked against libc memmove
+    char a[1000], b[1000];
+    for (int i = 0; i < 1000; i++) a[i] = b[i] = (char)('a' + i % 26);
+    mem_move(a + 7, a, 900);
+    memmove(b + 7, b, 900);
+    printf("900-byte overlapping move (%s): %s\r\n", mem_copy_isa(), memcmp(a, b, sizeof(a)) == 0 ? "ok" : "MISMATCH");
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mem_copy.h"
+#include "../bench_harness.h"
+
+/* mem_copy.h against glibc, from 1 byte to 1 GiB (disjoint buffers; dst starts 2 KiB into a page
+   so that loads and stores do not alias modulo 4 KiB, which stalls every copy loop alike):
+   - glibc_memcpy / glibc_memmove,
+   - bytes (the original memmove.c loop, up to 16 MiB), words, sse2, avx2, avx512,
+   - mem_move: the version picked at startup,
+   - overlap/...: dst = src + 1 inside one buffer, glibc memmove vs mem_move (backward copy).
+   Every version is first checked against memmove on random sizes, offsets and overlaps,
+   including the streaming-store path.
+   Usage: ./memmove_benchmark [max_bytes] [bench_harness options]   (default 1 GiB) */
+
+typedef void *(*move_fn)(void *, const void *, size_t);
+
+struct variant {
+    const char *name;
+    move_fn fn;
+    size_t max_bytes;
+};
+
+struct copy_job {
+    move_fn fn;
+    char *dst;
+    const char *src;
+    size_t n;
+};
+
+static void *glibc_memcpy(void *d, const void *s, size_t n) { return memcpy(d, s, n); }
+static void *glibc_memmove(void *d, const void *s, size_t n) { return memmove(d, s, n); }
+
+static void bench_copy(void *ctx, uint64_t iters) {
+    struct copy_job *job = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        job->fn(job->dst, job->src, job->n);
+        BENCH_CLOBBER_MEMORY();
+    }
+}
+
+// Differential check against libc memmove; returns the number of mismatches
+static int verify(const struct variant *v) {
+    enum { SIZE = 1 << 18 };
+    static char a[SIZE], b[SIZE];
+    uint64_t rng = 7;
+    int bad = 0;
+    size_t saved_threshold = mem_copy_nt_threshold;
+    for (int round = 0; round < 3000; ++round) {
+        for (size_t i = 0; i < SIZE; ++i) a[i] = b[i] = (char)(i * 131 + (size_t)round);
+        uint64_t r = bench_next_random(&rng);
+        size_t n = round < 1500 ? r % 700 : r % (SIZE / 2);
+        size_t from = (size_t)(bench_next_random(&rng) % (SIZE - n + 1));
+        size_t to = (size_t)(bench_next_random(&rng) % (SIZE - n + 1));
+        size_t delta = (size_t)(r >> 32) % 80; // Close overlaps, both directions
+        if (round % 3 == 0 && from + delta + n <= SIZE) to = from + delta;
+        if (round % 3 == 1 && from >= delta) to = from - delta;
+        mem_copy_nt_threshold = round % 2 ? 4096 : saved_threshold; // Also exercise streaming stores
+        v->fn(a + to, a + from, n);
+        memmove(b + to, b + from, n);
+        if (memcmp(a, b, SIZE) != 0) ++bad;
+    }
+    mem_copy_nt_threshold = saved_threshold;
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    size_t max_bytes = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : ((size_t)1 << 30);
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    struct variant variants[8];
+    int count = 0;
+    variants[count++] = (struct variant){"glibc_memcpy", glibc_memcpy, SIZE_MAX};
+    variants[count++] = (struct variant){"glibc_memmove", glibc_memmove, SIZE_MAX};
+    variants[count++] = (struct variant){"bytes", mem_move_bytes, (size_t)16 << 20};
+    variants[count++] = (struct variant){"words", mem_move_words, SIZE_MAX};
+#if MEM_COPY_X86
+    variants[count++] = (struct variant){"sse2", mem_move_sse2, SIZE_MAX};
+    if (__builtin_cpu_supports("avx2")) variants[count++] = (struct variant){"avx2", mem_move_avx2, SIZE_MAX};
+    if (__builtin_cpu_supports("avx512f")) variants[count++] = (struct variant){"avx512", mem_move_avx512, SIZE_MAX};
+#endif
+    variants[count++] = (struct variant){"mem_move", mem_move, SIZE_MAX};
+
+    int failures = 0;
+    for (int v = 2; v < count; ++v) {
+        int bad = verify(&variants[v]);
+        failures += bad;
+        printf("check %-8s %s\n", variants[v].name, bad ? "MISMATCH" : "ok");
+    }
+    printf("dispatch: %s, streaming stores from %zu bytes\n\n", mem_copy_isa(), mem_copy_nt_threshold);
+
+    size_t buffer_bytes = (max_bytes + 2 * 4096 - 1) & ~(size_t)4095; // Room for +1 and +2048
+    char *src = aligned_alloc(4096, buffer_bytes);
+    char *dst_buffer = aligned_alloc(4096, buffer_bytes);
+    if (!src || !dst_buffer) return 1;
+    memset(src, 'x', buffer_bytes);
+    memset(dst_buffer, 'y', buffer_bytes);
+    char *dst = dst_buffer + 2048;
+
+    char name[64];
+    for (size_t n = 1; n <= max_bytes; n *= 8) {
+        for (int v = 0; v < count; ++v) {
+            if (n > variants[v].max_bytes) continue;
+            struct copy_job job = {variants[v].fn, dst, src, n};
+            snprintf(name, sizeof(name), "%s/%zu", variants[v].name, n);
+            bench_set_bytes(bench_run(&session, name, bench_copy, &job), (double)n);
+        }
+        struct copy_job overlap = {glibc_memmove, src + 1, src, n};
+        snprintf(name, sizeof(name), "overlap/glibc_memmove/%zu", n);
+        bench_set_bytes(bench_run(&session, name, bench_copy, &overlap), (double)n);
+        overlap.fn = mem_move;
+        snprintf(name, sizeof(name), "overlap/mem_move/%zu", n);
+        bench_set_bytes(bench_run(&session, name, bench_copy, &overlap), (double)n);
+    }
+
+    free(src);
+    free(dst_buffer);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
@@ -0,0 +1,279 @@
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include <stddef.h>
+#include "kernel_list.h"
+
+/* Intrusive red-black tree in the style of the kernel's include/linux/rbtree.h. The node is
+   embedded in the object (struct person { ...; struct rb_node by_age; }) like list_head, and
+   the tree does not know the key: the caller walks down to the insertion point and links the
+   node, then rb_insert_color() rebalances. Lookups are written the same way, which lets them
+   compare keys inline instead of through a callback.
+
+       struct rb_node **link = &root->rb_node, *parent = NULL;
+       while (*link) {
+           parent = *link;
+           link = key < rb_entry(parent, struct person, by_age)->age ? &parent->rb_left : &parent->rb_right;
+       }
+       rb_link_node(&p->by_age, parent, link);
+       rb_insert_color(&p->by_age, root);
+
+   Ordered walk: for (n = rb_first(root); n; n = rb_next(n)). Height stays below 2*log2(n+1),
+   so insert, erase and lookup are O(log n). The parent pointer and the color share one word
+   (nodes are pointer aligned, so bit 0 is free): 24 bytes per node.
+*/
+
+#define RB_RED 0
+#define RB_BLACK 1
+
+struct rb_node {
+    unsigned long __rb_parent_color;
+    struct rb_node *rb_right;
+    struct rb_node *rb_left;
+};
+
+struct rb_root {
+    struct rb_node *rb_node;
+};
+
+#define RB_ROOT (struct rb_root) { NULL }
+#define rb_entry(ptr, type, member) container_of(ptr, type, member)
+#define rb_entry_safe(ptr, type, member) ((ptr) ? rb_entry(ptr, type, member) : NULL)
+
+#define rb_parent(r) ((struct rb_node *)((r)->__rb_parent_color & ~3UL))
+#define rb_color(r) ((int)((r)->__rb_parent_color & 1))
+#define rb_is_red(r) (!rb_color(r))
+#define rb_is_black(r) rb_color(r)
+
+static inline void rb_set_parent(struct rb_node *rb, struct rb_node *p) {
+    rb->__rb_parent_color = (rb->__rb_parent_color & 3) | (unsigned long)p;
+}
+
+static inline void rb_set_color(struct rb_node *rb, int color) {
+    rb->__rb_parent_color = (rb->__rb_parent_color & ~1UL) | (unsigned long)color;
+}
+
+#define rb_set_red(r) rb_set_color(r, RB_RED)
+#define rb_set_black(r) rb_set_color(r, RB_BLACK)
+
+// New nodes are red leaves; *rb_link is the parent's left or right child field (or root)
+static inline void rb_link_node(struct rb_node *node, struct rb_node *parent, struct rb_node **rb_link) {
+    node->__rb_parent_color = (unsigned long)parent;
+    node->rb_left = node->rb_right = NULL;
+    *rb_link = node;
+}
+
+static inline void __rb_change_child(struct rb_node *old, struct rb_node *new, struct rb_node *parent,
+                                     struct rb_root *root) {
+    if (!parent) root->rb_node = new;
+    else if (parent->rb_left == old) parent->rb_left = new;
+    else parent->rb_right = new;
+}
+
+static inline void __rb_rotate_left(struct rb_node *node, struct rb_root *root) {
+    struct rb_node *right = node->rb_right;
+    struct rb_node *parent = rb_parent(node);
+    if ((node->rb_right = right->rb_left)) rb_set_parent(right->rb_left, node);
+    right->rb_left = node;
+    rb_set_parent(right, parent);
+    __rb_change_child(node, right, parent, root);
+    rb_set_parent(node, right);
+}
+
+static inline void __rb_rotate_right(struct rb_node *node, struct rb_root *root) {
+    struct rb_node *left = node->rb_left;
+    struct rb_node *parent = rb_parent(node);
+    if ((node->rb_left = left->rb_right)) rb_set_parent(left->rb_right, node);
+    left->rb_right = node;
+    rb_set_parent(left, parent);
+    __rb_change_child(node, left, parent, root);
+    rb_set_parent(node, left);
+}
+
+// Rebalance after rb_link_node()
+static inline void rb_insert_color(struct rb_node *node, struct rb_root *root) {
+    struct rb_node *parent, *gparent;
+    while ((parent = rb_parent(node)) && rb_is_red(parent)) {
+        gparent = rb_parent(parent);
+        if (parent == gparent->rb_left) {
+            struct rb_node *uncle = gparent->rb_right;
+            if (uncle && rb_is_red(uncle)) {
+                rb_set_black(uncle);
+                rb_set_black(parent);
+                rb_set_red(gparent);
+                node = gparent;
+                continue;
+            }
+            if (parent->rb_right == node) {
+                __rb_rotate_left(parent, root);
+                struct rb_node *tmp = parent;
+                parent = node;
+                node = tmp;
+            }
+            rb_set_black(parent);
+            rb_set_red(gparent);
+            __rb_rotate_right(gparent, root);
+        } else {
+            struct rb_node *uncle = gparent->rb_left;
+            if (uncle && rb_is_red(uncle)) {
+                rb_set_black(uncle);
+                rb_set_black(parent);
+                rb_set_red(gparent);
+                node = gparent;
+                continue;
+            }
+            if (parent->rb_left == node) {
+                __rb_rotate_right(parent, root);
+                struct rb_node *tmp = parent;
+                parent = node;
+                node = tmp;
+            }
+            rb_set_black(parent);
+            rb_set_red(gparent);
+            __rb_rotate_left(gparent, root);
+        }
+    }
+    rb_set_black(root->rb_node);
+}
+
+// Restore the black height after removing a black node; node (maybe NULL) replaced it under parent
+static inline void __rb_erase_color(struct rb_node *node, struct rb_node *parent, struct rb_root *root) {
+    struct rb_node *other;
+    while ((!node || rb_is_black(node)) && node != root->rb_node) {
+        if (parent->rb_left == node) {
+            other = parent->rb_right;
+            if (rb_is_red(other)) {
+                rb_set_black(other);
+                rb_set_red(parent);
+                __rb_rotate_left(parent, root);
+                other = parent->rb_right;
+            }
+            if ((!other->rb_left || rb_is_black(other->rb_left)) &&
+                (!other->rb_right || rb_is_black(other->rb_right))) {
+                rb_set_red(other);
+                node = parent;
+                parent = rb_parent(node);
+            } else {
+                if (!other->rb_right || rb_is_black(other->rb_right)) {
+                    rb_set_black(other->rb_left);
+                    rb_set_red(other);
+                    __rb_rotate_right(other, root);
+                    other = parent->rb_right;
+                }
+                rb_set_color(other, rb_color(parent));
+                rb_set_black(parent);
+                rb_set_black(other->rb_right);
+                __rb_rotate_left(parent, root);
+                node = root->rb_node;
+                break;
+            }
+        } else {
+            other = parent->rb_left;
+            if (rb_is_red(other)) {
+                rb_set_black(other);
+                rb_set_red(parent);
+                __rb_rotate_right(parent, root);
+                other = parent->rb_left;
+            }
+            if ((!other->rb_left || rb_is_black(other->rb_left)) &&
+                (!other->rb_right || rb_is_black(other->rb_right))) {
+                rb_set_red(other);
+                node = parent;
+                parent = rb_parent(node);
+            } else {
+                if (!other->rb_left || rb_is_black(other->rb_left)) {
+                    rb_set_black(other->rb_right);
+                    rb_set_red(other);
+                    __rb_rotate_left(other, root);
+                    other = parent->rb_left;
+                }
+                rb_set_color(other, rb_color(parent));
+                rb_set_black(parent);
+                rb_set_black(other->rb_left);
+                __rb_rotate_right(parent, root);
+                node = root->rb_node;
+                break;
+            }
+        }
+    }
+    if (node) rb_set_black(node);
+}
+
+static inline void rb_erase(struct rb_node *node, struct rb_root *root) {
+    struct rb_node *child, *parent;
+    int color;
+
+    if (!node->rb_left) {
+        child = node->rb_right;
+    } else if (!node->rb_right) {
+        child = node->rb_left;
+    } else {
+        // Two children: the in-order successor takes node's place (and color)
+        struct rb_node *old = node, *left;
+        node = node->rb_right;
+        while ((left = node->rb_left)) node = left;
+
+        __rb_change_child(old, node, rb_parent(old), root);
+        child = node->rb_right;
+        parent = rb_parent(node);
+        color = rb_color(node);
+        if (parent == old) {
+            parent = node;
+        } else {
+            if (child) rb_set_parent(child, parent);
+            parent->rb_left = child;
+            node->rb_right = old->rb_right;
+            rb_set_parent(old->rb_right, node);
+        }
+        node->__rb_parent_color = old->__rb_parent_color;
+        node->rb_left = old->rb_left;
+        rb_set_parent(old->rb_left, node);
+        if (color == RB_BLACK) __rb_erase_color(child, parent, root);
+        return;
+    }
+
+    parent = rb_parent(node);
+    color = rb_color(node);
+    if (child) rb_set_parent(child, parent);
+    __rb_change_child(node, child, parent, root);
+    if (color == RB_BLACK) __rb_erase_color(child, parent, root);
+}
+
+// In-order traversal
+static inline struct rb_node *rb_first(const struct rb_root *root) {
+    struct rb_node *n = root->rb_node;
+    if (!n) return NULL;
+    while (n->rb_left) n = n->rb_left;
+    return n;
+}
+
+static inline struct rb_node *rb_last(const struct rb_root *root) {
+    struct rb_node *n = root->rb_node;
+    if (!n) return NULL;
+    while (n->rb_right) n = n->rb_right;
+    return n;
+}
+
+static inline struct rb_node *rb_next(const struct rb_node *node) {
+    struct rb_node *parent;
+    if (node->rb_right) {
+        node = node->rb_right;
+        while (node->rb_left) node = node->rb_left;
+        return (struct rb_node *)node;
+    }
+    while ((parent = rb_parent(node)) && node == parent->rb_right) node = parent;
+    return parent;
+}
+
+static inline struct rb_node *rb_prev(const struct rb_node *node) {
+    struct rb_node *parent;
+    if (node->rb_left) {
+        node = node->rb_left;
+        while (node->rb_right) node = node->rb_right;
+        return (struct rb_node *)node;
+    }
+    while ((parent = rb_parent(node)) && node == parent->rb_left) node = parent;
+    return parent;
+}
+
+#endif // RBTREE_H
@@ -0,0 +1,184 @@
+#ifndef RCU_H
+#define RCU_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+#endif
+
+/* Userspace read-copy-update, the mechanism behind rculist.h.
+   Readers never lock and never write shared memory: they bracket their accesses with
+   rcu_read_lock()/rcu_read_unlock(). A writer unlinks an object (list_del_rcu) and hands it to
+   call_rcu(); the object is freed only after a grace period, once every reader that might
+   still see it has left its read-side section.
+
+   Grace periods are epoch based (the liburcu "memb" flavor), not QSBR, so readers need not
+   report quiescent states and may block between sections:
+   - a global counter gp_ctr; rcu_read_lock() copies it into the thread's own cache line,
+     rcu_read_unlock() stores 0,
+   - synchronize_rcu() increments gp_ctr and waits until no registered thread shows a value
+     older than the new one (0 = outside any section).
+   The reader's copy must be visible before it loads list pointers, which normally costs a
+   full fence per rcu_read_lock(). When the kernel supports membarrier(2), rcu_init() registers
+   for it, readers use a compiler barrier only and the (rare) writer pays instead: membarrier
+   forces that fence on every running thread of the process.
+
+   Use:
+       rcu_init();                      once, before any thread reads
+       rcu_register_thread();           in every reader thread (RCU_MAX_THREADS at most)
+       rcu_read_lock(); ... rcu_read_unlock();          sections nest
+       call_rcu(&obj->rcu, free_obj);   from writers, outside any read-side section
+       rcu_barrier();                   runs every pending callback (e.g. before exit)
+       rcu_unregister_thread();
+   Writers still serialize among themselves with their own lock. Callbacks are batched: one
+   grace period is paid per RCU_BATCH call_rcu()s, in the thread that fills the batch.
+   The reader table, the grace-period counter and the callback batch are static variables:
+   synchronize_rcu() in one .c file would not see readers registered in another, so all RCU
+   users must live in a single translation unit.
+*/
+
+#define RCU_MAX_THREADS 128
+#define RCU_BATCH 64
+
+struct rcu_head {
+    struct rcu_head *next;
+    void (*func)(struct rcu_head *head);
+};
+
+struct rcu_reader {
+    unsigned long ctr; // gp_ctr seen at rcu_read_lock(), 0 outside read-side sections
+    unsigned nesting;
+    int used;
+} __attribute__((aligned(64)));
+
+static struct rcu_reader rcu_readers[RCU_MAX_THREADS];
+static _Thread_local struct rcu_reader *rcu_self;
+static unsigned long rcu_gp_ctr = 1;
+static int rcu_readers_high; // Slots ever used, bounds the scan in synchronize_rcu()
+static int rcu_use_membarrier;
+static pthread_mutex_t rcu_gp_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t rcu_cb_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rcu_head *rcu_pending;
+static unsigned rcu_pending_count;
+
+static inline void rcu_init(void) {
+#if defined(__linux__) && defined(__NR_membarrier)
+    int cmds = (int)syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+    if (cmds > 0 && (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) &&
+        syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0)
+        rcu_use_membarrier = 1;
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define rcu_cpu_relax() __builtin_ia32_pause()
+#else
+#define rcu_cpu_relax() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+
+// Full barrier on the reader side: free when the writer uses membarrier
+static inline void rcu_reader_barrier(void) {
+    if (__builtin_expect(rcu_use_membarrier, 1)) __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    else __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// Full barrier on every thread that might be reading (writer side)
+static inline void rcu_writer_barrier(void) {
+#if defined(__linux__) && defined(__NR_membarrier)
+    if (rcu_use_membarrier) {
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+        return;
+    }
+#endif
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// Returns 0, or -1 when all RCU_MAX_THREADS slots are taken
+static inline int rcu_register_thread(void) {
+    for (int i = 0; i < RCU_MAX_THREADS; ++i) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&rcu_readers[i].used, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            rcu_readers[i].nesting = 0;
+            __atomic_store_n(&rcu_readers[i].ctr, 0, __ATOMIC_RELAXED);
+            int high = __atomic_load_n(&rcu_readers_high, __ATOMIC_RELAXED);
+            while (high < i + 1 && !__atomic_compare_exchange_n(&rcu_readers_high, &high, i + 1, 0,
+                                                                 __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {}
+            rcu_self = &rcu_readers[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static inline void rcu_unregister_thread(void) {
+    if (!rcu_self) return;
+    __atomic_store_n(&rcu_self->ctr, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&rcu_self->used, 0, __ATOMIC_RELEASE);
+    rcu_self = NULL;
+}
+
+static inline void rcu_read_lock(void) {
+    struct rcu_reader *r = rcu_self;
+    if (r->nesting++ == 0) {
+        __atomic_store_n(&r->ctr, __atomic_load_n(&rcu_gp_ctr, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+        rcu_reader_barrier(); // The store above is visible before any protected load below
+    }
+}
+
+static inline void rcu_read_unlock(void) {
+    struct rcu_reader *r = rcu_self;
+    if (--r->nesting == 0) __atomic_store_n(&r->ctr, 0, __ATOMIC_RELEASE);
+}
+
+// Waits until every read-side section that was running when it was called has ended
+static inline void synchronize_rcu(void) {
+    pthread_mutex_lock(&rcu_gp_lock);
+    rcu_writer_barrier(); // Unlinks done before the call are visible to new readers
+    unsigned long target = __atomic_add_fetch(&rcu_gp_ctr, 1, __ATOMIC_SEQ_CST);
+    rcu_writer_barrier(); // Readers' ctr stores are visible to the scan below
+    int high = __atomic_load_n(&rcu_readers_high, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < high; ++i) {
+        struct rcu_reader *r = &rcu_readers[i];
+        for (unsigned spins = 0;; ++spins) {
+            unsigned long c = __atomic_load_n(&r->ctr, __ATOMIC_ACQUIRE);
+            if (c == 0 || c >= target) break;
+            if (spins < 64) rcu_cpu_relax();
+            else sched_yield(); // The reader may need this CPU to finish its section
+        }
+    }
+    rcu_writer_barrier(); // The readers' loads are complete before the caller frees
+    pthread_mutex_unlock(&rcu_gp_lock);
+}
+
+// Runs every callback queued so far, after one grace period
+static inline void rcu_barrier(void) {
+    pthread_mutex_lock(&rcu_cb_lock);
+    struct rcu_head *list = rcu_pending;
+    rcu_pending = NULL;
+    rcu_pending_count = 0;
+    pthread_mutex_unlock(&rcu_cb_lock);
+    if (!list) return;
+    synchronize_rcu();
+    while (list) {
+        struct rcu_head *next = list->next;
+        list->func(list);
+        list = next;
+    }
+}
+
+// func(head) runs once no reader can still hold a reference; embed the rcu_head in the object
+static inline void call_rcu(struct rcu_head *head, void (*func)(struct rcu_head *)) {
+    head->func = func;
+    pthread_mutex_lock(&rcu_cb_lock);
+    head->next = rcu_pending;
+    rcu_pending = head;
+    unsigned n = ++rcu_pending_count;
+    pthread_mutex_unlock(&rcu_cb_lock);
+    if (n >= RCU_BATCH) rcu_barrier();
+}
+
+#endif // RCU_H
@@ -0,0 +1,226 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "rculist.h"
+#include "../bench_harness.h"
+
+/* Read-mostly person list (linux_linkedilist.c): reader threads look persons up by id while one
+   writer keeps replacing random persons with an updated copy (age + 1), pausing 20 us between
+   updates.
+   - rwlock: readers take pthread_rwlock_rdlock around the walk, the writer the write lock and
+     frees the old copy right away,
+   - rcu: readers walk under rcu_read_lock() (no shared writes), the writer uses
+     list_replace_rcu() and call_rcu() to free the old copy after a grace period.
+   Every point runs for a fixed time and is repeated; the median total lookup rate is reported
+   with the writer's update rate.
+   Usage: ./rcu_list_benchmark [persons] [milliseconds_per_run]   (default 100, 200) */
+
+#define REPETITIONS 3
+
+struct person {
+    char name[50];
+    int age;
+    int id;
+    struct list_head list;
+    struct rcu_head rcu;
+};
+
+struct run {
+    int use_rcu;
+    int persons;
+    struct list_head head;
+    pthread_rwlock_t lock;     // rwlock mode: protects the list
+    pthread_mutex_t write_lock; // rcu mode: serializes writers
+    int go, stop;
+    int ready;
+    unsigned long lookups[64 * 8]; // Per reader, 64 bytes apart
+    unsigned long updates;
+    unsigned long errors;
+};
+
+static void free_person_rcu(struct rcu_head *head) {
+    free(container_of(head, struct person, rcu));
+}
+
+static struct person *new_person(int id, int age) {
+    struct person *p = malloc(sizeof(struct person));
+    if (!p) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    snprintf(p->name, sizeof(p->name), "person%d", id);
+    p->id = id;
+    p->age = age;
+    return p;
+}
+
+struct reader_arg {
+    struct run *run;
+    int index;
+};
+
+static void *reader(void *argp) {
+    struct reader_arg *arg = argp;
+    struct run *run = arg->run;
+    uint64_t rng = 0x9E3779B97F4A7C15ull * (uint64_t)(arg->index + 1);
+    unsigned long lookups = 0, errors = 0;
+    if (run->use_rcu && rcu_register_thread() != 0) {
+        fprintf(stderr, "too many RCU readers\n");
+        exit(1);
+    }
+    __atomic_add_fetch(&run->ready, 1, __ATOMIC_ACQ_REL);
+    while (!__atomic_load_n(&run->go, __ATOMIC_ACQUIRE)) sched_yield();
+    while (!__atomic_load_n(&run->stop, __ATOMIC_ACQUIRE)) {
+        for (int k = 0; k < 64; ++k) {
+            int id = (int)(bench_next_random(&rng) % (uint64_t)run->persons);
+            struct person *p, *found = NULL;
+            if (run->use_rcu) {
+                rcu_read_lock();
+                list_for_each_entry_rcu(p, &run->head, struct person, list) {
+                    if (p->id == id) {
+                        found = p;
+                        break;
+                    }
+                }
+                // A freed copy would show up here (and under AddressSanitizer)
+                if (!found || found->age < id % 100 || strncmp(found->name, "person", 6) != 0) ++errors;
+                rcu_read_unlock();
+            } else {
+                pthread_rwlock_rdlock(&run->lock);
+                list_for_each_entry(p, &run->head, struct person, list) {
+                    if (p->id == id) {
+                        found = p;
+                        break;
+                    }
+                }
+                if (!found || found->age < id % 100 || strncmp(found->name, "person", 6) != 0) ++errors;
+                pthread_rwlock_unlock(&run->lock);
+            }
+        }
+        lookups += 64;
+    }
+    run->lookups[arg->index * 8] = lookups;
+    __atomic_add_fetch(&run->errors, errors, __ATOMIC_RELAXED);
+    if (run->use_rcu) rcu_unregister_thread();
+    return NULL;
+}
+
+static void *writer(void *argp) {
+    struct run *run = argp;
+    uint64_t rng = 12345;
+    struct timespec pause = {0, 20000};
+    while (!__atomic_load_n(&run->go, __ATOMIC_ACQUIRE)) sched_yield();
+    while (!__atomic_load_n(&run->stop, __ATOMIC_ACQUIRE)) {
+        int id = (int)(bench_next_random(&rng) % (uint64_t)run->persons);
+        struct person *p;
+        if (run->use_rcu) {
+            pthread_mutex_lock(&run->write_lock);
+            list_for_each_entry(p, &run->head, struct person, list) {
+                if (p->id == id) break;
+            }
+            struct person *copy = new_person(id, p->age + 1);
+            list_replace_rcu(&p->list, &copy->list);
+            pthread_mutex_unlock(&run->write_lock);
+            call_rcu(&p->rcu, free_person_rcu);
+        } else {
+            pthread_rwlock_wrlock(&run->lock);
+            list_for_each_entry(p, &run->head, struct person, list) {
+                if (p->id == id) break;
+            }
+            struct person *copy = new_person(id, p->age + 1);
+            __list_add(&copy->list, p->list.prev, p->list.next);
+            pthread_rwlock_unlock(&run->lock);
+            free(p);
+        }
+        ++run->updates;
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// One timed run; returns lookups per second and stores updates per second
+static double timed_run(int use_rcu, int readers, int persons, int millis, double *update_rate, unsigned long *errors) {
+    static struct run run;
+    memset(&run, 0, sizeof(run));
+    run.use_rcu = use_rcu;
+    run.persons = persons;
+    INIT_LIST_HEAD(&run.head);
+    pthread_rwlock_init(&run.lock, NULL);
+    pthread_mutex_init(&run.write_lock, NULL);
+    for (int i = 0; i < persons; ++i) list_add_tail(&new_person(i, i % 100)->list, &run.head);
+
+    pthread_t threads[64], writer_thread;
+    struct reader_arg args[64];
+    for (int t = 0; t < readers; ++t) {
+        args[t].run = &run;
+        args[t].index = t;
+        pthread_create(&threads[t], NULL, reader, &args[t]);
+    }
+    while (__atomic_load_n(&run.ready, __ATOMIC_ACQUIRE) != readers) sched_yield();
+    pthread_create(&writer_thread, NULL, writer, &run);
+    double start = now_sec();
+    __atomic_store_n(&run.go, 1, __ATOMIC_RELEASE);
+    struct timespec duration = {millis / 1000, (long)(millis % 1000) * 1000000L};
+    nanosleep(&duration, NULL);
+    __atomic_store_n(&run.stop, 1, __ATOMIC_RELEASE);
+    for (int t = 0; t < readers; ++t) pthread_join(threads[t], NULL);
+    pthread_join(writer_thread, NULL);
+    double elapsed = now_sec() - start;
+
+    unsigned long total = 0;
+    for (int t = 0; t < readers; ++t) total += run.lookups[t * 8];
+    *update_rate = (double)run.updates / elapsed;
+    *errors += run.errors;
+
+    if (use_rcu) rcu_barrier();
+    struct list_head *pos, *n;
+    list_for_each_safe(pos, n, &run.head) free(list_entry(pos, struct person, list));
+    pthread_rwlock_destroy(&run.lock);
+    pthread_mutex_destroy(&run.write_lock);
+    return (double)total / elapsed;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median_run(int use_rcu, int readers, int persons, int millis, double *update_rate, unsigned long *errors) {
+    double rates[REPETITIONS], updates[REPETITIONS];
+    for (int r = 0; r < REPETITIONS; ++r) rates[r] = timed_run(use_rcu, readers, persons, millis, &updates[r], errors);
+    qsort(rates, REPETITIONS, sizeof(double), compare_double);
+    qsort(updates, REPETITIONS, sizeof(double), compare_double);
+    *update_rate = updates[REPETITIONS / 2];
+    return rates[REPETITIONS / 2];
+}
+
+int main(int argc, char **argv) {
+    int persons = argc > 1 ? atoi(argv[1]) : 100;
+    int millis = argc > 2 ? atoi(argv[2]) : 200;
+    if (persons < 1 || millis < 1) return 1;
+    rcu_init();
+    printf("%d persons, %d ms per run, median of %d runs, one writer, membarrier: %s, CPUs: %ld\n\n", persons, millis,
+           REPETITIONS, rcu_use_membarrier ? "yes" : "no", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%8s %18s %14s %18s %14s %9s\n", "readers", "rwlock Mlookup/s", "updates/s", "rcu Mlookup/s", "updates/s",
+           "speedup");
+
+    unsigned long errors = 0;
+    for (int readers = 1; readers <= 64; readers *= 2) {
+        double rwlockUpdates, rcuUpdates;
+        double rwlockRate = median_run(0, readers, persons, millis, &rwlockUpdates, &errors);
+        double rcuRate = median_run(1, readers, persons, millis, &rcuUpdates, &errors);
+        printf("%8d %18.2f %14.0f %18.2f %14.0f %8.2fx\n", readers, rwlockRate / 1e6, rwlockUpdates, rcuRate / 1e6,
+               rcuUpdates, rcuRate / rwlockRate);
+    }
+    printf("\nlookups that saw a missing or freed person: %lu\n", errors);
+    return errors != 0;
+}
@@ -0,0 +1,57 @@
+#ifndef RCULIST_H
+#define RCULIST_H
+
+#include "kernel_list.h"
+#include "rcu.h"
+
+/* list_head operations that are safe against concurrent lock-free readers (the kernel's
+   include/linux/rculist.h). Readers walk with list_for_each_entry_rcu() inside
+   rcu_read_lock()/rcu_read_unlock(); writers still take a lock among themselves.
+   - A new node is fully initialized before rcu_assign_pointer() publishes it (release), so a
+     reader that sees the pointer sees the contents.
+   - list_del_rcu() leaves the removed node's next pointer alone: a reader standing on it can
+     still move on. The node may only be freed after a grace period (call_rcu).
+   - Readers only follow next pointers; prev is for writers.
+   Updating an object in place is not safe: copy it, modify the copy, list_replace_rcu().
+*/
+
+#define LIST_POISON2 ((struct list_head *)0x122)
+
+#define rcu_assign_pointer(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+#define rcu_dereference(p) __atomic_load_n(&(p), __ATOMIC_CONSUME)
+
+static inline void __list_add_rcu(struct list_head *new, struct list_head *prev, struct list_head *next) {
+    new->next = next;
+    new->prev = prev;
+    rcu_assign_pointer(prev->next, new);
+    next->prev = new;
+}
+
+static inline void list_add_rcu(struct list_head *new, struct list_head *head) {
+    __list_add_rcu(new, head, head->next);
+}
+
+static inline void list_add_tail_rcu(struct list_head *new, struct list_head *head) {
+    __list_add_rcu(new, head->prev, head);
+}
+
+static inline void list_del_rcu(struct list_head *entry) {
+    entry->next->prev = entry->prev;
+    __atomic_store_n(&entry->prev->next, entry->next, __ATOMIC_RELAXED);
+    entry->prev = LIST_POISON2;
+}
+
+// Readers see either old or new, never neither
+static inline void list_replace_rcu(struct list_head *old, struct list_head *new) {
+    new->next = old->next;
+    new->prev = old->prev;
+    rcu_assign_pointer(new->prev->next, new);
+    new->next->prev = new;
+    old->prev = LIST_POISON2;
+}
+
+#define list_for_each_entry_rcu(pos, head, type, member) \
+    for (pos = list_entry(rcu_dereference((head)->next), type, member); &pos->member != (head); \
+         pos = list_entry(rcu_dereference(pos->member.next), type, member))
+
+#endif // RCULIST_H
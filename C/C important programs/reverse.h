@@ -0,0 +1,283 @@
+#ifndef REVERSE_H
+#define REVERSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mem_copy.h"
+
+/* In-place reversal and rotation of large arrays, for str_rev.c and the "reverse-an-array" /
+   "Rotate array" programs.
+       reverse_bytes(a, n)               chars (str_rev)
+       reverse_u32(a, n), reverse_u64    32/64-bit elements (int, long, double bit patterns)
+       rotate_right(base, count, size, k)  moves every element k places to the right, wrapping
+   - Reversal swaps one vector from each end per step, reversing it on the way: pshufb with a
+     reversed index for bytes (AVX2 shuffles within 16-byte lanes, so a vpermq swaps the lanes),
+     pshufd for 32 and 64-bit elements in SSE2, vpermd / vpermq in AVX2. The few bytes left in
+     the middle use 8-byte bswaps and then single swaps. The XOR swap of str_rev.c is kept as
+     reverse_bytes_xor: it needs three dependent read-modify-writes per byte and, because start
+     and end could alias, the compiler cannot turn it into anything wider.
+   - Rotation is the Gries-Mills block swap: with L = L1 L2 and |L1| = |R|, swapping L1 and R
+     puts R in place and leaves L2 L1 to rotate (and the mirror image when L is the shorter
+     side). Every step swaps two disjoint blocks front to back, which runs at the speed of
+     streaming memory for any cache size, and each byte is moved about once. Unlike the
+     original, no second array is needed. When one side shrinks below 4 KiB it is parked in a
+     stack buffer and the rest moves with one memmove, so that rotations by a few elements do
+     not degenerate into swaps of tiny blocks.
+   Versions are picked once at startup from cpuid (AVX2 > SSSE3/SSE2 > scalar); reverse_isa()
+   names the choice.
+*/
+
+#define ROTATE_BUFFER 4096
+
+/* ---------------- scalar ---------------- */
+
+// str_rev.c: XOR swap, one byte at a time
+static inline void reverse_bytes_xor(char *a, size_t n) {
+    size_t start = 0, end = n ? n - 1 : 0;
+    while (start < end) {
+        a[start] ^= a[end];
+        a[end] ^= a[start];
+        a[start] ^= a[end];
+        start++;
+        end--;
+    }
+}
+
+// Temporary swap, one byte at a time
+static inline void reverse_bytes_swap(char *a, size_t n) {
+    for (size_t i = 0, j = n; i + 1 < j; i++) {
+        char x = a[--j];
+        a[j] = a[i];
+        a[i] = x;
+    }
+}
+
+// Fewer than 32 bytes in [lo, hi): 8-byte words from both ends, then bytes
+static inline void reverse_bytes_tail(char *lo, char *hi) {
+    while (hi - lo >= 16) {
+        hi -= 8;
+        uint64_t x = *(const mem_u64 *)lo, y = *(const mem_u64 *)hi;
+        *(mem_u64 *)lo = __builtin_bswap64(y);
+        *(mem_u64 *)hi = __builtin_bswap64(x);
+        lo += 8;
+    }
+    while (hi - lo >= 2) {
+        char x = *--hi;
+        *hi = *lo;
+        *lo++ = x;
+    }
+}
+
+// "reverse-an-array": element by element
+static inline void reverse_u32_loop(uint32_t *a, size_t n) {
+    for (size_t i = 0; i < n / 2; i++) {
+        uint32_t x = a[n - i - 1];
+        a[n - i - 1] = a[i];
+        a[i] = x;
+    }
+}
+
+static inline void reverse_u64_loop(uint64_t *a, size_t n) {
+    for (size_t i = 0; i < n / 2; i++) {
+        uint64_t x = a[n - i - 1];
+        a[n - i - 1] = a[i];
+        a[i] = x;
+    }
+}
+
+// Words, then bytes; the blocks must not overlap
+static inline void swap_blocks_words(char *a, char *b, size_t n) {
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        uint64_t x = *(const mem_u64 *)(a + i);
+        *(mem_u64 *)(a + i) = *(const mem_u64 *)(b + i);
+        *(mem_u64 *)(b + i) = x;
+    }
+    for (; i < n; i++) {
+        char x = a[i];
+        a[i] = b[i];
+        b[i] = x;
+    }
+}
+
+/* ---------------- sse2 / ssse3 / avx2 ---------------- */
+
+/* Swaps a vector from each end of [lo, hi) while at least two are left, reversing both.
+   T: element type, V: vector type, VEC: its size, REV(v): v with its elements reversed. */
+#define REVERSE_VECTOR_LOOP(T, V, VEC, LOADU, STOREU, REV)                                                 \
+    T *lo = a, *hi = a + n;                                                                                \
+    const size_t step = VEC / sizeof(T);                                                                   \
+    while ((size_t)(hi - lo) >= 2 * step) {                                                                \
+        hi -= step;                                                                                        \
+        V x = LOADU(lo), y = LOADU(hi);                                                                    \
+        STOREU(lo, REV(y));                                                                                \
+        STOREU(hi, REV(x));                                                                                \
+        lo += step;                                                                                        \
+    }
+
+#if MEM_COPY_X86
+#define REV_SSE2_LOADU(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define REV_SSE2_STOREU(p, v) _mm_storeu_si128((__m128i *)(void *)(p), v)
+#define REV_AVX2_LOADU(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define REV_AVX2_STOREU(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+
+#define REV_SSSE3_BYTES(v) _mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0))
+#define REV_AVX2_BYTES(v)                                                                                  \
+    _mm256_permute4x64_epi64(                                                                              \
+        _mm256_shuffle_epi8(v, _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14,  \
+                                                13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)),            \
+        0x4E)
+#define REV_SSE2_U32(v) _mm_shuffle_epi32(v, 0x1B)
+#define REV_AVX2_U32(v) _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0))
+#define REV_SSE2_U64(v) _mm_shuffle_epi32(v, 0x4E)
+#define REV_AVX2_U64(v) _mm256_permute4x64_epi64(v, 0x1B)
+
+__attribute__((target("ssse3")))
+static inline void reverse_bytes_ssse3(char *a, size_t n) {
+    REVERSE_VECTOR_LOOP(char, __m128i, 16, REV_SSE2_LOADU, REV_SSE2_STOREU, REV_SSSE3_BYTES)
+    reverse_bytes_tail(lo, hi);
+}
+
+__attribute__((target("avx2")))
+static inline void reverse_bytes_avx2(char *a, size_t n) {
+    REVERSE_VECTOR_LOOP(char, __m256i, 32, REV_AVX2_LOADU, REV_AVX2_STOREU, REV_AVX2_BYTES)
+    reverse_bytes_ssse3(lo, (size_t)(hi - lo));
+}
+
+__attribute__((target("sse2")))
+static inline void reverse_u32_sse2(uint32_t *a, size_t n) {
+    REVERSE_VECTOR_LOOP(uint32_t, __m128i, 16, REV_SSE2_LOADU, REV_SSE2_STOREU, REV_SSE2_U32)
+    reverse_u32_loop(lo, (size_t)(hi - lo));
+}
+
+__attribute__((target("avx2")))
+static inline void reverse_u32_avx2(uint32_t *a, size_t n) {
+    REVERSE_VECTOR_LOOP(uint32_t, __m256i, 32, REV_AVX2_LOADU, REV_AVX2_STOREU, REV_AVX2_U32)
+    reverse_u32_sse2(lo, (size_t)(hi - lo));
+}
+
+__attribute__((target("sse2")))
+static inline void reverse_u64_sse2(uint64_t *a, size_t n) {
+    REVERSE_VECTOR_LOOP(uint64_t, __m128i, 16, REV_SSE2_LOADU, REV_SSE2_STOREU, REV_SSE2_U64)
+    reverse_u64_loop(lo, (size_t)(hi - lo));
+}
+
+__attribute__((target("avx2")))
+static inline void reverse_u64_avx2(uint64_t *a, size_t n) {
+    REVERSE_VECTOR_LOOP(uint64_t, __m256i, 32, REV_AVX2_LOADU, REV_AVX2_STOREU, REV_AVX2_U64)
+    reverse_u64_sse2(lo, (size_t)(hi - lo));
+}
+
+__attribute__((target("sse2")))
+static inline void swap_blocks_sse2(char *a, char *b, size_t n) {
+    size_t i = 0;
+    for (; n - i >= 16; i += 16) {
+        __m128i x = REV_SSE2_LOADU(a + i), y = REV_SSE2_LOADU(b + i);
+        REV_SSE2_STOREU(a + i, y);
+        REV_SSE2_STOREU(b + i, x);
+    }
+    swap_blocks_words(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static inline void swap_blocks_avx2(char *a, char *b, size_t n) {
+    size_t i = 0;
+    for (; n - i >= 64; i += 64) {
+        __m256i x0 = REV_AVX2_LOADU(a + i), x1 = REV_AVX2_LOADU(a + i + 32);
+        __m256i y0 = REV_AVX2_LOADU(b + i), y1 = REV_AVX2_LOADU(b + i + 32);
+        REV_AVX2_STOREU(a + i, y0);
+        REV_AVX2_STOREU(a + i + 32, y1);
+        REV_AVX2_STOREU(b + i, x0);
+        REV_AVX2_STOREU(b + i + 32, x1);
+    }
+    swap_blocks_sse2(a + i, b + i, n - i);
+}
+#endif
+
+/* ---------------- dispatch ---------------- */
+
+static void (*reverse_bytes_impl)(char *, size_t) = reverse_bytes_swap;
+static void (*reverse_u32_impl)(uint32_t *, size_t) = reverse_u32_loop;
+static void (*reverse_u64_impl)(uint64_t *, size_t) = reverse_u64_loop;
+static void (*swap_blocks_impl)(char *, char *, size_t) = swap_blocks_words;
+static const char *reverse_impl_name = "scalar";
+
+// Constructor: the SSSE3 byte shuffle needs its own check, pshufd is plain SSE2
+__attribute__((constructor)) static void reverse_select(void) {
+#if MEM_COPY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        reverse_bytes_impl = reverse_bytes_avx2;
+        reverse_u32_impl = reverse_u32_avx2;
+        reverse_u64_impl = reverse_u64_avx2;
+        swap_blocks_impl = swap_blocks_avx2;
+        reverse_impl_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        if (__builtin_cpu_supports("ssse3")) reverse_bytes_impl = reverse_bytes_ssse3;
+        reverse_u32_impl = reverse_u32_sse2;
+        reverse_u64_impl = reverse_u64_sse2;
+        swap_blocks_impl = swap_blocks_sse2;
+        reverse_impl_name = "sse2";
+    }
+#endif
+}
+
+static inline void reverse_bytes(char *a, size_t n) {
+    reverse_bytes_impl(a, n);
+}
+
+static inline void reverse_u32(uint32_t *a, size_t n) {
+    reverse_u32_impl(a, n);
+}
+
+static inline void reverse_u64(uint64_t *a, size_t n) {
+    reverse_u64_impl(a, n);
+}
+
+// Exchanges two blocks of n bytes that do not overlap
+static inline void swap_blocks(void *a, void *b, size_t n) {
+    swap_blocks_impl((char *)a, (char *)b, n);
+}
+
+// [p, p + left + right) = L R becomes R L
+static inline void rotate_bytes(char *p, size_t left, size_t right) {
+    char buffer[ROTATE_BUFFER];
+    while (left && right) {
+        if (left <= ROTATE_BUFFER || right <= ROTATE_BUFFER) {
+            if (left <= right) {
+                memcpy(buffer, p, left);
+                mem_move(p, p + left, right);
+                memcpy(p + right, buffer, left);
+            } else {
+                memcpy(buffer, p + left, right);
+                mem_move(p + right, p, left);
+                memcpy(p, buffer, right);
+            }
+            return;
+        }
+        if (left <= right) {
+            // L R1 R2 with |R2| = |L|  ->  R2 R1 L, then R2 R1 -> R1 R2
+            swap_blocks(p, p + right, left);
+            right -= left;
+        } else {
+            // L1 L2 R with |L1| = |R|  ->  R L2 L1, then L2 L1 -> L1 L2
+            swap_blocks(p, p + left, right);
+            p += right;
+            left -= right;
+        }
+    }
+}
+
+// Every element moves k places to the right, the last k wrap around to the front
+static inline void rotate_right(void *base, size_t count, size_t size, size_t k) {
+    if (count == 0) return;
+    k %= count;
+    rotate_bytes((char *)base, (count - k) * size, k * size);
+}
+
+static inline const char *reverse_isa(void) {
+    return reverse_impl_name;
+}
+
+#endif // REVERSE_H
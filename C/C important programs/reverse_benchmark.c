@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "reverse.h"
+#include "../bench_harness.h"
+
+/* reverse.h against the loops of str_rev.c, "reverse-an-array" and "Rotate array", in place on
+   buffers of 1 KiB to 1 GiB:
+   - bytes/...: xor (str_rev.c), swap (temporary), ssse3, avx2,
+   - u32/... and u64/...: loop ("reverse-an-array"), sse2, avx2,
+   - rotate/...: k = n/3 int elements to the right; aux ("Rotate array": every element to its
+     place in a second array, then copied back), reversal (three reverse_u32 calls), block_swap
+     (rotate_right).
+   Every version is first checked against a plain reference on random sizes and shifts.
+   Usage: ./reverse_benchmark [max_bytes] [bench_harness options]   (default 1 GiB) */
+
+struct reverse_job {
+    int kind;
+    void *data;
+    void *aux;
+    size_t bytes;
+};
+
+enum { BYTES_XOR, BYTES_SWAP, BYTES_SSSE3, BYTES_AVX2, U32_LOOP, U32_SSE2, U32_AVX2, U64_LOOP, U64_SSE2, U64_AVX2,
+       ROTATE_AUX, ROTATE_REVERSAL, ROTATE_BLOCK_SWAP, KIND_COUNT };
+static const char *kind_names[KIND_COUNT] = {"bytes/xor", "bytes/swap", "bytes/ssse3", "bytes/avx2", "u32/loop",
+                                             "u32/sse2", "u32/avx2", "u64/loop", "u64/sse2", "u64/avx2",
+                                             "rotate/aux", "rotate/reversal", "rotate/block_swap"};
+
+// "Rotate array", writing the result back in place
+static void rotate_aux(uint32_t *a, uint32_t *aux, size_t n, size_t k) {
+    for (size_t i = 0; i < n; ++i) {
+        size_t x = k + i;
+        if (x >= n) x -= n;
+        aux[x] = a[i];
+    }
+    memcpy(a, aux, n * sizeof(uint32_t));
+}
+
+// Right rotation as three reversals: reverse everything, then each part
+static void rotate_reversal(uint32_t *a, size_t n, size_t k) {
+    reverse_u32(a, n);
+    reverse_u32(a, k);
+    reverse_u32(a + k, n - k);
+}
+
+static void run_kind(int kind, void *data, void *aux, size_t bytes) {
+    size_t n32 = bytes / 4, n64 = bytes / 8;
+    switch (kind) {
+    case BYTES_XOR: reverse_bytes_xor(data, bytes); break;
+    case BYTES_SWAP: reverse_bytes_swap(data, bytes); break;
+    case U32_LOOP: reverse_u32_loop(data, n32); break;
+    case U64_LOOP: reverse_u64_loop(data, n64); break;
+#if MEM_COPY_X86
+    case BYTES_SSSE3: reverse_bytes_ssse3(data, bytes); break;
+    case BYTES_AVX2: reverse_bytes_avx2(data, bytes); break;
+    case U32_SSE2: reverse_u32_sse2(data, n32); break;
+    case U32_AVX2: reverse_u32_avx2(data, n32); break;
+    case U64_SSE2: reverse_u64_sse2(data, n64); break;
+    case U64_AVX2: reverse_u64_avx2(data, n64); break;
+#endif
+    case ROTATE_AUX: rotate_aux(data, aux, n32, n32 / 3); break;
+    case ROTATE_REVERSAL: rotate_reversal(data, n32, n32 / 3); break;
+    case ROTATE_BLOCK_SWAP: rotate_right(data, n32, sizeof(uint32_t), n32 / 3); break;
+    }
+}
+
+static void bench_reverse(void *ctx, uint64_t iters) {
+    struct reverse_job *job = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        run_kind(job->kind, job->data, job->aux, job->bytes);
+        BENCH_CLOBBER_MEMORY();
+    }
+}
+
+static int supported(int kind) {
+#if MEM_COPY_X86
+    if (kind == BYTES_SSSE3) return __builtin_cpu_supports("ssse3");
+    if (kind == BYTES_AVX2 || kind == U32_AVX2 || kind == U64_AVX2) return __builtin_cpu_supports("avx2");
+    return 1;
+#else
+    return kind != BYTES_SSSE3 && kind != BYTES_AVX2 && kind != U32_SSE2 && kind != U32_AVX2 && kind != U64_SSE2 &&
+           kind != U64_AVX2;
+#endif
+}
+
+// Differential check against an element-by-element reference; returns the number of mismatches
+static int verify(int kind) {
+    enum { SIZE = 1 << 18 };
+    static unsigned char a[SIZE], expect[SIZE], aux[SIZE];
+    uint64_t rng = 5;
+    int bad = 0;
+    for (int round = 0; round < 2000; ++round) {
+        size_t bytes = (size_t)(bench_next_random(&rng) % (round % 4 ? 300 : SIZE - 64)) & ~(size_t)7;
+        size_t offset = (size_t)(bench_next_random(&rng) % 8) * 8; // Element-aligned, not vector-aligned
+        unsigned char *p = a + offset;
+        for (size_t i = 0; i < bytes; ++i) p[i] = expect[i] = (unsigned char)bench_next_random(&rng);
+        size_t size = kind >= ROTATE_AUX || (kind >= U32_LOOP && kind <= U32_AVX2) ? 4 : kind >= U64_LOOP ? 8 : 1;
+        size_t count = bytes / size;
+        if (kind >= ROTATE_AUX) {
+            // Also k near 0 and n (buffered path) and both sides above the buffer size
+            size_t k = count ? (size_t)(bench_next_random(&rng) % count) : 0;
+            if (round % 5 == 1) k = count ? 1 : 0;
+            if (round % 5 == 2 && count > 2) k = count - 2;
+            for (size_t i = 0; i < count; ++i) memcpy(aux + ((i + k) % count) * 4, expect + i * 4, 4);
+            memcpy(expect, aux, bytes);
+            if (kind == ROTATE_AUX) rotate_aux((uint32_t *)(void *)p, (uint32_t *)(void *)aux, count, k);
+            else if (kind == ROTATE_REVERSAL) rotate_reversal((uint32_t *)(void *)p, count, k);
+            else rotate_right(p, count, 4, k);
+        } else {
+            for (size_t i = 0; i < count / 2; ++i) {
+                unsigned char t[8];
+                memcpy(t, expect + i * size, size);
+                memcpy(expect + i * size, expect + (count - 1 - i) * size, size);
+                memcpy(expect + (count - 1 - i) * size, t, size);
+            }
+            run_kind(kind, p, aux, bytes);
+        }
+        if (memcmp(p, expect, bytes) != 0) ++bad;
+    }
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    size_t max_bytes = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : ((size_t)1 << 30);
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    int failures = 0;
+    for (int kind = 0; kind < KIND_COUNT; ++kind) {
+        if (!supported(kind)) continue;
+        int bad = verify(kind);
+        failures += bad;
+        printf("check %-18s %s\n", kind_names[kind], bad ? "MISMATCH" : "ok");
+    }
+    printf("dispatch: %s\n\n", reverse_isa());
+
+    size_t buffer_bytes = (max_bytes + 4095) & ~(size_t)4095;
+    char *data = aligned_alloc(4096, buffer_bytes);
+    char *aux = aligned_alloc(4096, buffer_bytes);
+    if (!data || !aux) return 1;
+    uint64_t rng = 9;
+    for (size_t i = 0; i < buffer_bytes; i += 8) {
+        uint64_t r = bench_next_random(&rng);
+        memcpy(data + i, &r, 8);
+    }
+    memset(aux, 0, buffer_bytes);
+
+    char name[64];
+    for (size_t bytes = 1024; bytes <= max_bytes; bytes *= 32) {
+        for (int kind = 0; kind < KIND_COUNT; ++kind) {
+            if (!supported(kind)) continue;
+            struct reverse_job job = {kind, data, aux, bytes};
+            snprintf(name, sizeof(name), "%s/%zu", kind_names[kind], bytes);
+            bench_set_bytes(bench_run(&session, name, bench_reverse, &job), (double)bytes);
+        }
+    }
+
+    free(data);
+    free(aux);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
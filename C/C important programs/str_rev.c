@@ -7,19 +7,13 @@ Welcome to GDB Online.
 
 *******************************************************************************/
 #include <stdio.h>
+#include "reverse.h"
 
 void str_rev(char *str, size_t size)
 {
-	// think why -2 is used, not -1
-    int start=0, end=size-2;
-    while(start<end)
-    {
-        (*(str+start))^=(*(str+end));
-        (*(str+end))^=(*(str+start));
-        (*(str+start))^=(*(str+end));
-        start++;
-        end--;
-    }
+	// think why size-1 is used, not size (the XOR-swap loop this replaced is reverse_bytes_xor)
+    if(size>1)
+        reverse_bytes(str, size-1);
 }
 
 int main()
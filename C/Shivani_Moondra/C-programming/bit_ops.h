@@ -0,0 +1,478 @@
+#ifndef BIT_OPS_H
+#define BIT_OPS_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BIT_OPS_X86 1
+#else
+#define BIT_OPS_X86 0
+#endif
+
+/* The bit tricks of this directory ("check number of set bit", "Reversing the bits of a number",
+   "Swap nibble", "SWAP TWO BIT.c", "n is power of 2") for whole arrays and bitmaps.
+   One value:
+       bit_popcount64(x)  bit_reverse32(x)  bit_reverse64(x)  bit_swap(x, i, j)
+       is_power_of_two(x)  bit_select64(x, k)
+   Arrays (dst may be src):
+       bits_popcount(words, n)                    set bits in n 64-bit words
+       bits_reverse_u32(dst, src, n)              bit_reverse32 of every element
+       bits_nibble_swap(dst, src, n)              the two halves of every byte swapped
+       bits_swap_pair(dst, src, n, i, j)          bits i and j of every element exchanged
+       bits_count_powers_of_two(a, n)
+   Bitmaps: struct bitmap_index, for rank (ones before a position) and select (position of the
+   k-th one) in constant time.
+   - Popcount is Harley-Seal: a carry-save adder tree folds 16 words into 1, 2, 4, 8 and 16-weight
+     words, so only one word in 16 goes through a real popcount. The AVX2 version does the same
+     with 256-bit words and counts with pshufb: a 16-entry table of nibble counts held in a
+     register, looked up for both nibbles of every byte, summed with psadbw. Without AVX2 the
+     popcnt instruction is used, and without that a shift-and-mask (SWAR) count.
+   - Bit reversal without a table: bswap reverses the bytes, then three mask-and-shift steps swap
+     nibbles, bit pairs and single bits. The AVX2 version reverses 32 bytes at once with pshufb,
+     both for the byte order and, through two in-register nibble tables, inside each byte.
+   - rank9 layout (Vigna): for every 512 bits, one 64-bit count of the ones before them and one
+     word packing the seven 9-bit counts of the ones before each of their words 1..7. rank is two
+     loads and a popcount, 25% extra space. select binary-searches the blocks between two samples
+     (the block of every 8192nd one), then the packed counts, then the word, where pdep (BMI2)
+     deposits a single bit on the k-th one.
+   Versions are picked once at startup from cpuid; bit_ops_isa() names the choice.
+*/
+
+#define BIT_ONES 0x0101010101010101ull
+
+/* ---------------- one value ---------------- */
+
+static inline uint64_t bit_popcount64_swar(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (x * BIT_ONES) >> 56;
+}
+
+static inline unsigned bit_popcount64(uint64_t x) {
+#ifdef __POPCNT__
+    return (unsigned)__builtin_popcountll(x);
+#else
+    return (unsigned)bit_popcount64_swar(x);
+#endif
+}
+
+static inline uint32_t bit_reverse32(uint32_t x) {
+    x = __builtin_bswap32(x);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    return ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+}
+
+static inline uint64_t bit_reverse64(uint64_t x) {
+    x = __builtin_bswap64(x);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+    x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+    return ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+}
+
+// SWAP TWO BIT.c for any two positions: flip both when they differ
+static inline uint32_t bit_swap(uint32_t x, unsigned i, unsigned j) {
+    uint32_t t = ((x >> i) ^ (x >> j)) & 1u;
+    return x ^ ((t << i) | (t << j));
+}
+
+static inline int is_power_of_two(uint32_t x) {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+// Position of the k-th set bit of x (k counted from 0, k < popcount(x))
+static inline unsigned bit_select64_swar(uint64_t x, unsigned k) {
+    uint64_t s = x - ((x >> 1) & 0x5555555555555555ull);
+    s = (s & 0x3333333333333333ull) + ((s >> 2) & 0x3333333333333333ull);
+    s = ((s + (s >> 4)) & 0x0F0F0F0F0F0F0F0Full) * BIT_ONES; // Byte i: ones in bytes 0..i
+    unsigned byte = 0;
+    while (((s >> (8 * byte)) & 0xFF) <= k) byte++;
+    if (byte) k -= (unsigned)((s >> (8 * (byte - 1))) & 0xFF);
+    unsigned b = (unsigned)(x >> (8 * byte)) & 0xFF;
+    while (k--) b &= b - 1;
+    return 8 * byte + (unsigned)__builtin_ctz(b);
+}
+
+#if BIT_OPS_X86
+__attribute__((target("bmi,bmi2")))
+static inline unsigned bit_select64_bmi2(uint64_t x, unsigned k) {
+    return (unsigned)_tzcnt_u64(_pdep_u64(1ull << k, x));
+}
+#endif
+
+static int bit_ops_have_bmi2;
+
+static inline unsigned bit_select64(uint64_t x, unsigned k) {
+#if BIT_OPS_X86
+    if (bit_ops_have_bmi2) return bit_select64_bmi2(x, k);
+#endif
+    return bit_select64_swar(x, k);
+}
+
+/* ---------------- arrays, scalar ---------------- */
+
+// Carry-save adder: a + b + c = 2 * high + low, bit by bit
+#define BIT_CSA(high, low, a, b, c)                                                                        \
+    do {                                                                                                   \
+        uint64_t u_ = (a) ^ (b);                                                                           \
+        high = ((a) & (b)) | (u_ & (c));                                                                   \
+        low = u_ ^ (c);                                                                                    \
+    } while (0)
+
+static inline uint64_t bits_popcount_harley_seal(const uint64_t *w, size_t n) {
+    uint64_t total = 0, ones = 0, twos = 0, fours = 0, eights = 0, sixteens;
+    uint64_t twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        BIT_CSA(twos_a, ones, ones, w[i], w[i + 1]);
+        BIT_CSA(twos_b, ones, ones, w[i + 2], w[i + 3]);
+        BIT_CSA(fours_a, twos, twos, twos_a, twos_b);
+        BIT_CSA(twos_a, ones, ones, w[i + 4], w[i + 5]);
+        BIT_CSA(twos_b, ones, ones, w[i + 6], w[i + 7]);
+        BIT_CSA(fours_b, twos, twos, twos_a, twos_b);
+        BIT_CSA(eights_a, fours, fours, fours_a, fours_b);
+        BIT_CSA(twos_a, ones, ones, w[i + 8], w[i + 9]);
+        BIT_CSA(twos_b, ones, ones, w[i + 10], w[i + 11]);
+        BIT_CSA(fours_a, twos, twos, twos_a, twos_b);
+        BIT_CSA(twos_a, ones, ones, w[i + 12], w[i + 13]);
+        BIT_CSA(twos_b, ones, ones, w[i + 14], w[i + 15]);
+        BIT_CSA(fours_b, twos, twos, twos_a, twos_b);
+        BIT_CSA(eights_b, fours, fours, fours_a, fours_b);
+        BIT_CSA(sixteens, eights, eights, eights_a, eights_b);
+        total += bit_popcount64_swar(sixteens);
+    }
+    total = 16 * total + 8 * bit_popcount64_swar(eights) + 4 * bit_popcount64_swar(fours) +
+            2 * bit_popcount64_swar(twos) + bit_popcount64_swar(ones);
+    for (; i < n; i++) total += bit_popcount64_swar(w[i]);
+    return total;
+}
+
+static inline void bits_reverse_u32_scalar(uint32_t *dst, const uint32_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = bit_reverse32(src[i]);
+}
+
+// Eight bytes per step: the low nibbles move up, the high ones down
+static inline void bits_nibble_swap_swar(uint8_t *dst, const uint8_t *src, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x;
+        __builtin_memcpy(&x, src + i, 8);
+        x = ((x & 0x0F0F0F0F0F0F0F0Full) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0Full);
+        __builtin_memcpy(dst + i, &x, 8);
+    }
+    for (; i < n; i++) dst[i] = (uint8_t)(src[i] << 4 | src[i] >> 4);
+}
+
+static inline void bits_swap_pair_scalar(uint32_t *dst, const uint32_t *src, size_t n, unsigned i, unsigned j) {
+    // As a mask and a distance, both loop-invariant: the compiler vectorizes this like a fixed pair
+    unsigned low = i < j ? i : j, d = i < j ? j - i : i - j;
+    const uint32_t mask = 1u << low;
+    for (size_t k = 0; k < n; k++) {
+        uint32_t x = src[k], t = ((x >> d) ^ x) & mask;
+        dst[k] = x ^ t ^ (t << d);
+    }
+}
+
+static inline size_t bits_count_powers_of_two_scalar(const uint32_t *a, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (size_t)is_power_of_two(a[i]);
+    return count;
+}
+
+/* ---------------- arrays, popcnt / avx2 ---------------- */
+
+#if BIT_OPS_X86
+__attribute__((target("popcnt")))
+static inline uint64_t bits_popcount_popcnt(const uint64_t *w, size_t n) {
+    uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0; // Four chains: popcnt has a latency of 3
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        c0 += (uint64_t)__builtin_popcountll(w[i]);
+        c1 += (uint64_t)__builtin_popcountll(w[i + 1]);
+        c2 += (uint64_t)__builtin_popcountll(w[i + 2]);
+        c3 += (uint64_t)__builtin_popcountll(w[i + 3]);
+    }
+    for (; i < n; i++) c0 += (uint64_t)__builtin_popcountll(w[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+#define BIT_AVX2_LOADU(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define BIT_AVX2_STOREU(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#define BIT_AVX2_CSA(high, low, a, b, c)                                                                   \
+    do {                                                                                                   \
+        __m256i u_ = _mm256_xor_si256(a, b);                                                               \
+        high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u_, c));                          \
+        low = _mm256_xor_si256(u_, c);                                                                     \
+    } while (0)
+
+// Four 64-bit sums of the set bits of v
+__attribute__((target("avx2")))
+static inline __m256i bit_popcount256(__m256i v) {
+    const __m256i counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, low_nibbles);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(counts, lo), _mm256_shuffle_epi8(counts, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2,popcnt")))
+static inline uint64_t bits_popcount_avx2(const uint64_t *w, size_t n) {
+    __m256i total = _mm256_setzero_si256(), ones = total, twos = total, fours = total, eights = total;
+    __m256i sixteens, twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    const uint64_t *p = w;
+    size_t blocks = n / 64; // 16 vectors of 4 words
+    for (size_t b = 0; b < blocks; b++, p += 64) {
+        BIT_AVX2_CSA(twos_a, ones, ones, BIT_AVX2_LOADU(p), BIT_AVX2_LOADU(p + 4));
+        BIT_AVX2_CSA(twos_b, ones, ones, BIT_AVX2_LOADU(p + 8), BIT_AVX2_LOADU(p + 12));
+        BIT_AVX2_CSA(fours_a, twos, twos, twos_a, twos_b);
+        BIT_AVX2_CSA(twos_a, ones, ones, BIT_AVX2_LOADU(p + 16), BIT_AVX2_LOADU(p + 20));
+        BIT_AVX2_CSA(twos_b, ones, ones, BIT_AVX2_LOADU(p + 24), BIT_AVX2_LOADU(p + 28));
+        BIT_AVX2_CSA(fours_b, twos, twos, twos_a, twos_b);
+        BIT_AVX2_CSA(eights_a, fours, fours, fours_a, fours_b);
+        BIT_AVX2_CSA(twos_a, ones, ones, BIT_AVX2_LOADU(p + 32), BIT_AVX2_LOADU(p + 36));
+        BIT_AVX2_CSA(twos_b, ones, ones, BIT_AVX2_LOADU(p + 40), BIT_AVX2_LOADU(p + 44));
+        BIT_AVX2_CSA(fours_a, twos, twos, twos_a, twos_b);
+        BIT_AVX2_CSA(twos_a, ones, ones, BIT_AVX2_LOADU(p + 48), BIT_AVX2_LOADU(p + 52));
+        BIT_AVX2_CSA(twos_b, ones, ones, BIT_AVX2_LOADU(p + 56), BIT_AVX2_LOADU(p + 60));
+        BIT_AVX2_CSA(fours_b, twos, twos, twos_a, twos_b);
+        BIT_AVX2_CSA(eights_b, fours, fours, fours_a, fours_b);
+        BIT_AVX2_CSA(sixteens, eights, eights, eights_a, eights_b);
+        total = _mm256_add_epi64(total, bit_popcount256(sixteens));
+    }
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(bit_popcount256(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(bit_popcount256(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(bit_popcount256(twos), 1));
+    total = _mm256_add_epi64(total, bit_popcount256(ones));
+    uint64_t sum = (uint64_t)_mm256_extract_epi64(total, 0) + (uint64_t)_mm256_extract_epi64(total, 1) +
+                   (uint64_t)_mm256_extract_epi64(total, 2) + (uint64_t)_mm256_extract_epi64(total, 3);
+    return sum + bits_popcount_popcnt(p, n - blocks * 64);
+}
+
+// Every byte with its bits reversed: a nibble table for each half, held in a register
+__attribute__((target("avx2")))
+static inline __m256i bit_reverse_bytes256(__m256i v) {
+    const __m256i reversed = _mm256_setr_epi8(0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB,
+                                              0x7, 0xF, 0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD,
+                                              0x3, 0xB, 0x7, 0xF);
+    const __m256i reversed_high = _mm256_slli_epi16(reversed, 4); // Entries < 16: no bits cross bytes
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, low_nibbles);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+    return _mm256_or_si256(_mm256_shuffle_epi8(reversed_high, lo), _mm256_shuffle_epi8(reversed, hi));
+}
+
+__attribute__((target("avx2")))
+static inline void bits_reverse_u32_avx2(uint32_t *dst, const uint32_t *src, size_t n) {
+    const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5,
+                                           4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        BIT_AVX2_STOREU(dst + i, bit_reverse_bytes256(_mm256_shuffle_epi8(BIT_AVX2_LOADU(src + i), bswap)));
+    bits_reverse_u32_scalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static inline void bits_nibble_swap_avx2(uint8_t *dst, const uint8_t *src, size_t n) {
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = BIT_AVX2_LOADU(src + i);
+        __m256i up = _mm256_slli_epi16(_mm256_and_si256(v, low_nibbles), 4);
+        __m256i down = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+        BIT_AVX2_STOREU(dst + i, _mm256_or_si256(up, down));
+    }
+    bits_nibble_swap_swar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static inline void bits_swap_pair_avx2(uint32_t *dst, const uint32_t *src, size_t n, unsigned i, unsigned j) {
+    const __m128i shift_i = _mm_cvtsi32_si128((int)i), shift_j = _mm_cvtsi32_si128((int)j);
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i x = BIT_AVX2_LOADU(src + k);
+        __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srl_epi32(x, shift_i), _mm256_srl_epi32(x, shift_j)), one);
+        __m256i flip = _mm256_or_si256(_mm256_sll_epi32(t, shift_i), _mm256_sll_epi32(t, shift_j));
+        BIT_AVX2_STOREU(dst + k, _mm256_xor_si256(x, flip));
+    }
+    bits_swap_pair_scalar(dst + k, src + k, n - k, i, j);
+}
+
+__attribute__((target("avx2")))
+static inline size_t bits_count_powers_of_two_avx2(const uint32_t *a, size_t n) {
+    const __m256i zero = _mm256_setzero_si256(), all = _mm256_set1_epi32(-1);
+    __m256i count = zero; // Minus the count per lane: a true compare is -1
+    size_t i = 0, total = 0;
+    while (i + 8 <= n) {
+        // Lane counts stay far below 2^31 when flushed every 2^24 steps
+        size_t end = n - i > ((size_t)8 << 24) ? i + ((size_t)8 << 24) : n;
+        for (; i + 8 <= end; i += 8) {
+            __m256i x = BIT_AVX2_LOADU(a + i);
+            __m256i single = _mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_add_epi32(x, all)), zero);
+            __m256i nonzero = _mm256_andnot_si256(_mm256_cmpeq_epi32(x, zero), single);
+            count = _mm256_sub_epi32(count, nonzero);
+        }
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(count), _mm256_extracti128_si256(count, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        total += (uint32_t)_mm_cvtsi128_si32(sum);
+        count = zero;
+    }
+    return total + bits_count_powers_of_two_scalar(a + i, n - i);
+}
+#endif
+
+/* ---------------- dispatch ---------------- */
+
+static uint64_t (*bits_popcount_impl)(const uint64_t *, size_t) = bits_popcount_harley_seal;
+static void (*bits_reverse_u32_impl)(uint32_t *, const uint32_t *, size_t) = bits_reverse_u32_scalar;
+static void (*bits_nibble_swap_impl)(uint8_t *, const uint8_t *, size_t) = bits_nibble_swap_swar;
+static void (*bits_swap_pair_impl)(uint32_t *, const uint32_t *, size_t, unsigned, unsigned) = bits_swap_pair_scalar;
+static size_t (*bits_count_powers_of_two_impl)(const uint32_t *, size_t) = bits_count_powers_of_two_scalar;
+static const char *bit_ops_impl_name = "scalar";
+
+// Constructor: AVX2 only with popcnt, which counts the tail of bits_popcount_avx2; BMI2 on its own
+__attribute__((constructor)) static void bit_ops_select(void) {
+#if BIT_OPS_X86
+    __builtin_cpu_init();
+    bit_ops_have_bmi2 = __builtin_cpu_supports("bmi2");
+    if (__builtin_cpu_supports("popcnt")) {
+        bits_popcount_impl = bits_popcount_popcnt;
+        bit_ops_impl_name = "popcnt";
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        bits_popcount_impl = bits_popcount_avx2;
+        bits_reverse_u32_impl = bits_reverse_u32_avx2;
+        bits_nibble_swap_impl = bits_nibble_swap_avx2;
+        bits_swap_pair_impl = bits_swap_pair_avx2;
+        bits_count_powers_of_two_impl = bits_count_powers_of_two_avx2;
+        bit_ops_impl_name = "avx2";
+    }
+#endif
+}
+
+static inline uint64_t bits_popcount(const uint64_t *words, size_t n) {
+    return bits_popcount_impl(words, n);
+}
+
+static inline void bits_reverse_u32(uint32_t *dst, const uint32_t *src, size_t n) {
+    bits_reverse_u32_impl(dst, src, n);
+}
+
+static inline void bits_nibble_swap(uint8_t *dst, const uint8_t *src, size_t n) {
+    bits_nibble_swap_impl(dst, src, n);
+}
+
+static inline void bits_swap_pair(uint32_t *dst, const uint32_t *src, size_t n, unsigned i, unsigned j) {
+    bits_swap_pair_impl(dst, src, n, i, j);
+}
+
+static inline size_t bits_count_powers_of_two(const uint32_t *a, size_t n) {
+    return bits_count_powers_of_two_impl(a, n);
+}
+
+static inline const char *bit_ops_isa(void) {
+    return bit_ops_impl_name;
+}
+
+/* ---------------- rank / select ---------------- */
+
+#define BITMAP_SELECT_SAMPLE 8192
+
+struct bitmap_index {
+    const uint64_t *bits; // Not owned; must not change while the index is used
+    size_t nbits;
+    size_t ones;
+    uint64_t *counts; // Per 512-bit block: ones before it, then its 7 packed 9-bit counts
+    size_t blocks;
+    size_t *samples; // Block holding the one numbered j * BITMAP_SELECT_SAMPLE
+    size_t nsamples;
+};
+
+// Returns 0, or -ENOMEM. Bits of the last word at or above nbits are ignored.
+static inline int bitmap_index_init(struct bitmap_index *ix, const uint64_t *bits, size_t nbits) {
+    size_t words = (nbits + 63) / 64;
+    ix->bits = bits;
+    ix->nbits = nbits;
+    ix->blocks = (words + 7) / 8;
+    ix->counts = malloc((2 * ix->blocks + 2) * sizeof(uint64_t)); // A sentinel block for rank(nbits)
+    ix->samples = NULL;
+    if (!ix->counts) return -ENOMEM;
+
+    size_t ones = 0;
+    for (size_t b = 0; b < ix->blocks; b++) {
+        uint64_t packed = 0, in_block = 0;
+        ix->counts[2 * b] = ones;
+        for (size_t w = 0; w < 8; w++) {
+            if (w) packed |= in_block << (9 * (w - 1));
+            size_t word = 8 * b + w;
+            if (word >= words) continue;
+            uint64_t x = bits[word];
+            if (word == words - 1 && nbits % 64) x &= (1ull << (nbits % 64)) - 1;
+            in_block += bit_popcount64(x);
+        }
+        ix->counts[2 * b + 1] = packed;
+        ones += in_block;
+    }
+    ix->counts[2 * ix->blocks] = ones;
+    ix->counts[2 * ix->blocks + 1] = 0;
+    ix->ones = ones;
+
+    size_t nsamples = ones / BITMAP_SELECT_SAMPLE + 1;
+    ix->nsamples = nsamples;
+    ix->samples = malloc(nsamples * sizeof(size_t));
+    if (!ix->samples) {
+        free(ix->counts);
+        return -ENOMEM;
+    }
+    for (size_t j = 0, b = 0; j < nsamples; j++) {
+        while (b + 1 < ix->blocks && ix->counts[2 * (b + 1)] <= j * BITMAP_SELECT_SAMPLE) b++;
+        ix->samples[j] = b;
+    }
+    return 0;
+}
+
+static inline void bitmap_index_destroy(struct bitmap_index *ix) {
+    free(ix->counts);
+    free(ix->samples);
+    ix->counts = NULL;
+    ix->samples = NULL;
+}
+
+// Ones in bits [0, i), i <= nbits
+static inline size_t bitmap_rank(const struct bitmap_index *ix, size_t i) {
+    size_t word = i / 64, block = word / 8, w = word % 8;
+    size_t r = ix->counts[2 * block];
+    if (w) r += (ix->counts[2 * block + 1] >> (9 * (w - 1))) & 0x1FF;
+    if (i % 64) r += bit_popcount64(ix->bits[word] & ((1ull << (i % 64)) - 1));
+    return r;
+}
+
+// Position of the k-th one (k counted from 0); nbits when k >= ones
+static inline size_t bitmap_select(const struct bitmap_index *ix, size_t k) {
+    if (k >= ix->ones) return ix->nbits;
+    size_t j = k / BITMAP_SELECT_SAMPLE;
+    size_t lo = ix->samples[j];
+    size_t hi = j + 1 < ix->nsamples ? ix->samples[j + 1] + 1 : ix->blocks;
+    // Last block in [lo, hi) whose count of earlier ones is <= k
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ix->counts[2 * mid] <= k) lo = mid;
+        else hi = mid;
+    }
+    k -= ix->counts[2 * lo];
+    uint64_t packed = ix->counts[2 * lo + 1];
+    size_t w = 0;
+    while (w < 7 && ((packed >> (9 * w)) & 0x1FF) <= k) w++;
+    if (w) k -= (packed >> (9 * (w - 1))) & 0x1FF;
+    return 512 * lo + 64 * w + bit_select64(ix->bits[8 * lo + w], (unsigned)k);
+}
+
+#endif // BIT_OPS_H
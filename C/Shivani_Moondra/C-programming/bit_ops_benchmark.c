@@ -0,0 +1,332 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bit_ops.h"
+#include "../../bench_harness.h"
+
+/* bit_ops.h against the loops of this directory's programs, over arrays of 16 KiB to 64 MiB:
+   - popcount/...: loop ("check number of set bit", per 32-bit word), swar, harley_seal, popcnt,
+     avx2,
+   - reverse/...: div ("Reversing the bits of a number": digits by % 2 into an array), masks, avx2,
+   - nibble/...: loop ("Swap nibble", per byte), swar, avx2,
+   - swap_bits/...: loop ("SWAP TWO BIT.c", bits 0 and 1), avx2,
+   - pow2/...: loop ("n is power of 2": count the set bits, one means yes), mask, avx2,
+   - rank/... and select/...: random queries, scan (popcount of every word before) vs index.
+   Every version is first checked against the original loop on random data and lengths.
+   Usage: ./bit_ops_benchmark [max_bytes] [bench_harness options]   (default 64 MiB) */
+
+/* ---------------- the original programs, one value at a time ---------------- */
+
+static int set_bits_loop(uint32_t n) {
+    int a = 0;
+    while (n) {
+        if (n & 1) a++;
+        n >>= 1;
+    }
+    return a;
+}
+
+static uint32_t reverse_div(uint32_t n) {
+    int arr[32] = {0}; // The original callocs this array on every call
+    int i = 31;
+    while (n != 0) {
+        arr[i] = n % 2;
+        n /= 2;
+        i--;
+    }
+    uint32_t r = 0; // Printed from arr[31] down: the lowest bit comes first
+    for (int j = 0; j <= 31; j++) r = r << 1 | (uint32_t)arr[31 - j];
+    return r;
+}
+
+static uint8_t nibble_swap_one(uint8_t n) {
+    int a = n, b = n;
+    a <<= 4;
+    b >>= 4;
+    return (uint8_t)(a | b);
+}
+
+static uint32_t swap_two_bit(uint32_t data) {
+    uint32_t bit_1 = data & 1, bit_2 = (data >> 1) & 1;
+    uint32_t xor_of_bit = bit_1 ^ bit_2;
+    return data ^ (xor_of_bit | xor_of_bit << 1);
+}
+
+static int power_of_two_loop(uint32_t n) {
+    int count = 0;
+    while (n) {
+        if (n & 1) count++;
+        n >>= 1;
+    }
+    return count == 1;
+}
+
+/* ---------------- array versions of them ---------------- */
+
+static uint64_t popcount_loop(const uint64_t *w, size_t n) {
+    const uint32_t *half = (const uint32_t *)(const void *)w;
+    uint64_t total = 0;
+    for (size_t i = 0; i < 2 * n; i++) total += (uint64_t)set_bits_loop(half[i]);
+    return total;
+}
+
+static uint64_t popcount_swar(const uint64_t *w, size_t n) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; i++) total += bit_popcount64_swar(w[i]);
+    return total;
+}
+
+static void reverse_div_array(uint32_t *dst, const uint32_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = reverse_div(src[i]);
+}
+
+static void nibble_loop(uint8_t *dst, const uint8_t *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = nibble_swap_one(src[i]);
+}
+
+static void swap_two_bit_loop(uint32_t *dst, const uint32_t *src, size_t n, unsigned i, unsigned j) {
+    (void)i, (void)j; // The original always swaps bits 0 and 1
+    for (size_t k = 0; k < n; k++) dst[k] = swap_two_bit(src[k]);
+}
+
+static size_t pow2_loop(const uint32_t *a, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (size_t)power_of_two_loop(a[i]);
+    return count;
+}
+
+static size_t rank_scan(const uint64_t *w, size_t i) {
+    size_t r = 0;
+    for (size_t k = 0; k < i / 64; k++) r += bit_popcount64(w[k]);
+    if (i % 64) r += bit_popcount64(w[i / 64] & ((1ull << (i % 64)) - 1));
+    return r;
+}
+
+static size_t select_scan(const uint64_t *w, size_t nwords, size_t k) {
+    for (size_t i = 0; i < nwords; i++) {
+        size_t c = bit_popcount64(w[i]);
+        if (k < c) return 64 * i + bit_select64(w[i], (unsigned)k);
+        k -= c;
+    }
+    return 64 * nwords;
+}
+
+/* ---------------- variants ---------------- */
+
+enum { OP_POPCOUNT, OP_REVERSE, OP_NIBBLE, OP_SWAP_BITS, OP_POW2 };
+
+struct variant {
+    const char *name;
+    int op;
+    void *fn;
+};
+
+typedef uint64_t (*popcount_fn)(const uint64_t *, size_t);
+typedef void (*reverse_fn)(uint32_t *, const uint32_t *, size_t);
+typedef void (*nibble_fn)(uint8_t *, const uint8_t *, size_t);
+typedef void (*swap_fn)(uint32_t *, const uint32_t *, size_t, unsigned, unsigned);
+typedef size_t (*pow2_fn)(const uint32_t *, size_t);
+
+struct bits_job {
+    const struct variant *v;
+    void *src;
+    void *dst;
+    size_t bytes;
+};
+
+// Runs v over 'bytes' bytes of src; returns a result to compare or to keep alive
+static uint64_t run_variant(const struct variant *v, void *dst, const void *src, size_t bytes) {
+    switch (v->op) {
+    case OP_POPCOUNT: return ((popcount_fn)v->fn)(src, bytes / 8);
+    case OP_REVERSE: ((reverse_fn)v->fn)(dst, src, bytes / 4); return 0;
+    case OP_NIBBLE: ((nibble_fn)v->fn)(dst, src, bytes); return 0;
+    case OP_SWAP_BITS: ((swap_fn)v->fn)(dst, src, bytes / 4, 0, 1); return 0;
+    default: return ((pow2_fn)v->fn)(src, bytes / 4);
+    }
+}
+
+static void bench_bits(void *ctx, uint64_t iters) {
+    struct bits_job *job = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        uint64_t r = run_variant(job->v, job->dst, job->src, job->bytes);
+        BENCH_DO_NOT_OPTIMIZE(r);
+        BENCH_CLOBBER_MEMORY();
+    }
+}
+
+struct query_job {
+    const struct bitmap_index *ix;
+    const uint64_t *queries;
+    size_t count;
+    int select;
+    int scan;
+};
+
+static void bench_queries(void *ctx, uint64_t iters) {
+    struct query_job *job = ctx;
+    size_t k = 0, sum = 0;
+    for (uint64_t i = 0; i < iters; ++i) {
+        size_t q = job->queries[k];
+        if (job->scan)
+            sum += job->select ? select_scan(job->ix->bits, (job->ix->nbits + 63) / 64, q) : rank_scan(job->ix->bits, q);
+        else
+            sum += job->select ? bitmap_select(job->ix, q) : bitmap_rank(job->ix, q);
+        if (++k == job->count) k = 0;
+    }
+    BENCH_DO_NOT_OPTIMIZE(sum);
+}
+
+// Differential check against the first variant of the same operation; returns the number of mismatches
+static int verify(const struct variant *v, const struct variant *reference) {
+    enum { SIZE = 1 << 16 };
+    static uint64_t src[SIZE / 8], expect[SIZE / 8], got[SIZE / 8];
+    uint64_t rng = 13;
+    int bad = 0;
+    for (int round = 0; round < 300; ++round) {
+        size_t bytes = (size_t)(bench_next_random(&rng) % (round % 3 ? 200 : SIZE)) & ~(size_t)7;
+        for (size_t i = 0; i < SIZE / 8; ++i) {
+            uint64_t r = bench_next_random(&rng);
+            // Dense, sparse and powers of two
+            src[i] = round % 4 == 1 ? r & bench_next_random(&rng) & bench_next_random(&rng) : round % 4 == 2 ? 1ull << (r % 64) : r;
+        }
+        memset(expect, 0, sizeof(expect));
+        memset(got, 0, sizeof(got));
+        uint64_t a = run_variant(reference, expect, src, bytes);
+        uint64_t b = run_variant(v, got, src, bytes);
+        if (a != b || memcmp(expect, got, sizeof(got)) != 0) ++bad;
+    }
+    return bad;
+}
+
+static int verify_index(void) {
+    uint64_t rng = 17;
+    int bad = 0;
+    for (int round = 0; round < 100000; ++round) {
+        uint64_t x = bench_next_random(&rng);
+        if (round % 2) x &= bench_next_random(&rng) & bench_next_random(&rng);
+        unsigned c = (unsigned)bit_popcount64(x);
+        for (unsigned k = 0; k < c; ++k) {
+            unsigned pos = bit_select64_swar(x, k);
+            bad += pos > 63 || !(x >> pos & 1) || bit_popcount64(x & ((2ull << pos) - 1)) != k + 1;
+#if BIT_OPS_X86
+            if (bit_ops_have_bmi2) bad += bit_select64_bmi2(x, k) != pos;
+#endif
+        }
+    }
+    for (int round = 0; round < 40; ++round) {
+        size_t nbits = 1 + (size_t)(bench_next_random(&rng) % (round % 2 ? 5000 : 300000));
+        size_t nwords = (nbits + 63) / 64;
+        uint64_t *w = malloc(nwords * 8);
+        for (size_t i = 0; i < nwords; ++i) {
+            uint64_t r = bench_next_random(&rng);
+            w[i] = round % 3 == 0 ? r : round % 3 == 1 ? r & bench_next_random(&rng) & bench_next_random(&rng) : ~(r & bench_next_random(&rng));
+        }
+        if (nbits % 64) w[nwords - 1] &= (1ull << (nbits % 64)) - 1; // The scans read whole words
+        struct bitmap_index ix;
+        if (bitmap_index_init(&ix, w, nbits) != 0) return 1;
+        bad += ix.ones != rank_scan(w, nbits);
+        for (int q = 0; q < 2000; ++q) {
+            size_t i = (size_t)(bench_next_random(&rng) % (nbits + 1));
+            bad += bitmap_rank(&ix, i) != rank_scan(w, i);
+            if (ix.ones) {
+                size_t k = (size_t)(bench_next_random(&rng) % ix.ones);
+                size_t pos = bitmap_select(&ix, k);
+                bad += pos != select_scan(w, nwords, k) || bitmap_rank(&ix, pos) != k;
+            }
+        }
+        bad += bitmap_select(&ix, ix.ones) != nbits;
+        bitmap_index_destroy(&ix);
+        free(w);
+    }
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    size_t max_bytes = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : ((size_t)64 << 20);
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    struct variant variants[20];
+    int count = 0;
+    variants[count++] = (struct variant){"popcount/loop", OP_POPCOUNT, (void *)popcount_loop};
+    variants[count++] = (struct variant){"popcount/swar", OP_POPCOUNT, (void *)popcount_swar};
+    variants[count++] = (struct variant){"popcount/harley_seal", OP_POPCOUNT, (void *)bits_popcount_harley_seal};
+#if BIT_OPS_X86
+    if (__builtin_cpu_supports("popcnt"))
+        variants[count++] = (struct variant){"popcount/popcnt", OP_POPCOUNT, (void *)bits_popcount_popcnt};
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+        variants[count++] = (struct variant){"popcount/avx2", OP_POPCOUNT, (void *)bits_popcount_avx2};
+#endif
+    variants[count++] = (struct variant){"reverse/div", OP_REVERSE, (void *)reverse_div_array};
+    variants[count++] = (struct variant){"reverse/masks", OP_REVERSE, (void *)bits_reverse_u32_scalar};
+    variants[count++] = (struct variant){"nibble/loop", OP_NIBBLE, (void *)nibble_loop};
+    variants[count++] = (struct variant){"nibble/swar", OP_NIBBLE, (void *)bits_nibble_swap_swar};
+    variants[count++] = (struct variant){"swap_bits/loop", OP_SWAP_BITS, (void *)swap_two_bit_loop};
+    variants[count++] = (struct variant){"swap_bits/masks", OP_SWAP_BITS, (void *)bits_swap_pair_scalar};
+    variants[count++] = (struct variant){"pow2/loop", OP_POW2, (void *)pow2_loop};
+    variants[count++] = (struct variant){"pow2/mask", OP_POW2, (void *)bits_count_powers_of_two_scalar};
+#if BIT_OPS_X86
+    if (__builtin_cpu_supports("avx2")) {
+        variants[count++] = (struct variant){"reverse/avx2", OP_REVERSE, (void *)bits_reverse_u32_avx2};
+        variants[count++] = (struct variant){"nibble/avx2", OP_NIBBLE, (void *)bits_nibble_swap_avx2};
+        variants[count++] = (struct variant){"swap_bits/avx2", OP_SWAP_BITS, (void *)bits_swap_pair_avx2};
+        variants[count++] = (struct variant){"pow2/avx2", OP_POW2, (void *)bits_count_powers_of_two_avx2};
+    }
+#endif
+
+    int failures = 0;
+    for (int v = 0; v < count; ++v) {
+        const struct variant *reference = variants;
+        while (reference->op != variants[v].op) ++reference;
+        if (reference == &variants[v]) continue;
+        int bad = verify(&variants[v], reference);
+        failures += bad;
+        printf("check %-22s %s\n", variants[v].name, bad ? "MISMATCH" : "ok");
+    }
+    int bad = verify_index();
+    failures += bad;
+    printf("check %-22s %s\n", "rank/select", bad ? "MISMATCH" : "ok");
+    printf("dispatch: %s, select with %s\n\n", bit_ops_isa(), bit_ops_have_bmi2 ? "pdep" : "swar");
+
+    uint64_t rng = 21;
+    size_t buffer_bytes = (max_bytes + 4095) & ~(size_t)4095;
+    uint64_t *src = aligned_alloc(4096, buffer_bytes);
+    uint64_t *dst = aligned_alloc(4096, buffer_bytes);
+    if (!src || !dst) return 1;
+    for (size_t i = 0; i < buffer_bytes / 8; ++i) src[i] = bench_next_random(&rng);
+    memset(dst, 0, buffer_bytes);
+
+    enum { QUERIES = 1 << 16 };
+    static uint64_t rank_queries[QUERIES], select_queries[QUERIES];
+    char name[64];
+    for (size_t bytes = 16384; bytes <= max_bytes; bytes *= 64) {
+        for (int op = OP_POPCOUNT; op <= OP_POW2; ++op) {
+            for (int v = 0; v < count; ++v) {
+                if (variants[v].op != op) continue;
+                struct bits_job job = {&variants[v], src, dst, bytes};
+                snprintf(name, sizeof(name), "%s/%zu", variants[v].name, bytes);
+                bench_set_bytes(bench_run(&session, name, bench_bits, &job), (double)bytes);
+            }
+        }
+
+        struct bitmap_index ix;
+        if (bitmap_index_init(&ix, src, bytes * 8) != 0) return 1;
+        for (size_t q = 0; q < QUERIES; ++q) {
+            rank_queries[q] = bench_next_random(&rng) % (bytes * 8);
+            select_queries[q] = bench_next_random(&rng) % ix.ones;
+        }
+        for (int select = 0; select < 2; ++select) {
+            for (int scan = 1; scan >= 0; --scan) {
+                struct query_job job = {&ix, select ? select_queries : rank_queries, QUERIES, select, scan};
+                snprintf(name, sizeof(name), "%s/%s/%zu", select ? "select" : "rank", scan ? "scan" : "index", bytes);
+                bench_set_items(bench_run(&session, name, bench_queries, &job), 1);
+            }
+        }
+        bitmap_index_destroy(&ix);
+    }
+
+    free(src);
+    free(dst);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
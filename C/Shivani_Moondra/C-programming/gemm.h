@@ -0,0 +1,312 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#else
+#define GEMM_X86 0
+#endif
+
+/* Matrix multiplication for "matrix multiplication" and "matrix-is-orthogonal-or-not", of any
+   size, row-major:
+       gemm_f32(flags, m, n, k, a, lda, b, ldb, c, ldc)     C = op(A) op(B), m x n, float
+       gemm_f64(...), gemm_i32(...)                         double, int32_t (wrapping)
+   op(A) is m x k and op(B) k x n; GEMM_TRANSPOSE_A / GEMM_TRANSPOSE_B in flags read A or B
+   transposed (A is then stored k x m). lda, ldb and ldc are the row strides of the arrays as
+   stored. Returns 0 (at once when m or n is 0), or -ENOMEM.
+   - Goto / BLIS blocking: B is cut into KC x NC panels (in L3) and A into MC x KC blocks (in
+     L2). Both are packed first: A into slivers of MR rows and B into slivers of NR columns,
+     laid out in the order the micro-kernel reads them and padded with zeros, so the kernel
+     streams both with unit stride and never tests for edges. The MR x NR micro-kernel keeps
+     its tile of C in registers for the whole of KC: with AVX2 / FMA, 6 x 16 floats or int32
+     and 6 x 8 doubles are twelve 256-bit accumulators, enough independent chains to keep
+     both FMA units busy, and each k step is two loads of B, six broadcasts of A and twelve
+     FMAs. Tiles at the edges of C go through a small buffer.
+   - Threads split the rows of C: each one packs its own copy of the B panels and runs the
+     same loops over its rows, so there is no synchronisation until the join. Products under
+     GEMM_THREAD_FLOPS run on the calling thread. gemm_set_threads() changes the count,
+     by default the number of online CPUs.
+   Versions are picked once at startup from cpuid (AVX2 and FMA > scalar); gemm_isa() names
+   the choice. The thread count and kernel pointers are static variables: gemm_set_threads()
+   only affects the calls made from the file that calls it.
+*/
+
+#define GEMM_TRANSPOSE_A 1
+#define GEMM_TRANSPOSE_B 2
+
+#define GEMM_MR 6
+#define GEMM_KC 256
+#define GEMM_MC 144                        // Multiple of GEMM_MR
+#define GEMM_NC 3072                       // Multiple of every NR
+#define GEMM_MAX_THREADS 64
+#define GEMM_THREAD_FLOPS (4.0 * 1024 * 1024) // About 100 us of work
+
+// Rows m0..m1 of C for one thread; pointers are of the element type
+struct gemm_job {
+    const void *a, *b;
+    void *c;
+    size_t m0, m1, n, k;
+    size_t a_rs, a_cs, b_rs, b_cs, ldc; // Row and column strides of op(A) and op(B)
+    int status;
+};
+
+static int gemm_thread_count = 1;
+
+static inline size_t gemm_round_up(size_t x, size_t to) {
+    return (x + to - 1) / to * to;
+}
+
+static inline size_t gemm_min(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+/* ---------------- one element type ---------------- */
+
+/* Defines, for element type T computed in U (unsigned for integers, so that overflow wraps)
+   and NR columns per micro-kernel:
+       gemm_kernel_NAME_scalar     MR x NR tile of C = (or +=) packed A sliver * packed B sliver
+       gemm_kernel_NAME            pointer to the kernel in use
+       gemm_pack_a_NAME, gemm_pack_b_NAME, gemm_block_NAME, gemm_rows_NAME (thread body) */
+#define GEMM_DEFINE(NAME, T, U, NR)                                                                        \
+    static void gemm_kernel_##NAME##_scalar(size_t kc, const T *a, const T *b, T *c, size_t ldc,           \
+                                            int accumulate) {                                              \
+        U ab[GEMM_MR][NR] = {{0}};                                                                         \
+        for (size_t p = 0; p < kc; p++, a += GEMM_MR, b += NR)                                             \
+            for (int i = 0; i < GEMM_MR; i++)                                                              \
+                for (int j = 0; j < NR; j++) ab[i][j] += (U)a[i] * (U)b[j];                                \
+        for (int i = 0; i < GEMM_MR; i++)                                                                  \
+            for (int j = 0; j < NR; j++)                                                                   \
+                c[i * ldc + j] = (T)(accumulate ? (U)c[i * ldc + j] + ab[i][j] : ab[i][j]);                \
+    }                                                                                                      \
+                                                                                                           \
+    static void (*gemm_kernel_##NAME)(size_t, const T *, const T *, T *, size_t, int) =                    \
+        gemm_kernel_##NAME##_scalar;                                                                       \
+                                                                                                           \
+    /* mc x kc of op(A) into MR-row slivers: for each k, MR consecutive values */                         \
+    static void gemm_pack_a_##NAME(const T *a, size_t rs, size_t cs, size_t mc, size_t kc, T *dst) {       \
+        for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR) {                                                      \
+            size_t rows = gemm_min(GEMM_MR, mc - i0);                                                      \
+            for (size_t p = 0; p < kc; p++) {                                                              \
+                size_t i = 0;                                                                              \
+                for (; i < rows; i++) *dst++ = a[(i0 + i) * rs + p * cs];                                  \
+                for (; i < GEMM_MR; i++) *dst++ = 0;                                                       \
+            }                                                                                              \
+        }                                                                                                  \
+    }                                                                                                      \
+                                                                                                           \
+    /* kc x nc of op(B) into NR-column slivers: for each k, NR consecutive values */                      \
+    static void gemm_pack_b_##NAME(const T *b, size_t rs, size_t cs, size_t kc, size_t nc, T *dst) {       \
+        for (size_t j0 = 0; j0 < nc; j0 += NR) {                                                           \
+            size_t cols = gemm_min(NR, nc - j0);                                                           \
+            for (size_t p = 0; p < kc; p++) {                                                              \
+                const T *row = b + p * rs + j0 * cs;                                                       \
+                size_t j = 0;                                                                              \
+                if (cs == 1)                                                                               \
+                    for (; j < cols; j++) *dst++ = row[j];                                                 \
+                else                                                                                       \
+                    for (; j < cols; j++) *dst++ = row[j * cs];                                            \
+                for (; j < NR; j++) *dst++ = 0;                                                            \
+            }                                                                                              \
+        }                                                                                                  \
+    }                                                                                                      \
+                                                                                                           \
+    /* C (mc x nc) = or += packed A block * packed B panel */                                             \
+    static void gemm_block_##NAME(size_t mc, size_t nc, size_t kc, const T *pa, const T *pb, T *c,         \
+                                  size_t ldc, int accumulate) {                                            \
+        T tile[GEMM_MR * NR] __attribute__((aligned(64)));                                                 \
+        for (size_t j = 0; j < nc; j += NR) {                                                              \
+            for (size_t i = 0; i < mc; i += GEMM_MR) {                                                     \
+                const T *a = pa + i * kc, *b = pb + j * kc;                                                \
+                T *ct = c + i * ldc + j;                                                                   \
+                if (i + GEMM_MR <= mc && j + NR <= nc) {                                                   \
+                    gemm_kernel_##NAME(kc, a, b, ct, ldc, accumulate);                                     \
+                    continue;                                                                              \
+                }                                                                                          \
+                gemm_kernel_##NAME(kc, a, b, tile, NR, 0);                                                 \
+                size_t rows = gemm_min(GEMM_MR, mc - i), cols = gemm_min(NR, nc - j);                      \
+                for (size_t r = 0; r < rows; r++)                                                          \
+                    for (size_t s = 0; s < cols; s++)                                                      \
+                        ct[r * ldc + s] =                                                                  \
+                            (T)(accumulate ? (U)ct[r * ldc + s] + (U)tile[r * NR + s] : (U)tile[r * NR + s]); \
+            }                                                                                              \
+        }                                                                                                  \
+    }                                                                                                      \
+                                                                                                           \
+    static void *gemm_rows_##NAME(void *arg) {                                                             \
+        struct gemm_job *job = arg;                                                                        \
+        const T *a = job->a, *b = job->b;                                                                  \
+        T *c = job->c;                                                                                     \
+        size_t rows = job->m1 - job->m0;                                                                   \
+        if (rows == 0) return NULL;                                                                        \
+        if (job->k == 0) {                                                                                 \
+            for (size_t i = job->m0; i < job->m1; i++) memset(c + i * job->ldc, 0, job->n * sizeof(T));   \
+            return NULL;                                                                                   \
+        }                                                                                                  \
+        size_t kc_max = gemm_min(GEMM_KC, job->k);                                                         \
+        size_t mc_max = gemm_min(GEMM_MC, gemm_round_up(rows, GEMM_MR));                                   \
+        size_t nc_max = gemm_min(GEMM_NC, gemm_round_up(job->n, NR));                                      \
+        T *pa = aligned_alloc(64, gemm_round_up(mc_max * kc_max * sizeof(T), 64));                         \
+        T *pb = aligned_alloc(64, gemm_round_up(kc_max * nc_max * sizeof(T), 64));                         \
+        if (!pa || !pb) {                                                                                  \
+            free(pa);                                                                                      \
+            free(pb);                                                                                      \
+            job->status = -ENOMEM;                                                                         \
+            return NULL;                                                                                   \
+        }                                                                                                  \
+        for (size_t jc = 0; jc < job->n; jc += GEMM_NC) {                                                  \
+            size_t nc = gemm_min(GEMM_NC, job->n - jc);                                                    \
+            for (size_t pc = 0; pc < job->k; pc += GEMM_KC) {                                              \
+                size_t kc = gemm_min(GEMM_KC, job->k - pc);                                                \
+                gemm_pack_b_##NAME(b + pc * job->b_rs + jc * job->b_cs, job->b_rs, job->b_cs, kc, nc, pb); \
+                for (size_t ic = job->m0; ic < job->m1; ic += GEMM_MC) {                                   \
+                    size_t mc = gemm_min(GEMM_MC, job->m1 - ic);                                           \
+                    gemm_pack_a_##NAME(a + ic * job->a_rs + pc * job->a_cs, job->a_rs, job->a_cs, mc, kc, pa); \
+                    gemm_block_##NAME(mc, nc, kc, pa, pb, c + ic * job->ldc + jc, job->ldc, pc != 0);      \
+                }                                                                                          \
+            }                                                                                              \
+        }                                                                                                  \
+        free(pa);                                                                                          \
+        free(pb);                                                                                          \
+        return NULL;                                                                                       \
+    }
+
+GEMM_DEFINE(f32, float, float, 16)
+GEMM_DEFINE(f64, double, double, 8)
+GEMM_DEFINE(i32, int32_t, uint32_t, 16)
+
+/* ---------------- avx2 / fma micro-kernels ---------------- */
+
+#if GEMM_X86
+// 6 rows x 2 vectors of C: each k step broadcasts a[i] and multiplies it into both vectors of row i
+#define GEMM_AVX2_KERNEL(NAME, T, V, TARGET, ZERO, LOAD, LOADU, STOREU, BROADCAST, MADD, ADD)              \
+    __attribute__((target(TARGET))) static void gemm_kernel_##NAME##_avx2(                                 \
+        size_t kc, const T *a, const T *b, T *c, size_t ldc, int accumulate) {                            \
+        const size_t w = sizeof(V) / sizeof(T);                                                            \
+        V c00 = ZERO(), c01 = ZERO(), c10 = ZERO(), c11 = ZERO(), c20 = ZERO(), c21 = ZERO();              \
+        V c30 = ZERO(), c31 = ZERO(), c40 = ZERO(), c41 = ZERO(), c50 = ZERO(), c51 = ZERO();              \
+        for (size_t p = 0; p < kc; p++, a += GEMM_MR, b += 2 * w) {                                        \
+            V b0 = LOAD(b), b1 = LOAD(b + w), x;                                                           \
+            x = BROADCAST(a + 0), c00 = MADD(x, b0, c00), c01 = MADD(x, b1, c01);                          \
+            x = BROADCAST(a + 1), c10 = MADD(x, b0, c10), c11 = MADD(x, b1, c11);                          \
+            x = BROADCAST(a + 2), c20 = MADD(x, b0, c20), c21 = MADD(x, b1, c21);                          \
+            x = BROADCAST(a + 3), c30 = MADD(x, b0, c30), c31 = MADD(x, b1, c31);                          \
+            x = BROADCAST(a + 4), c40 = MADD(x, b0, c40), c41 = MADD(x, b1, c41);                          \
+            x = BROADCAST(a + 5), c50 = MADD(x, b0, c50), c51 = MADD(x, b1, c51);                          \
+        }                                                                                                  \
+        V rows[GEMM_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};     \
+        for (int i = 0; i < GEMM_MR; i++, c += ldc) {                                                      \
+            if (accumulate) {                                                                              \
+                rows[i][0] = ADD(rows[i][0], LOADU(c));                                                    \
+                rows[i][1] = ADD(rows[i][1], LOADU(c + w));                                                \
+            }                                                                                              \
+            STOREU(c, rows[i][0]);                                                                         \
+            STOREU(c + w, rows[i][1]);                                                                     \
+        }                                                                                                  \
+    }
+
+#define GEMM_I32_LOAD(p) _mm256_load_si256((const __m256i *)(const void *)(p))
+#define GEMM_I32_LOADU(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define GEMM_I32_STOREU(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#define GEMM_I32_BROADCAST(p) _mm256_set1_epi32(*(p))
+#define GEMM_I32_MADD(x, y, acc) _mm256_add_epi32(acc, _mm256_mullo_epi32(x, y))
+
+GEMM_AVX2_KERNEL(f32, float, __m256, "avx2,fma", _mm256_setzero_ps, _mm256_load_ps, _mm256_loadu_ps,
+                 _mm256_storeu_ps, _mm256_broadcast_ss, _mm256_fmadd_ps, _mm256_add_ps)
+GEMM_AVX2_KERNEL(f64, double, __m256d, "avx2,fma", _mm256_setzero_pd, _mm256_load_pd, _mm256_loadu_pd,
+                 _mm256_storeu_pd, _mm256_broadcast_sd, _mm256_fmadd_pd, _mm256_add_pd)
+GEMM_AVX2_KERNEL(i32, int32_t, __m256i, "avx2", _mm256_setzero_si256, GEMM_I32_LOAD, GEMM_I32_LOADU,
+                 GEMM_I32_STOREU, GEMM_I32_BROADCAST, GEMM_I32_MADD, _mm256_add_epi32)
+#endif
+
+/* ---------------- dispatch ---------------- */
+
+static const char *gemm_impl_name = "scalar";
+
+// Constructor: one thread per online CPU, and the AVX2 kernels only when FMA is there too
+__attribute__((constructor)) static void gemm_select(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    gemm_thread_count = cpus < 1 ? 1 : cpus > GEMM_MAX_THREADS ? GEMM_MAX_THREADS : (int)cpus;
+#if GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        gemm_kernel_f32 = gemm_kernel_f32_avx2;
+        gemm_kernel_f64 = gemm_kernel_f64_avx2;
+        gemm_kernel_i32 = gemm_kernel_i32_avx2;
+        gemm_impl_name = "avx2+fma";
+    }
+#endif
+}
+
+static inline void gemm_set_threads(int threads) {
+    gemm_thread_count = threads < 1 ? 1 : threads > GEMM_MAX_THREADS ? GEMM_MAX_THREADS : threads;
+}
+
+// Splits the rows of C in runs of whole MR slivers; a thread that cannot start runs on the caller
+static inline int gemm_run(const struct gemm_job *whole, size_t m, void *(*rows)(void *)) {
+    if (m == 0 || whole->n == 0) return 0; // Empty C: nothing to compute, and no zero-byte packing buffers
+    struct gemm_job jobs[GEMM_MAX_THREADS];
+    pthread_t threads[GEMM_MAX_THREADS];
+    int started[GEMM_MAX_THREADS] = {0};
+    double flops = 2.0 * (double)m * (double)whole->n * (double)whole->k;
+    size_t count = flops < GEMM_THREAD_FLOPS ? 1 : (size_t)gemm_thread_count;
+    count = gemm_min(count, (m + GEMM_MR - 1) / GEMM_MR);
+    if (count == 0) count = 1;
+    size_t per = gemm_round_up((m + count - 1) / count, GEMM_MR);
+    for (size_t t = 0; t < count; t++) {
+        jobs[t] = *whole;
+        jobs[t].m0 = gemm_min(t * per, m);
+        jobs[t].m1 = gemm_min(jobs[t].m0 + per, m);
+        jobs[t].status = 0;
+    }
+    for (size_t t = 1; t < count; t++) started[t] = pthread_create(&threads[t], NULL, rows, &jobs[t]) == 0;
+    rows(&jobs[0]);
+    int status = 0;
+    for (size_t t = 0; t < count; t++) {
+        if (t > 0) {
+            if (started[t]) pthread_join(threads[t], NULL);
+            else rows(&jobs[t]);
+        }
+        if (jobs[t].status) status = jobs[t].status;
+    }
+    return status;
+}
+
+static inline struct gemm_job gemm_job(int flags, size_t m, size_t n, size_t k, const void *a, size_t lda,
+                                       const void *b, size_t ldb, void *c, size_t ldc) {
+    struct gemm_job job = {a, b, c, 0, m, n, k, lda, 1, ldb, 1, ldc, 0};
+    if (flags & GEMM_TRANSPOSE_A) job.a_rs = 1, job.a_cs = lda;
+    if (flags & GEMM_TRANSPOSE_B) job.b_rs = 1, job.b_cs = ldb;
+    return job;
+}
+
+static inline int gemm_f32(int flags, size_t m, size_t n, size_t k, const float *a, size_t lda, const float *b,
+                           size_t ldb, float *c, size_t ldc) {
+    struct gemm_job job = gemm_job(flags, m, n, k, a, lda, b, ldb, c, ldc);
+    return gemm_run(&job, m, gemm_rows_f32);
+}
+
+static inline int gemm_f64(int flags, size_t m, size_t n, size_t k, const double *a, size_t lda, const double *b,
+                           size_t ldb, double *c, size_t ldc) {
+    struct gemm_job job = gemm_job(flags, m, n, k, a, lda, b, ldb, c, ldc);
+    return gemm_run(&job, m, gemm_rows_f64);
+}
+
+static inline int gemm_i32(int flags, size_t m, size_t n, size_t k, const int32_t *a, size_t lda,
+                           const int32_t *b, size_t ldb, int32_t *c, size_t ldc) {
+    struct gemm_job job = gemm_job(flags, m, n, k, a, lda, b, ldb, c, ldc);
+    return gemm_run(&job, m, gemm_rows_i32);
+}
+
+static inline const char *gemm_isa(void) {
+    return gemm_impl_name;
+}
+
+#endif // GEMM_H
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gemm.h"
+#include "../../bench_harness.h"
+
+/* gemm.h against the triple loop of "matrix multiplication", for square matrices of 64 to 4096:
+   - f32/..., f64/..., i32/...: naive (dot product of a row of A and a column of B, up to 512),
+     scalar (blocked and packed, portable micro-kernel, up to 1024), gemm (dispatched kernel,
+     all threads), and gemm_1thread when there is more than one CPU.
+   Each result is followed by its GFLOP/s (two operations per multiply-add; --json reports
+   them as Mitems/s). Every version is first checked against the naive loop, exactly: inputs
+   are small integers, so float sums are exact too.
+   Usage: ./gemm_benchmark [max_n] [bench_harness options]   (default 4096) */
+
+enum { F32, F64, I32 };
+static const char *type_names[] = {"f32", "f64", "i32"};
+static const size_t type_sizes[] = {sizeof(float), sizeof(double), sizeof(int32_t)};
+
+#define NAIVE_DEFINE(NAME, T, U)                                                                           \
+    static void naive_##NAME(int flags, size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b,  \
+                             size_t ldb, T *c, size_t ldc) {                                               \
+        for (size_t i = 0; i < m; i++) {                                                                   \
+            for (size_t j = 0; j < n; j++) {                                                               \
+                U sum = 0;                                                                                 \
+                for (size_t p = 0; p < k; p++) {                                                           \
+                    T x = flags & GEMM_TRANSPOSE_A ? a[p * lda + i] : a[i * lda + p];                      \
+                    T y = flags & GEMM_TRANSPOSE_B ? b[j * ldb + p] : b[p * ldb + j];                      \
+                    sum += (U)x * (U)y;                                                                    \
+                }                                                                                          \
+                c[i * ldc + j] = (T)sum;                                                                   \
+            }                                                                                              \
+        }                                                                                                  \
+    }
+
+NAIVE_DEFINE(f32, float, float)
+NAIVE_DEFINE(f64, double, double)
+NAIVE_DEFINE(i32, int32_t, uint32_t)
+
+enum { NAIVE, SCALAR, GEMM, GEMM_1THREAD };
+static const char *kind_names[] = {"naive", "scalar", "gemm", "gemm_1thread"};
+
+// C = op(A) op(B) with the given kind; square operands have leading dimensions n and k
+static int multiply(int type, int kind, int flags, size_t m, size_t n, size_t k, const void *a, size_t lda,
+                    const void *b, size_t ldb, void *c, size_t ldc) {
+    if (kind == NAIVE) {
+        if (type == F32) naive_f32(flags, m, n, k, a, lda, b, ldb, c, ldc);
+        else if (type == F64) naive_f64(flags, m, n, k, a, lda, b, ldb, c, ldc);
+        else naive_i32(flags, m, n, k, a, lda, b, ldb, c, ldc);
+        return 0;
+    }
+    void (*f32_kernel)(size_t, const float *, const float *, float *, size_t, int) = gemm_kernel_f32;
+    void (*f64_kernel)(size_t, const double *, const double *, double *, size_t, int) = gemm_kernel_f64;
+    void (*i32_kernel)(size_t, const int32_t *, const int32_t *, int32_t *, size_t, int) = gemm_kernel_i32;
+    int threads = gemm_thread_count;
+    if (kind == SCALAR) {
+        gemm_kernel_f32 = gemm_kernel_f32_scalar;
+        gemm_kernel_f64 = gemm_kernel_f64_scalar;
+        gemm_kernel_i32 = gemm_kernel_i32_scalar;
+    }
+    if (kind != GEMM) gemm_set_threads(1);
+    int rc = type == F32 ? gemm_f32(flags, m, n, k, a, lda, b, ldb, c, ldc)
+           : type == F64 ? gemm_f64(flags, m, n, k, a, lda, b, ldb, c, ldc)
+                         : gemm_i32(flags, m, n, k, a, lda, b, ldb, c, ldc);
+    gemm_kernel_f32 = f32_kernel;
+    gemm_kernel_f64 = f64_kernel;
+    gemm_kernel_i32 = i32_kernel;
+    gemm_set_threads(threads);
+    return rc;
+}
+
+struct gemm_bench_job {
+    int type, kind;
+    size_t n;
+    const void *a, *b;
+    void *c;
+};
+
+static void bench_gemm(void *ctx, uint64_t iters) {
+    struct gemm_bench_job *job = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        multiply(job->type, job->kind, 0, job->n, job->n, job->n, job->a, job->n, job->b, job->n, job->c, job->n);
+        BENCH_CLOBBER_MEMORY();
+    }
+}
+
+// Small integers (any int32 for i32: products wrap), stored as the element type
+static void fill(int type, void *p, size_t count, uint64_t *rng) {
+    for (size_t i = 0; i < count; ++i) {
+        int32_t v = (int32_t)(bench_next_random(rng) % 17) - 8;
+        if (type == F32) ((float *)p)[i] = (float)v;
+        else if (type == F64) ((double *)p)[i] = (double)v;
+        else ((int32_t *)p)[i] = (int32_t)(uint32_t)bench_next_random(rng);
+    }
+}
+
+// Against the naive loop on shapes around the blocking sizes and empty ones; returns the number of mismatches
+static int verify(int type, int kind) {
+    static const size_t shapes[][3] = {
+        {1, 1, 1},     {6, 16, 1},   {7, 17, 3},   {5, 3, 300},  {13, 9, 257}, {150, 40, 20},
+        {145, 33, 513}, {64, 64, 64}, {200, 130, 90}, {3, 3100, 4}, {31, 7, 0}, {0, 5, 7}, {9, 0, 4},
+    };
+    size_t es = type_sizes[type];
+    uint64_t rng = 31;
+    int bad = 0;
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); ++s) {
+        size_t m = shapes[s][0], n = shapes[s][1], k = shapes[s][2];
+        for (int flags = 0; flags < 4; ++flags) {
+            // Leading dimensions wider than the matrices, to catch stride mix-ups
+            size_t lda = (flags & GEMM_TRANSPOSE_A ? m : k) + 3, ldb = (flags & GEMM_TRANSPOSE_B ? k : n) + 5;
+            size_t ldc = n + 2;
+            size_t a_rows = flags & GEMM_TRANSPOSE_A ? k : m, b_rows = flags & GEMM_TRANSPOSE_B ? n : k;
+            void *a = malloc(a_rows * lda * es + 1), *b = malloc(b_rows * ldb * es + 1);
+            void *c = malloc(m * ldc * es), *expect = malloc(m * ldc * es);
+            fill(type, a, a_rows * lda, &rng);
+            fill(type, b, b_rows * ldb, &rng);
+            fill(type, c, m * ldc, &rng);
+            memcpy(expect, c, m * ldc * es);
+            multiply(type, NAIVE, flags, m, n, k, a, lda, b, ldb, expect, ldc);
+            bad += multiply(type, kind, flags, m, n, k, a, lda, b, ldb, c, ldc) != 0;
+            bad += memcmp(c, expect, m * ldc * es) != 0; // Padding columns included: left untouched
+            free(a);
+            free(b);
+            free(c);
+            free(expect);
+        }
+    }
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    size_t max_n = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : 4096;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+    int cpus = gemm_thread_count;
+
+    int failures = 0;
+    for (int type = F32; type <= I32; ++type) {
+        for (int kind = SCALAR; kind <= GEMM; ++kind) {
+            int bad = verify(type, kind);
+            failures += bad;
+            printf("check %s/%-8s %s\n", type_names[type], kind_names[kind], bad ? "MISMATCH" : "ok");
+        }
+        // Several threads even on one CPU, for the row split
+        gemm_set_threads(3);
+        int bad = verify(type, GEMM);
+        gemm_set_threads(cpus);
+        failures += bad;
+        printf("check %s/%-8s %s\n", type_names[type], "threads", bad ? "MISMATCH" : "ok");
+    }
+    printf("dispatch: %s, %d threads\n\n", gemm_isa(), cpus);
+
+    size_t bytes = max_n * max_n * sizeof(double);
+    void *a = malloc(bytes), *b = malloc(bytes), *c = malloc(bytes);
+    if (!a || !b || !c) return 1;
+    memset(c, 0, bytes);
+
+    char name[64];
+    for (size_t n = 64; n <= max_n; n *= 2) {
+        for (int type = F32; type <= I32; ++type) {
+            uint64_t rng = 37;
+            fill(type, a, n * n, &rng);
+            fill(type, b, n * n, &rng);
+            for (int kind = NAIVE; kind <= GEMM_1THREAD; ++kind) {
+                if ((kind == NAIVE && n > 512) || (kind == SCALAR && n > 1024) || (kind == GEMM_1THREAD && cpus == 1))
+                    continue;
+                struct gemm_bench_job job = {type, kind, n, a, b, c};
+                snprintf(name, sizeof(name), "%s/%s/%zu", type_names[type], kind_names[kind], n);
+                bench_result_t *r = bench_run(&session, name, bench_gemm, &job);
+                double flops = 2.0 * (double)n * (double)n * (double)n;
+                bench_set_items(r, flops);
+                if (r) printf("    %.2f GFLOP/s\n", flops / r->median);
+            }
+        }
+    }
+
+    free(a);
+    free(b);
+    free(c);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
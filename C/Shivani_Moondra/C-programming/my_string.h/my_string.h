@@ -0,0 +1,616 @@
+#ifndef MY_STRING_H
+#define MY_STRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MY_STRING_X86 1
+#else
+#define MY_STRING_X86 0
+#endif
+
+/* The string functions of this directory (strlen.c, strcpy.c, ...) for long strings, with the
+   usual libc semantics:
+       my_strlen  my_strnlen  my_strcpy  my_strncpy  my_strcat  my_strncat  my_strcmp  my_strrchr
+   Four versions of each, called through a table picked once at startup from cpuid
+   (AVX2 > SSE2 > SWAR); my_string_isa() names the choice, and the tables my_string_bytes_ops,
+   my_string_swar_ops, my_string_sse2_ops, my_string_avx2_ops can be used directly.
+   - bytes: the loops of the original programs, one character per iteration.
+   - swar: 8 characters per 64-bit word. A word has a zero byte iff
+     (w - 0x0101..01) & ~w & 0x8080..80 is non-zero; the exact position comes from a borrow-free
+     variant of the same test and a count of trailing (little endian) or leading zero bits.
+   - sse2 / avx2: 16 / 32 characters per compare, movemask turns the result into a bit mask.
+   Reading past the terminator: a scan has to load whole words or vectors, so it reads a few
+   bytes after the '\0' (and strlen, strrchr also before the start). That is harmless as long as
+   no load touches a page the string does not reach, because only whole pages can be unmapped:
+   - scans of one string use aligned loads; an aligned 8/16/32-byte block never spans two pages
+     and holds at least one byte of the string, so it is readable,
+   - strcmp has two strings and can only align one of them: the other is loaded unaligned, and
+     when that load would cross into the next 4 KiB page, that block is compared byte by byte,
+   - strcpy stores exactly the bytes of the string; its last vector is an unaligned copy that
+     ends on the terminator.
+   These functions are excluded from AddressSanitizer, which would report the over-reads.
+   strncpy, strcat and strncat are strlen/strnlen of the chosen version plus memcpy/memset.
+*/
+
+#define MY_STRING_PAGE 4096 // Smallest page size: a load inside one 4 KiB block cannot fault
+#define MY_STRING_OVERREAD __attribute__((no_sanitize_address))
+
+// Unaligned, alias-safe word access; my_string_word is aligned
+typedef uint64_t __attribute__((may_alias)) my_string_word;
+typedef uint64_t __attribute__((may_alias, aligned(1))) my_string_uword;
+
+#define MY_STRING_ONES 0x0101010101010101ull
+#define MY_STRING_HIGHS 0x8080808080808080ull
+#define MY_STRING_LOWS 0x7F7F7F7F7F7F7F7Full
+
+/* ---------------- bytes ---------------- */
+
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline size_t my_strlen_bytes(const char *s) {
+    size_t n = 0;
+    while (s[n] != '\0') n++;
+    return n;
+}
+
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline size_t my_strnlen_bytes(const char *s, size_t n) {
+    size_t i = 0;
+    while (i < n && s[i] != '\0') i++;
+    return i;
+}
+
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline char *my_strcpy_bytes(char *dst, const char *src) {
+    size_t i = 0;
+    while ((dst[i] = src[i]) != '\0') i++;
+    return dst;
+}
+
+// Pads with '\0' up to n and, like strncpy, does not terminate a source of n or more characters
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline char *my_strncpy_bytes(char *dst, const char *src, size_t n) {
+    size_t i = 0;
+    for (; i < n && src[i] != '\0'; i++) dst[i] = src[i];
+    for (; i < n; i++) dst[i] = '\0';
+    return dst;
+}
+
+static inline char *my_strcat_bytes(char *dst, const char *src) {
+    my_strcpy_bytes(dst + my_strlen_bytes(dst), src);
+    return dst;
+}
+
+// Appends at most n characters, always terminates
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static inline char *my_strncat_bytes(char *dst, const char *src, size_t n) {
+    char *d = dst + my_strlen_bytes(dst);
+    size_t i = 0;
+    for (; i < n && src[i] != '\0'; i++) d[i] = src[i];
+    d[i] = '\0';
+    return dst;
+}
+
+static inline int my_strcmp_bytes(const char *a, const char *b) {
+    const unsigned char *p = (const unsigned char *)a, *q = (const unsigned char *)b;
+    while (*p == *q && *p != '\0') {
+        p++;
+        q++;
+    }
+    return *p - *q;
+}
+
+static inline char *my_strrchr_bytes(const char *s, int c) {
+    const char *last = NULL;
+    for (;; s++) {
+        if (*s == (char)c) last = s;
+        if (*s == '\0') return (char *)last;
+    }
+}
+
+/* ---------------- swar ---------------- */
+
+// Non-zero iff some byte of w is zero; may also flag a 0x01 byte above a zero byte
+static inline uint64_t my_string_haszero(uint64_t w) {
+    return (w - MY_STRING_ONES) & ~w & MY_STRING_HIGHS;
+}
+
+// 0x80 in exactly the zero bytes of w (no borrow between bytes)
+static inline uint64_t my_string_zero_bytes(uint64_t w) {
+    return ~(((w & MY_STRING_LOWS) + MY_STRING_LOWS) | w | MY_STRING_LOWS);
+}
+
+// Offset in memory of the first / last byte flagged in a non-zero zero_bytes() mask
+static inline size_t my_string_first_byte(uint64_t mask) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return (size_t)__builtin_ctzll(mask) >> 3;
+#else
+    return (size_t)__builtin_clzll(mask) >> 3;
+#endif
+}
+
+static inline size_t my_string_last_byte(uint64_t mask) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return (size_t)(63 - __builtin_clzll(mask)) >> 3;
+#else
+    return (size_t)__builtin_ctzll(mask) >> 3;
+#endif
+}
+
+// The flags of hits that lie before the first flagged byte of zeros (zeros non-zero)
+static inline uint64_t my_string_before(uint64_t hits, uint64_t zeros) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return hits & (zeros ^ (zeros - 1));
+#else
+    int top = 63 - __builtin_clzll(zeros);
+    return top == 63 ? 0 : hits & (~0ull << (top + 1));
+#endif
+}
+
+MY_STRING_OVERREAD
+static inline size_t my_strlen_swar(const char *s) {
+    const char *p = s;
+    for (; (uintptr_t)p & 7; p++)
+        if (*p == '\0') return (size_t)(p - s);
+    while (!my_string_haszero(*(const my_string_word *)p)) p += 8;
+    return (size_t)(p - s) + my_string_first_byte(my_string_zero_bytes(*(const my_string_word *)p));
+}
+
+MY_STRING_OVERREAD
+static inline size_t my_strnlen_swar(const char *s, size_t n) {
+    const char *p = s;
+    for (; (uintptr_t)p & 7; p++)
+        if ((size_t)(p - s) == n || *p == '\0') return (size_t)(p - s);
+    // A word is read only if it holds one of the first n bytes
+    for (; (size_t)(p - s) < n; p += 8) {
+        uint64_t zeros = my_string_zero_bytes(*(const my_string_word *)p);
+        if (zeros) {
+            size_t len = (size_t)(p - s) + my_string_first_byte(zeros);
+            return len < n ? len : n;
+        }
+    }
+    return n;
+}
+
+MY_STRING_OVERREAD
+static inline char *my_strcpy_swar(char *dst, const char *src) {
+    char *d = dst;
+    const char *s = src;
+    for (; (uintptr_t)s & 7; s++, d++)
+        if ((*d = *s) == '\0') return dst;
+    for (;; s += 8, d += 8) {
+        uint64_t w = *(const my_string_word *)s;
+        if (my_string_haszero(w)) break;
+        *(my_string_uword *)d = w;
+    }
+    while ((*d++ = *s++) != '\0') {}
+    return dst;
+}
+
+MY_STRING_OVERREAD
+static inline int my_strcmp_swar(const char *a, const char *b) {
+    const unsigned char *p = (const unsigned char *)a, *q = (const unsigned char *)b;
+    for (; (uintptr_t)p & 7; p++, q++)
+        if (*p != *q || *p == '\0') return *p - *q;
+    for (;;) {
+        if (((uintptr_t)q & (MY_STRING_PAGE - 1)) <= MY_STRING_PAGE - 8) {
+            uint64_t x = *(const my_string_word *)p, y = *(const my_string_uword *)q;
+            if (x == y && !my_string_haszero(x)) {
+                p += 8;
+                q += 8;
+                continue;
+            }
+        }
+        // The answer is in these 8 bytes, or q's word crosses a page: byte by byte
+        for (int k = 0; k < 8; k++, p++, q++)
+            if (*p != *q || *p == '\0') return *p - *q;
+    }
+}
+
+MY_STRING_OVERREAD
+static inline char *my_strrchr_swar(const char *s, int c) {
+    unsigned char ch = (unsigned char)c;
+    if (ch == '\0') return (char *)s + my_strlen_swar(s);
+    const char *p = s, *last = NULL;
+    for (; (uintptr_t)p & 7; p++) {
+        if ((unsigned char)*p == ch) last = p;
+        if (*p == '\0') return (char *)last;
+    }
+    uint64_t pattern = MY_STRING_ONES * ch;
+    for (;; p += 8) {
+        uint64_t w = *(const my_string_word *)p;
+        uint64_t zeros = my_string_zero_bytes(w), hits = my_string_zero_bytes(w ^ pattern);
+        if (zeros) {
+            hits = my_string_before(hits, zeros);
+            return hits ? (char *)p + my_string_last_byte(hits) : (char *)last;
+        }
+        if (hits) last = p + my_string_last_byte(hits);
+    }
+}
+
+// n <= 32 bytes, all of them inside the source string
+static inline void my_string_copy_short(char *d, const char *s, size_t n) {
+    if (n >= 16) {
+        uint64_t a = *(const my_string_uword *)s, b = *(const my_string_uword *)(s + 8);
+        uint64_t y = *(const my_string_uword *)(s + n - 16), z = *(const my_string_uword *)(s + n - 8);
+        *(my_string_uword *)d = a;
+        *(my_string_uword *)(d + 8) = b;
+        *(my_string_uword *)(d + n - 16) = y;
+        *(my_string_uword *)(d + n - 8) = z;
+    } else if (n >= 8) {
+        uint64_t a = *(const my_string_uword *)s, z = *(const my_string_uword *)(s + n - 8);
+        *(my_string_uword *)d = a;
+        *(my_string_uword *)(d + n - 8) = z;
+    } else if (n >= 4) {
+        uint32_t a, z;
+        memcpy(&a, s, 4);
+        memcpy(&z, s + n - 4, 4);
+        memcpy(d, &a, 4);
+        memcpy(d + n - 4, &z, 4);
+    } else {
+        for (size_t i = 0; i < n; i++) d[i] = s[i];
+    }
+}
+
+/* ---------------- sse2 / avx2 ----------------
+   The bodies below are written once against these names, defined for one instruction set
+   before its functions and undefined after:
+       MY_V               vector type          MY_V_SIZE        its size in bytes
+       MY_V_LOAD(p)       aligned load         MY_V_LOADU(p)    unaligned load
+       MY_V_STOREU(p, v)  unaligned store      MY_V_SET1(c)     c in every byte
+       MY_V_CMPEQ(a, b)   0xFF where equal     MY_V_MIN(a, b)   unsigned byte min
+       MY_V_OR(a, b)      bitwise or           MY_V_MOVEMASK(v) top bit of each byte, as a mask
+       MY_V_ZERO          all zero bytes */
+
+#define MY_V_EQ(a, b) MY_V_MOVEMASK(MY_V_CMPEQ(a, b))
+#define MY_V_ZEROS(v) MY_V_EQ(v, MY_V_ZERO)
+// Bit i set where a[i] is '\0' or differs from b[i]: min(a, a == b ? 0xFF : 0) is 0 exactly there
+#define MY_V_ENDS(a, b) MY_V_MIN(a, MY_V_CMPEQ(a, b))
+#define MY_V_END(a, b) MY_V_ZEROS(MY_V_ENDS(a, b))
+// An unaligned load of 'bytes' at p stays in p's page
+#define MY_V_PAGE_OK_N(p, bytes) (((uintptr_t)(p) & (MY_STRING_PAGE - 1)) <= MY_STRING_PAGE - (bytes))
+#define MY_V_PAGE_OK(p) MY_V_PAGE_OK_N(p, MY_V_SIZE)
+#define MY_V_ALIGN_DOWN(p) ((const char *)((uintptr_t)(p) & ~(uintptr_t)(MY_V_SIZE - 1)))
+
+#define MY_STRLEN_VECTOR_BODY                                                                              \
+    const char *p = MY_V_ALIGN_DOWN(s);                                                                    \
+    uint32_t mask = MY_V_ZEROS(MY_V_LOAD(p)) >> (s - p);                                                   \
+    if (mask) return (size_t)__builtin_ctz(mask);                                                          \
+    for (;;) {                                                                                             \
+        p += MY_V_SIZE;                                                                                    \
+        if (((uintptr_t)p & (4 * MY_V_SIZE - 1)) == 0) break;                                              \
+        mask = MY_V_ZEROS(MY_V_LOAD(p));                                                                   \
+        if (mask) return (size_t)(p - s) + (size_t)__builtin_ctz(mask);                                    \
+    }                                                                                                      \
+    /* p is aligned to four vectors, so the four loads stay in one page */                                 \
+    for (;; p += 4 * MY_V_SIZE) {                                                                          \
+        MY_V a = MY_V_LOAD(p), b = MY_V_LOAD(p + MY_V_SIZE);                                               \
+        MY_V c = MY_V_LOAD(p + 2 * MY_V_SIZE), d = MY_V_LOAD(p + 3 * MY_V_SIZE);                           \
+        if (MY_V_ZEROS(MY_V_MIN(MY_V_MIN(a, b), MY_V_MIN(c, d)))) {                                        \
+            if ((mask = MY_V_ZEROS(a))) return (size_t)(p - s) + (size_t)__builtin_ctz(mask);              \
+            if ((mask = MY_V_ZEROS(b))) return (size_t)(p - s) + MY_V_SIZE + (size_t)__builtin_ctz(mask);  \
+            if ((mask = MY_V_ZEROS(c))) return (size_t)(p - s) + 2 * MY_V_SIZE + (size_t)__builtin_ctz(mask); \
+            mask = MY_V_ZEROS(d);                                                                          \
+            return (size_t)(p - s) + 3 * MY_V_SIZE + (size_t)__builtin_ctz(mask);                          \
+        }                                                                                                  \
+    }
+
+#define MY_STRNLEN_VECTOR_BODY                                                                             \
+    if (n == 0) return 0;                                                                                  \
+    const char *p = MY_V_ALIGN_DOWN(s);                                                                    \
+    uint32_t mask = MY_V_ZEROS(MY_V_LOAD(p)) >> (s - p);                                                   \
+    size_t len;                                                                                            \
+    if (mask) {                                                                                            \
+        len = (size_t)__builtin_ctz(mask);                                                                 \
+        return len < n ? len : n;                                                                          \
+    }                                                                                                      \
+    for (;;) {                                                                                             \
+        p += MY_V_SIZE;                                                                                    \
+        if ((size_t)(p - s) >= n) return n; /* The block holds none of the first n bytes */               \
+        mask = MY_V_ZEROS(MY_V_LOAD(p));                                                                   \
+        if (mask) {                                                                                        \
+            len = (size_t)(p - s) + (size_t)__builtin_ctz(mask);                                           \
+            return len < n ? len : n;                                                                      \
+        }                                                                                                  \
+    }
+
+/* The first vector is loaded unaligned from src when that cannot cross a page (after copying up to
+   the next vector boundary byte by byte otherwise); then aligned source blocks are stored
+   unaligned, overlapping what is already copied, and the last vector copied ends on the '\0'. */
+#define MY_STRCPY_VECTOR_BODY                                                                              \
+    char *d = dst;                                                                                         \
+    const char *s = src;                                                                                   \
+    if (!MY_V_PAGE_OK(s)) {                                                                                \
+        for (; (uintptr_t)s & (MY_V_SIZE - 1); s++, d++)                                                   \
+            if ((*d = *s) == '\0') return dst;                                                             \
+    }                                                                                                      \
+    MY_V v = MY_V_LOADU(s);                                                                                \
+    uint32_t mask = MY_V_ZEROS(v);                                                                         \
+    if (mask) {                                                                                            \
+        my_string_copy_short(d, s, (size_t)__builtin_ctz(mask) + 1);                                       \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    MY_V_STOREU(d, v);                                                                                     \
+    const char *p = MY_V_ALIGN_DOWN(s) + MY_V_SIZE;                                                        \
+    for (;; p += MY_V_SIZE) {                                                                              \
+        v = MY_V_LOAD(p);                                                                                  \
+        mask = MY_V_ZEROS(v);                                                                              \
+        if (mask) break;                                                                                   \
+        MY_V_STOREU(d + (p - s), v);                                                                       \
+    }                                                                                                      \
+    /* At least MY_V_SIZE characters precede the '\0' */                                                   \
+    size_t n = (size_t)(p - s) + (size_t)__builtin_ctz(mask) + 1;                                          \
+    MY_V_STOREU(d + n - MY_V_SIZE, MY_V_LOADU(s + n - MY_V_SIZE));                                         \
+    return dst;
+
+#define MY_STRCMP_VECTOR_BODY                                                                              \
+    const unsigned char *p = (const unsigned char *)a, *q = (const unsigned char *)b;                      \
+    uint32_t mask;                                                                                         \
+    if (MY_V_PAGE_OK(p) && MY_V_PAGE_OK(q)) {                                                              \
+        if ((mask = MY_V_END(MY_V_LOADU(p), MY_V_LOADU(q)))) {                                             \
+            size_t k = (size_t)__builtin_ctz(mask);                                                        \
+            return p[k] - q[k];                                                                            \
+        }                                                                                                  \
+        size_t skip = MY_V_SIZE - ((uintptr_t)p & (MY_V_SIZE - 1));                                        \
+        p += skip;                                                                                         \
+        q += skip;                                                                                         \
+    } else {                                                                                               \
+        for (; (uintptr_t)p & (MY_V_SIZE - 1); p++, q++)                                                   \
+            if (*p != *q || *p == '\0') return *p - *q;                                                    \
+    }                                                                                                      \
+    /* p is aligned; q is loaded unaligned unless that crosses a page. Two vectors per step when p is   \
+       aligned to two (so that both of its loads are in one page). */                                     \
+    for (;;) {                                                                                             \
+        if (((uintptr_t)p & (2 * MY_V_SIZE - 1)) == 0 && MY_V_PAGE_OK_N(q, 2 * MY_V_SIZE)) {               \
+            MY_V a0 = MY_V_LOAD(p), a1 = MY_V_LOAD(p + MY_V_SIZE);                                         \
+            MY_V e0 = MY_V_ENDS(a0, MY_V_LOADU(q)), e1 = MY_V_ENDS(a1, MY_V_LOADU(q + MY_V_SIZE));         \
+            if (!MY_V_ZEROS(MY_V_MIN(e0, e1))) {                                                           \
+                p += 2 * MY_V_SIZE;                                                                        \
+                q += 2 * MY_V_SIZE;                                                                        \
+                continue;                                                                                  \
+            }                                                                                              \
+            mask = MY_V_ZEROS(e0);                                                                         \
+            size_t k = mask ? (size_t)__builtin_ctz(mask) : MY_V_SIZE + (size_t)__builtin_ctz(MY_V_ZEROS(e1)); \
+            return p[k] - q[k];                                                                            \
+        }                                                                                                  \
+        if (MY_V_PAGE_OK(q)) {                                                                             \
+            if ((mask = MY_V_END(MY_V_LOAD(p), MY_V_LOADU(q)))) {                                          \
+                size_t k = (size_t)__builtin_ctz(mask);                                                    \
+                return p[k] - q[k];                                                                        \
+            }                                                                                              \
+            p += MY_V_SIZE;                                                                                \
+            q += MY_V_SIZE;                                                                                \
+        } else {                                                                                           \
+            for (int k = 0; k < MY_V_SIZE; k++, p++, q++)                                                  \
+                if (*p != *q || *p == '\0') return *p - *q;                                                \
+        }                                                                                                  \
+    }
+
+/* c is not '\0'. One vector at a time up to a four-vector boundary, then four per step; a group
+   of four is only resolved to a position when it turns out to hold the last match. */
+#define MY_STRRCHR_VECTOR_BODY                                                                             \
+    const MY_V needle = MY_V_SET1((char)c);                                                                \
+    const char *p = MY_V_ALIGN_DOWN(s), *last = NULL, *last_group = NULL;                                  \
+    MY_V v = MY_V_LOAD(p);                                                                                 \
+    uint32_t keep = ~0u << (s - p);                                                                        \
+    uint32_t zeros = MY_V_ZEROS(v) & keep, hits = MY_V_EQ(v, needle) & keep;                               \
+    for (;;) {                                                                                             \
+        if (zeros) {                                                                                       \
+            hits &= zeros ^ (zeros - 1);                                                                   \
+            return hits ? (char *)p + 31 - __builtin_clz(hits) : (char *)last;                             \
+        }                                                                                                  \
+        if (hits) last = p + 31 - __builtin_clz(hits);                                                     \
+        p += MY_V_SIZE;                                                                                    \
+        if (((uintptr_t)p & (4 * MY_V_SIZE - 1)) == 0) break;                                              \
+        v = MY_V_LOAD(p);                                                                                  \
+        zeros = MY_V_ZEROS(v);                                                                             \
+        hits = MY_V_EQ(v, needle);                                                                         \
+    }                                                                                                      \
+    for (;; p += 4 * MY_V_SIZE) {                                                                          \
+        MY_V a = MY_V_LOAD(p), b = MY_V_LOAD(p + MY_V_SIZE);                                               \
+        MY_V d = MY_V_LOAD(p + 2 * MY_V_SIZE), e = MY_V_LOAD(p + 3 * MY_V_SIZE);                           \
+        if (MY_V_ZEROS(MY_V_MIN(MY_V_MIN(a, b), MY_V_MIN(d, e)))) break;                                   \
+        MY_V found = MY_V_OR(MY_V_OR(MY_V_CMPEQ(a, needle), MY_V_CMPEQ(b, needle)),                        \
+                             MY_V_OR(MY_V_CMPEQ(d, needle), MY_V_CMPEQ(e, needle)));                       \
+        if (MY_V_MOVEMASK(found)) last_group = p;                                                          \
+    }                                                                                                      \
+    /* The terminator is in the group at p */                                                              \
+    const char *in_group = NULL;                                                                           \
+    for (;; p += MY_V_SIZE) {                                                                              \
+        v = MY_V_LOAD(p);                                                                                  \
+        zeros = MY_V_ZEROS(v);                                                                             \
+        hits = MY_V_EQ(v, needle);                                                                         \
+        if (zeros) hits &= zeros ^ (zeros - 1);                                                            \
+        if (hits) in_group = p + 31 - __builtin_clz(hits);                                                 \
+        if (zeros) break;                                                                                  \
+    }                                                                                                      \
+    if (in_group) return (char *)in_group;                                                                 \
+    if (last_group) {                                                                                      \
+        for (int i = 3;; i--) {                                                                            \
+            hits = MY_V_EQ(MY_V_LOAD(last_group + i * MY_V_SIZE), needle);                                 \
+            if (hits) return (char *)last_group + i * MY_V_SIZE + 31 - __builtin_clz(hits);                \
+        }                                                                                                  \
+    }                                                                                                      \
+    return (char *)last;
+
+#if MY_STRING_X86
+#define MY_V __m128i
+#define MY_V_SIZE 16
+#define MY_V_LOAD(p) _mm_load_si128((const __m128i *)(const void *)(p))
+#define MY_V_LOADU(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define MY_V_STOREU(p, v) _mm_storeu_si128((__m128i *)(void *)(p), v)
+#define MY_V_SET1(c) _mm_set1_epi8(c)
+#define MY_V_MIN(a, b) _mm_min_epu8(a, b)
+#define MY_V_CMPEQ(a, b) _mm_cmpeq_epi8(a, b)
+#define MY_V_OR(a, b) _mm_or_si128(a, b)
+#define MY_V_MOVEMASK(v) ((uint32_t)_mm_movemask_epi8(v))
+#define MY_V_ZERO _mm_setzero_si128()
+
+__attribute__((target("sse2"))) MY_STRING_OVERREAD
+static inline size_t my_strlen_sse2(const char *s) {
+    MY_STRLEN_VECTOR_BODY
+}
+
+__attribute__((target("sse2"))) MY_STRING_OVERREAD
+static inline size_t my_strnlen_sse2(const char *s, size_t n) {
+    MY_STRNLEN_VECTOR_BODY
+}
+
+__attribute__((target("sse2"))) MY_STRING_OVERREAD
+static inline char *my_strcpy_sse2(char *dst, const char *src) {
+    MY_STRCPY_VECTOR_BODY
+}
+
+__attribute__((target("sse2"))) MY_STRING_OVERREAD
+static inline int my_strcmp_sse2(const char *a, const char *b) {
+    MY_STRCMP_VECTOR_BODY
+}
+
+__attribute__((target("sse2"))) MY_STRING_OVERREAD
+static inline char *my_strrchr_sse2(const char *s, int c) {
+    if ((char)c == '\0') return (char *)s + my_strlen_sse2(s);
+    MY_STRRCHR_VECTOR_BODY
+}
+
+#undef MY_V
+#undef MY_V_SIZE
+#undef MY_V_LOAD
+#undef MY_V_LOADU
+#undef MY_V_STOREU
+#undef MY_V_SET1
+#undef MY_V_MIN
+#undef MY_V_CMPEQ
+#undef MY_V_OR
+#undef MY_V_MOVEMASK
+#undef MY_V_ZERO
+
+#define MY_V __m256i
+#define MY_V_SIZE 32
+#define MY_V_LOAD(p) _mm256_load_si256((const __m256i *)(const void *)(p))
+#define MY_V_LOADU(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define MY_V_STOREU(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#define MY_V_SET1(c) _mm256_set1_epi8(c)
+#define MY_V_MIN(a, b) _mm256_min_epu8(a, b)
+#define MY_V_CMPEQ(a, b) _mm256_cmpeq_epi8(a, b)
+#define MY_V_OR(a, b) _mm256_or_si256(a, b)
+#define MY_V_MOVEMASK(v) ((uint32_t)_mm256_movemask_epi8(v))
+#define MY_V_ZERO _mm256_setzero_si256()
+
+__attribute__((target("avx2"))) MY_STRING_OVERREAD
+static inline size_t my_strlen_avx2(const char *s) {
+    MY_STRLEN_VECTOR_BODY
+}
+
+__attribute__((target("avx2"))) MY_STRING_OVERREAD
+static inline size_t my_strnlen_avx2(const char *s, size_t n) {
+    MY_STRNLEN_VECTOR_BODY
+}
+
+__attribute__((target("avx2"))) MY_STRING_OVERREAD
+static inline char *my_strcpy_avx2(char *dst, const char *src) {
+    MY_STRCPY_VECTOR_BODY
+}
+
+__attribute__((target("avx2"))) MY_STRING_OVERREAD
+static inline int my_strcmp_avx2(const char *a, const char *b) {
+    MY_STRCMP_VECTOR_BODY
+}
+
+__attribute__((target("avx2"))) MY_STRING_OVERREAD
+static inline char *my_strrchr_avx2(const char *s, int c) {
+    if ((char)c == '\0') return (char *)s + my_strlen_avx2(s);
+    MY_STRRCHR_VECTOR_BODY
+}
+
+#undef MY_V
+#undef MY_V_SIZE
+#undef MY_V_LOAD
+#undef MY_V_LOADU
+#undef MY_V_STOREU
+#undef MY_V_SET1
+#undef MY_V_MIN
+#undef MY_V_CMPEQ
+#undef MY_V_OR
+#undef MY_V_MOVEMASK
+#undef MY_V_ZERO
+#endif
+
+/* ---------------- composed from strlen / strnlen ---------------- */
+
+#define MY_STRING_COMPOSED(ISA)                                                                            \
+    static inline char *my_strncpy_##ISA(char *dst, const char *src, size_t n) {                           \
+        size_t len = my_strnlen_##ISA(src, n);                                                             \
+        memcpy(dst, src, len);                                                                             \
+        memset(dst + len, 0, n - len);                                                                     \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    static inline char *my_strcat_##ISA(char *dst, const char *src) {                                      \
+        my_strcpy_##ISA(dst + my_strlen_##ISA(dst), src);                                                  \
+        return dst;                                                                                        \
+    }                                                                                                      \
+    static inline char *my_strncat_##ISA(char *dst, const char *src, size_t n) {                           \
+        char *d = dst + my_strlen_##ISA(dst);                                                              \
+        size_t len = my_strnlen_##ISA(src, n);                                                             \
+        memcpy(d, src, len);                                                                               \
+        d[len] = '\0';                                                                                     \
+        return dst;                                                                                        \
+    }
+
+MY_STRING_COMPOSED(swar)
+#if MY_STRING_X86
+MY_STRING_COMPOSED(sse2)
+MY_STRING_COMPOSED(avx2)
+#endif
+
+/* ---------------- dispatch ---------------- */
+
+struct my_string_ops {
+    const char *name;
+    size_t (*len)(const char *);
+    size_t (*nlen)(const char *, size_t);
+    char *(*cpy)(char *, const char *);
+    char *(*ncpy)(char *, const char *, size_t);
+    char *(*cat)(char *, const char *);
+    char *(*ncat)(char *, const char *, size_t);
+    int (*cmp)(const char *, const char *);
+    char *(*rchr)(const char *, int);
+};
+
+#define MY_STRING_OPS(ISA)                                                                                 \
+    {#ISA, my_strlen_##ISA, my_strnlen_##ISA, my_strcpy_##ISA, my_strncpy_##ISA, my_strcat_##ISA,         \
+     my_strncat_##ISA, my_strcmp_##ISA, my_strrchr_##ISA}
+
+static const struct my_string_ops my_string_bytes_ops = MY_STRING_OPS(bytes);
+static const struct my_string_ops my_string_swar_ops = MY_STRING_OPS(swar);
+#if MY_STRING_X86
+static const struct my_string_ops my_string_sse2_ops = MY_STRING_OPS(sse2);
+static const struct my_string_ops my_string_avx2_ops = MY_STRING_OPS(avx2);
+#endif
+
+static const struct my_string_ops *my_string_impl = &my_string_swar_ops;
+
+// Constructor: AVX2 or SSE2 tables on x86, the SWAR table everywhere else
+__attribute__((constructor)) static void my_string_select(void) {
+#if MY_STRING_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) my_string_impl = &my_string_avx2_ops;
+    else if (__builtin_cpu_supports("sse2")) my_string_impl = &my_string_sse2_ops;
+#endif
+}
+
+static inline size_t my_strlen(const char *s) { return my_string_impl->len(s); }
+static inline size_t my_strnlen(const char *s, size_t n) { return my_string_impl->nlen(s, n); }
+static inline char *my_strcpy(char *dst, const char *src) { return my_string_impl->cpy(dst, src); }
+static inline char *my_strncpy(char *dst, const char *src, size_t n) { return my_string_impl->ncpy(dst, src, n); }
+static inline char *my_strcat(char *dst, const char *src) { return my_string_impl->cat(dst, src); }
+static inline char *my_strncat(char *dst, const char *src, size_t n) { return my_string_impl->ncat(dst, src, n); }
+static inline int my_strcmp(const char *a, const char *b) { return my_string_impl->cmp(a, b); }
+static inline char *my_strrchr(const char *s, int c) { return my_string_impl->rchr(s, c); }
+
+static inline const char *my_string_isa(void) {
+    return my_string_impl->name;
+}
+
+#endif // MY_STRING_H
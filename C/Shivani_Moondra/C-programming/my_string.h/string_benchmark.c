@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "my_string.h"
+#include "../../../bench_harness.h"
+
+/* my_string.h against glibc, per length bucket (strings of random length in (L/2, L], with random
+   alignment, cycled through so that the branch predictor cannot learn one length):
+   - libc, bytes (one character per iteration, as in strlen.c, strncpy.c, strrchr.c, ...), swar,
+     sse2, avx2,
+   - for strlen, strcpy, strncpy, strcat, strncat, strcmp, strrchr.
+   Every version is first checked against libc on random strings, half of them ending on the last
+   byte before an inaccessible page, so that an over-read across a page boundary crashes.
+   Usage: ./string_benchmark [max_length] [bench_harness options]   (default 65536) */
+
+#define POOL_BYTES (1 << 20)
+
+struct pool {
+    char *memory;
+    char **strings;
+    char **others; // Equal copies (strcmp) or destinations (the copies)
+    size_t *lengths;
+    size_t count;
+    size_t max_length;
+};
+
+struct string_job {
+    const struct my_string_ops *ops;
+    struct pool *pool;
+    int function;
+};
+
+enum { F_STRLEN, F_STRCPY, F_STRNCPY, F_STRCAT, F_STRNCAT, F_STRCMP, F_STRRCHR, F_COUNT };
+static const char *function_names[F_COUNT] = {"strlen", "strcpy", "strncpy", "strcat", "strncat", "strcmp", "strrchr"};
+
+static size_t libc_strnlen(const char *s, size_t n) { return strnlen(s, n); }
+static size_t libc_strlen(const char *s) { return strlen(s); }
+static char *libc_strcpy(char *d, const char *s) { return strcpy(d, s); }
+static char *libc_strncpy(char *d, const char *s, size_t n) { return strncpy(d, s, n); }
+static char *libc_strcat(char *d, const char *s) { return strcat(d, s); }
+static char *libc_strncat(char *d, const char *s, size_t n) { return strncat(d, s, n); }
+static int libc_strcmp(const char *a, const char *b) { return strcmp(a, b); }
+static char *libc_strrchr(const char *s, int c) { return strrchr(s, c); }
+
+static const struct my_string_ops libc_ops = {"libc", libc_strlen, libc_strnlen, libc_strcpy, libc_strncpy,
+                                              libc_strcat, libc_strncat, libc_strcmp, libc_strrchr};
+
+static void bench_string(void *ctx, uint64_t iters) {
+    struct string_job *job = ctx;
+    const struct my_string_ops *ops = job->ops;
+    struct pool *pool = job->pool;
+    size_t k = 0;
+    for (uint64_t i = 0; i < iters; ++i) {
+        const char *s = pool->strings[k];
+        char *other = pool->others[k];
+        size_t half = pool->lengths[k] / 2;
+        switch (job->function) {
+        case F_STRLEN: {
+            size_t n = ops->len(s);
+            BENCH_DO_NOT_OPTIMIZE(n);
+            break;
+        }
+        case F_STRCPY: ops->cpy(other, s); break;
+        case F_STRNCPY: ops->ncpy(other, s, pool->max_length); break;
+        case F_STRCAT: // Appends to the first half of the string
+            other[half] = '\0';
+            ops->cat(other, s + half);
+            break;
+        case F_STRNCAT:
+            other[half] = '\0';
+            ops->ncat(other, s + half, pool->max_length);
+            break;
+        case F_STRCMP: {
+            int r = ops->cmp(s, other);
+            BENCH_DO_NOT_OPTIMIZE(r);
+            break;
+        }
+        case F_STRRCHR: {
+            char *r = ops->rchr(s, 'a');
+            BENCH_DO_NOT_OPTIMIZE(r);
+            break;
+        }
+        }
+        BENCH_CLOBBER_MEMORY();
+        if (++k == pool->count) k = 0;
+    }
+}
+
+static int sign(int x) { return (x > 0) - (x < 0); }
+
+// Two pages followed by an inaccessible one
+static char *guarded_pages(void) {
+    char *base = mmap(NULL, 3 * MY_STRING_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED || mprotect(base + 2 * MY_STRING_PAGE, MY_STRING_PAGE, PROT_NONE) != 0) {
+        perror("mmap");
+        exit(1);
+    }
+    return base;
+}
+
+// Random string of length len ending at the guard page or at a random place; returns its start
+static char *place_string(char *region, size_t len, uint64_t *rng) {
+    size_t end = 2 * MY_STRING_PAGE - 1;
+    if (bench_next_random(rng) % 2) end -= bench_next_random(rng) % (2 * MY_STRING_PAGE - len - 1);
+    char *s = region + end - len;
+    for (size_t i = 0; i < len; ++i) {
+        uint64_t r = bench_next_random(rng);
+        s[i] = (char)(r % 8 == 0 ? 0x80 + r % 128 : 'a' + r % 6); // Few letters: many repeats for strrchr
+    }
+    s[len] = '\0';
+    return s;
+}
+
+// Differential check against libc; returns the number of mismatches
+static int verify(const struct my_string_ops *ops) {
+    static char *a, *b;
+    static char mine[3 * MY_STRING_PAGE], theirs[3 * MY_STRING_PAGE];
+    if (!a) {
+        a = guarded_pages();
+        b = guarded_pages();
+    }
+    uint64_t rng = 11;
+    int bad = 0;
+    for (int round = 0; round < 20000; ++round) {
+        size_t len = bench_next_random(&rng) % (round % 4 == 0 ? 2 * MY_STRING_PAGE - 1 : 100);
+        char *s = place_string(a, len, &rng);
+        size_t n = bench_next_random(&rng) % (len + 40);
+
+        bad += ops->len(s) != strlen(s);
+        bad += ops->nlen(s, n) != strnlen(s, n);
+
+        uint64_t pick = bench_next_random(&rng);
+        int c = pick % 10 == 0 ? 0 : (int)(char)(pick % 10 == 1 ? 0x80 + pick % 128 : 'a' + pick % 7);
+        bad += ops->rchr(s, c) != strrchr(s, c);
+
+        // strcmp: an equal string, or one changed or cut at a random position, ending at b's guard
+        size_t cut = len ? bench_next_random(&rng) % len : 0;
+        size_t len2 = (round % 3 == 2) ? cut : len;
+        char *t = b + 2 * MY_STRING_PAGE - 1 - len2;
+        memcpy(t, s, len2);
+        t[len2] = '\0';
+        if (round % 3 == 1 && len) t[cut] = (char)(t[cut] + 1 + bench_next_random(&rng) % 200);
+        bad += sign(ops->cmp(s, t)) != sign(strcmp(s, t));
+        bad += sign(ops->cmp(t, s)) != sign(strcmp(t, s));
+
+        // The copies write into buffers prefilled alike, and must change the same bytes
+        size_t at = bench_next_random(&rng) % 64;
+        size_t prefix = bench_next_random(&rng) % 50;
+        for (int f = 0; f < 4; ++f) {
+            memset(mine, 'x', sizeof(mine));
+            memset(theirs, 'x', sizeof(theirs));
+            memset(mine + at, 'p', prefix);
+            memset(theirs + at, 'p', prefix);
+            mine[at + prefix] = theirs[at + prefix] = '\0';
+            char *r1, *r2;
+            if (f == 0) r1 = ops->cpy(mine + at, s), r2 = strcpy(theirs + at, s);
+            else if (f == 1) r1 = ops->ncpy(mine + at, s, n), r2 = strncpy(theirs + at, s, n);
+            else if (f == 2) r1 = ops->cat(mine + at, s), r2 = strcat(theirs + at, s);
+            else r1 = ops->ncat(mine + at, s, n), r2 = strncat(theirs + at, s, n);
+            bad += (r1 - mine) != (r2 - theirs) || memcmp(mine, theirs, sizeof(mine)) != 0;
+        }
+    }
+    return bad;
+}
+
+static struct pool *make_pool(size_t max_length, uint64_t *rng) {
+    struct pool *pool = calloc(1, sizeof(*pool));
+    size_t count = POOL_BYTES / (max_length + 64);
+    pool->count = count < 4 ? 4 : (count > 64 ? 64 : count);
+    pool->max_length = max_length;
+    pool->strings = calloc(pool->count, sizeof(char *));
+    pool->others = calloc(pool->count, sizeof(char *));
+    pool->lengths = calloc(pool->count, sizeof(size_t));
+    pool->memory = malloc(pool->count * 2 * (max_length + 128));
+    if (!pool->memory) exit(1);
+    for (size_t k = 0; k < pool->count; ++k) {
+        size_t len = max_length / 2 + 1 + bench_next_random(rng) % (max_length - max_length / 2);
+        size_t offset = bench_next_random(rng) % 64;
+        char *s = pool->memory + 2 * k * (max_length + 128);
+        char *o = s + max_length + 128;
+        for (size_t i = 0; i < len; ++i) s[offset + i] = (char)('b' + bench_next_random(rng) % 25);
+        s[offset + len - 1 - bench_next_random(rng) % (len / 2 + 1)] = 'a';
+        s[offset + len] = '\0';
+        size_t other_offset = bench_next_random(rng) % 64;
+        memcpy(o + other_offset, s + offset, len + 1);
+        o[other_offset + len - 1] ^= 1; // strcmp runs to the end
+        pool->strings[k] = s + offset;
+        pool->others[k] = o + other_offset;
+        pool->lengths[k] = len;
+    }
+    return pool;
+}
+
+static void free_pool(struct pool *pool) {
+    free(pool->memory);
+    free(pool->strings);
+    free(pool->others);
+    free(pool->lengths);
+    free(pool);
+}
+
+int main(int argc, char **argv) {
+    size_t max_length = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : 65536;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    const struct my_string_ops *variants[6];
+    int count = 0;
+    variants[count++] = &libc_ops;
+    variants[count++] = &my_string_bytes_ops;
+    variants[count++] = &my_string_swar_ops;
+#if MY_STRING_X86
+    variants[count++] = &my_string_sse2_ops;
+    if (__builtin_cpu_supports("avx2")) variants[count++] = &my_string_avx2_ops;
+#endif
+
+    int failures = 0;
+    for (int v = 1; v < count; ++v) {
+        int bad = verify(variants[v]);
+        failures += bad;
+        printf("check %-6s %s\n", variants[v]->name, bad ? "MISMATCH" : "ok");
+    }
+    printf("dispatch: %s\n\n", my_string_isa());
+
+    uint64_t rng = 3;
+    char name[64];
+    for (size_t length = 16; length <= max_length; length *= 16) {
+        struct pool *pool = make_pool(length, &rng);
+        double mean = 0;
+        for (size_t k = 0; k < pool->count; ++k) mean += (double)pool->lengths[k] / (double)pool->count;
+        for (int f = 0; f < F_COUNT; ++f) {
+            for (int v = 0; v < count; ++v) {
+                struct string_job job = {variants[v], pool, f};
+                snprintf(name, sizeof(name), "%s/%s/%zu", function_names[f], variants[v]->name, length);
+                bench_set_bytes(bench_run(&session, name, bench_string, &job), mean);
+            }
+        }
+        free_pool(pool);
+    }
+
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
@@ -0,0 +1,194 @@
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BYTE_ORDER_X86 1
+#else
+#define BYTE_ORDER_X86 0
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BYTE_ORDER_HOST_BIG 1
+#else
+#define BYTE_ORDER_HOST_BIG 0
+#endif
+
+/* Endianness conversion of whole arrays of 16, 32 and 64-bit fields (convert_endianess.pdf and
+   convert_little_endian_to_big_endian.pdf do it one word at a time), for wire and file buffers.
+       bswap_u16(dst, src, n), bswap_u32, bswap_u64     always reverse the bytes of each element
+       hton_u16/32/64, ntoh_u16/32/64                   host <-> big-endian (network order)
+       htole_u16/32/64, letoh_u16/32/64                 host <-> little-endian
+   dst and src are either the same array (in place) or do not overlap; n counts elements.
+   - The byte reversal of every element is one pshufb: a 16-byte index vector lists, for each
+     output byte, the input byte of the same element read from the other end. The index only
+     depends on the element size, and AVX2 / AVX-512 shuffle within 16-byte lanes, which is
+     exactly what is needed here because elements never cross a lane. Four vectors are in
+     flight per iteration; the last few elements use the bswap instruction.
+   - The hton / htole families are decided at compile time from __BYTE_ORDER__: when the host
+     already has the wanted order they do not touch the data in place, and are a memcpy out of
+     place.
+   Versions are picked once at startup from cpuid (AVX-512BW > AVX2 > SSSE3 > scalar);
+   byte_order_isa() names the choice.
+*/
+
+/* ---------------- scalar ---------------- */
+
+// bytes is a multiple of size (2, 4 or 8). memcpy loads and stores: dst and src may be
+// unaligned byte buffers (the SIMD tails pass any offset); compilers emit plain movs.
+static inline void byte_swap_scalar(void *dst, const void *src, size_t bytes, unsigned size) {
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+    size_t i;
+    switch (size) {
+    case 2:
+        for (i = 0; i < bytes; i += 2) {
+            uint16_t v;
+            memcpy(&v, s + i, 2);
+            v = __builtin_bswap16(v);
+            memcpy(d + i, &v, 2);
+        }
+        break;
+    case 4:
+        for (i = 0; i < bytes; i += 4) {
+            uint32_t v;
+            memcpy(&v, s + i, 4);
+            v = __builtin_bswap32(v);
+            memcpy(d + i, &v, 4);
+        }
+        break;
+    default:
+        for (i = 0; i < bytes; i += 8) {
+            uint64_t v;
+            memcpy(&v, s + i, 8);
+            v = __builtin_bswap64(v);
+            memcpy(d + i, &v, 8);
+        }
+        break;
+    }
+}
+
+/* ---------------- ssse3 / avx2 / avx512 ---------------- */
+
+#if BYTE_ORDER_X86
+// pshufb indexes reversing 2, 4 and 8-byte elements, at [size / 4]
+static const uint8_t byte_order_masks[3][16] __attribute__((aligned(16))) = {
+    {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+    {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8},
+};
+
+// Four vectors per iteration, then one, then the scalar loop for less than a 16-byte lane
+#define BYTE_SWAP_VECTOR_BODY(VEC, LOAD, STORE, SHUFFLE)                                                    \
+    do {                                                                                                   \
+        const char *s = src;                                                                               \
+        char *d = dst;                                                                                     \
+        size_t i = 0;                                                                                      \
+        for (; i + 4 * sizeof(VEC) <= bytes; i += 4 * sizeof(VEC)) {                                       \
+            VEC a = LOAD(s + i), b = LOAD(s + i + sizeof(VEC));                                            \
+            VEC c = LOAD(s + i + 2 * sizeof(VEC)), e = LOAD(s + i + 3 * sizeof(VEC));                      \
+            STORE(d + i, SHUFFLE(a, mask));                                                                \
+            STORE(d + i + sizeof(VEC), SHUFFLE(b, mask));                                                  \
+            STORE(d + i + 2 * sizeof(VEC), SHUFFLE(c, mask));                                              \
+            STORE(d + i + 3 * sizeof(VEC), SHUFFLE(e, mask));                                              \
+        }                                                                                                  \
+        for (; i + sizeof(VEC) <= bytes; i += sizeof(VEC)) STORE(d + i, SHUFFLE(LOAD(s + i), mask));       \
+        for (; i + 16 <= bytes; i += 16) {                                                                 \
+            __m128i x = _mm_loadu_si128((const __m128i *)(const void *)(s + i));                           \
+            _mm_storeu_si128((__m128i *)(void *)(d + i), _mm_shuffle_epi8(x, lane));                       \
+        }                                                                                                  \
+        byte_swap_scalar(d + i, s + i, bytes - i, size);                                                   \
+    } while (0)
+
+#define BYTE_SSSE3_LOAD(p) _mm_loadu_si128((const __m128i *)(const void *)(p))
+#define BYTE_SSSE3_STORE(p, v) _mm_storeu_si128((__m128i *)(void *)(p), v)
+#define BYTE_AVX2_LOAD(p) _mm256_loadu_si256((const __m256i *)(const void *)(p))
+#define BYTE_AVX2_STORE(p, v) _mm256_storeu_si256((__m256i *)(void *)(p), v)
+#define BYTE_AVX512_LOAD(p) _mm512_loadu_si512((const void *)(p))
+#define BYTE_AVX512_STORE(p, v) _mm512_storeu_si512((void *)(p), v)
+
+__attribute__((target("ssse3")))
+static inline void byte_swap_ssse3(void *dst, const void *src, size_t bytes, unsigned size) {
+    const __m128i lane = _mm_load_si128((const __m128i *)(const void *)byte_order_masks[size / 4]);
+    const __m128i mask = lane;
+    BYTE_SWAP_VECTOR_BODY(__m128i, BYTE_SSSE3_LOAD, BYTE_SSSE3_STORE, _mm_shuffle_epi8);
+}
+
+__attribute__((target("avx2")))
+static inline void byte_swap_avx2(void *dst, const void *src, size_t bytes, unsigned size) {
+    const __m128i lane = _mm_load_si128((const __m128i *)(const void *)byte_order_masks[size / 4]);
+    const __m256i mask = _mm256_broadcastsi128_si256(lane);
+    BYTE_SWAP_VECTOR_BODY(__m256i, BYTE_AVX2_LOAD, BYTE_AVX2_STORE, _mm256_shuffle_epi8);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline void byte_swap_avx512(void *dst, const void *src, size_t bytes, unsigned size) {
+    const __m128i lane = _mm_load_si128((const __m128i *)(const void *)byte_order_masks[size / 4]);
+    const __m512i mask = _mm512_broadcast_i32x4(lane);
+    BYTE_SWAP_VECTOR_BODY(__m512i, BYTE_AVX512_LOAD, BYTE_AVX512_STORE, _mm512_shuffle_epi8);
+}
+#endif
+
+/* ---------------- dispatch ---------------- */
+
+static void (*byte_swap_impl)(void *, const void *, size_t, unsigned) = byte_swap_scalar;
+static const char *byte_order_impl_name = "scalar";
+
+// Constructor: AVX-512 needs BW as well, F alone has no byte shuffle
+__attribute__((constructor)) static void byte_order_select(void) {
+#if BYTE_ORDER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3")) {
+        byte_swap_impl = byte_swap_ssse3;
+        byte_order_impl_name = "ssse3";
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        byte_swap_impl = byte_swap_avx2;
+        byte_order_impl_name = "avx2";
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        byte_swap_impl = byte_swap_avx512;
+        byte_order_impl_name = "avx512";
+    }
+#endif
+}
+
+static inline void bswap_u16(uint16_t *dst, const uint16_t *src, size_t n) {
+    byte_swap_impl(dst, src, n * 2, 2);
+}
+
+static inline void bswap_u32(uint32_t *dst, const uint32_t *src, size_t n) {
+    byte_swap_impl(dst, src, n * 4, 4);
+}
+
+static inline void bswap_u64(uint64_t *dst, const uint64_t *src, size_t n) {
+    byte_swap_impl(dst, src, n * 8, 8);
+}
+
+static inline const char *byte_order_isa(void) {
+    return byte_order_impl_name;
+}
+
+/* ---------------- host order ---------------- */
+
+// swap is a constant: the branch not taken disappears at compile time
+#define BYTE_ORDER_CONVERSION(name, bits, swap)                                                             \
+    static inline void name##_u##bits(uint##bits##_t *dst, const uint##bits##_t *src, size_t n) {            \
+        if (swap) bswap_u##bits(dst, src, n);                                                              \
+        else if (dst != src) memcpy(dst, src, n * sizeof(*src));                                           \
+    }
+
+#define BYTE_ORDER_CONVERSIONS(bits)                                                                        \
+    BYTE_ORDER_CONVERSION(hton, bits, !BYTE_ORDER_HOST_BIG)                                                \
+    BYTE_ORDER_CONVERSION(ntoh, bits, !BYTE_ORDER_HOST_BIG)                                                \
+    BYTE_ORDER_CONVERSION(htole, bits, BYTE_ORDER_HOST_BIG)                                                \
+    BYTE_ORDER_CONVERSION(letoh, bits, BYTE_ORDER_HOST_BIG)
+
+BYTE_ORDER_CONVERSIONS(16)
+BYTE_ORDER_CONVERSIONS(32)
+BYTE_ORDER_CONVERSIONS(64)
+
+#endif // BYTE_ORDER_H
@@ -0,0 +1,206 @@
+#include <arpa/inet.h>
+#include <endian.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "byte_order.h"
+#include "../../bench_harness.h"
+
+/* byte_order.h against scalar conversion loops, out of place on buffers of 4 KiB to 64 MiB:
+   - u16/...: htons (one call per element), scalar (bswap loop), ssse3, avx2, avx512,
+   - u32/...: htonl, shifts (the mask-and-shift form of convert_little_endian_to_big_endian.pdf),
+     scalar, ssse3, avx2, avx512, inplace (the dispatched version with dst == src),
+   - u64/...: htobe64, scalar, ssse3, avx2, avx512.
+   Every version is first checked against the libc conversion on random lengths and offsets.
+   Usage: ./byte_order_benchmark [max_bytes] [bench_harness options]   (default 64 MiB) */
+
+struct variant {
+    const char *name;
+    unsigned size;
+    void (*fn)(void *dst, const void *src, size_t bytes, unsigned size);
+};
+
+static void htons_loop(void *dst, const void *src, size_t bytes, unsigned size) {
+    (void)size;
+    for (size_t i = 0; i < bytes / 2; i++) ((uint16_t *)dst)[i] = htons(((const uint16_t *)src)[i]);
+}
+
+static void htonl_loop(void *dst, const void *src, size_t bytes, unsigned size) {
+    (void)size;
+    for (size_t i = 0; i < bytes / 4; i++) ((uint32_t *)dst)[i] = htonl(((const uint32_t *)src)[i]);
+}
+
+static void shifts_loop(void *dst, const void *src, size_t bytes, unsigned size) {
+    (void)size;
+    for (size_t i = 0; i < bytes / 4; i++) {
+        uint32_t x = ((const uint32_t *)src)[i];
+        ((uint32_t *)dst)[i] = (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+    }
+}
+
+static void htobe64_loop(void *dst, const void *src, size_t bytes, unsigned size) {
+    (void)size;
+    for (size_t i = 0; i < bytes / 8; i++) ((uint64_t *)dst)[i] = htobe64(((const uint64_t *)src)[i]);
+}
+
+static void dispatched(void *dst, const void *src, size_t bytes, unsigned size) {
+    byte_swap_impl(dst, src, bytes, size);
+}
+
+struct swap_job {
+    const struct variant *v;
+    void *dst;
+    const void *src;
+    size_t bytes;
+};
+
+static void bench_swap(void *ctx, uint64_t iters) {
+    struct swap_job *job = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        job->v->fn(job->dst, job->src, job->bytes, job->v->size);
+        BENCH_CLOBBER_MEMORY();
+    }
+}
+
+// libc conversion of every element, the reference
+static void expected(unsigned char *dst, const unsigned char *src, size_t bytes, unsigned size) {
+    for (size_t i = 0; i < bytes; i += size) {
+        if (size == 2) {
+            uint16_t x;
+            memcpy(&x, src + i, 2);
+            x = htons(x);
+            memcpy(dst + i, &x, 2);
+        } else if (size == 4) {
+            uint32_t x;
+            memcpy(&x, src + i, 4);
+            x = htonl(x);
+            memcpy(dst + i, &x, 4);
+        } else {
+            uint64_t x;
+            memcpy(&x, src + i, 8);
+            x = htobe64(x);
+            memcpy(dst + i, &x, 8);
+        }
+    }
+}
+
+// Out of place with the bytes around dst untouched, then in place; returns the number of mismatches
+static int verify(const struct variant *v) {
+    enum { SIZE = 1 << 16 };
+    static unsigned char src[SIZE], dst[SIZE + 64], expect[SIZE + 64];
+    uint64_t rng = 3;
+    int bad = 0;
+    for (int round = 0; round < 1000; ++round) {
+        size_t bytes = (size_t)(bench_next_random(&rng) % (round % 4 ? 600 : SIZE - 64)) / v->size * v->size;
+        size_t offset = (size_t)(bench_next_random(&rng) % 8) * v->size; // Element-aligned, not vector-aligned
+        for (size_t i = 0; i < bytes; ++i) src[offset + i] = (unsigned char)bench_next_random(&rng);
+        memset(dst, 0xA5, sizeof(dst));
+        memset(expect, 0xA5, sizeof(expect));
+        expected(expect + offset, src + offset, bytes, v->size);
+        v->fn(dst + offset, src + offset, bytes, v->size);
+        if (memcmp(dst, expect, sizeof(dst)) != 0) ++bad;
+        v->fn(src + offset, src + offset, bytes, v->size);
+        if (memcmp(src + offset, expect + offset, bytes) != 0) ++bad;
+    }
+    return bad;
+}
+
+// The host-order families against libc; returns the number of mismatches
+static int verify_conversions(void) {
+    enum { N = 1000 };
+    static uint16_t a16[N], b16[N];
+    static uint32_t a32[N], b32[N];
+    static uint64_t a64[N], b64[N];
+    uint64_t rng = 7;
+    int bad = 0;
+    for (size_t i = 0; i < N; ++i) {
+        a64[i] = bench_next_random(&rng);
+        a32[i] = (uint32_t)a64[i];
+        a16[i] = (uint16_t)a64[i];
+    }
+    hton_u16(b16, a16, N);
+    hton_u32(b32, a32, N);
+    hton_u64(b64, a64, N);
+    for (size_t i = 0; i < N; ++i) bad += b16[i] != htons(a16[i]) || b32[i] != htonl(a32[i]) || b64[i] != htobe64(a64[i]);
+    ntoh_u32(b32, b32, N);
+    ntoh_u64(b64, b64, N);
+    bad += memcmp(a32, b32, sizeof(a32)) != 0 || memcmp(a64, b64, sizeof(a64)) != 0;
+    htole_u16(b16, a16, N);
+    htole_u32(b32, a32, N);
+    htole_u64(b64, a64, N);
+    for (size_t i = 0; i < N; ++i) bad += b16[i] != htole16(a16[i]) || b32[i] != htole32(a32[i]) || b64[i] != htole64(a64[i]);
+    letoh_u64(b64, b64, N);
+    bad += memcmp(a64, b64, sizeof(a64)) != 0;
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    size_t max_bytes = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : ((size_t)64 << 20);
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    struct variant variants[20];
+    int count = 0;
+    variants[count++] = (struct variant){"u16/htons", 2, htons_loop};
+    variants[count++] = (struct variant){"u16/scalar", 2, byte_swap_scalar};
+#if BYTE_ORDER_X86
+    int ssse3 = __builtin_cpu_supports("ssse3"), avx2 = __builtin_cpu_supports("avx2");
+    int avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    if (ssse3) variants[count++] = (struct variant){"u16/ssse3", 2, byte_swap_ssse3};
+    if (avx2) variants[count++] = (struct variant){"u16/avx2", 2, byte_swap_avx2};
+    if (avx512) variants[count++] = (struct variant){"u16/avx512", 2, byte_swap_avx512};
+#endif
+    variants[count++] = (struct variant){"u32/htonl", 4, htonl_loop};
+    variants[count++] = (struct variant){"u32/shifts", 4, shifts_loop};
+    variants[count++] = (struct variant){"u32/scalar", 4, byte_swap_scalar};
+#if BYTE_ORDER_X86
+    if (ssse3) variants[count++] = (struct variant){"u32/ssse3", 4, byte_swap_ssse3};
+    if (avx2) variants[count++] = (struct variant){"u32/avx2", 4, byte_swap_avx2};
+    if (avx512) variants[count++] = (struct variant){"u32/avx512", 4, byte_swap_avx512};
+#endif
+    int inplace = count;
+    variants[count++] = (struct variant){"u32/inplace", 4, dispatched};
+    variants[count++] = (struct variant){"u64/htobe64", 8, htobe64_loop};
+    variants[count++] = (struct variant){"u64/scalar", 8, byte_swap_scalar};
+#if BYTE_ORDER_X86
+    if (ssse3) variants[count++] = (struct variant){"u64/ssse3", 8, byte_swap_ssse3};
+    if (avx2) variants[count++] = (struct variant){"u64/avx2", 8, byte_swap_avx2};
+    if (avx512) variants[count++] = (struct variant){"u64/avx512", 8, byte_swap_avx512};
+#endif
+
+    int failures = 0;
+    for (int v = 0; v < count; ++v) {
+        int bad = verify(&variants[v]);
+        failures += bad;
+        printf("check %-14s %s\n", variants[v].name, bad ? "MISMATCH" : "ok");
+    }
+    int bad = verify_conversions();
+    failures += bad;
+    printf("check %-14s %s\n", "hton/htole", bad ? "MISMATCH" : "ok");
+    printf("dispatch: %s, host %s-endian\n\n", byte_order_isa(), BYTE_ORDER_HOST_BIG ? "big" : "little");
+
+    size_t buffer_bytes = (max_bytes + 4095) & ~(size_t)4095;
+    char *src = aligned_alloc(4096, buffer_bytes);
+    char *dst = aligned_alloc(4096, buffer_bytes);
+    if (!src || !dst) return 1;
+    uint64_t rng = 11;
+    for (size_t i = 0; i < buffer_bytes; i += 8) {
+        uint64_t r = bench_next_random(&rng);
+        memcpy(src + i, &r, 8);
+    }
+    memset(dst, 0, buffer_bytes);
+
+    char name[64];
+    for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 8) {
+        for (int v = 0; v < count; ++v) {
+            struct swap_job job = {&variants[v], v == inplace ? src : dst, src, bytes};
+            snprintf(name, sizeof(name), "%s/%zu", variants[v].name, bytes);
+            bench_set_bytes(bench_run(&session, name, bench_swap, &job), (double)bytes);
+        }
+    }
+
+    free(src);
+    free(dst);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
@@ -0,0 +1,312 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "byte_order.h"
+#if defined(__x86_64__)
+#define CHECKSUM_X86 1
+#else
+#define CHECKSUM_X86 0
+#endif
+
+/* Packet and file-block checksums (checksum_basic.c summed single bytes into a 16-bit word).
+       inet_checksum(data, len)              RFC 1071 Internet checksum (IP, TCP, UDP, ICMP)
+       crc32_update(crc, data, len)          CRC-32 (Ethernet, zlib, PNG)
+       crc32c_update(crc, data, len)         CRC-32C (Castagnoli: iSCSI, SCTP, ext4)
+       crc32_combine(crc1, crc2, len2), crc32c_combine
+   All of them stream: struct inet_csum collects any split of the data (init, update, final),
+   and the CRCs take the previous result, starting from 0, as zlib's crc32() does. Combining
+   gives the CRC of A then B from the CRCs of A and of B and the length of B.
+   - The Internet checksum is a one's-complement sum, that is a sum modulo 0xFFFF. Since 0xFFFF
+     divides 2^32 - 1, whole 32-bit halves of 64-bit loads can be added into a 64-bit total
+     and folded at the end; the AVX2 version does the same in four 64-bit lanes. The sum of
+     byte-swapped words is the byte-swapped sum (RFC 1071), so words are read in host order
+     and the result is swapped once, and a piece of a stream starting at an odd offset is
+     swapped before it is added. inet_csum_final returns the value as a number: store it
+     with htons.
+   - CRCs in software are slicing-by-8: eight 256-entry tables, the j-th giving the CRC of a
+     byte followed by j zero bytes, so eight bytes cost eight independent lookups instead of a
+     chain of eight. The tables are built at startup.
+   - CRC-32C uses the SSE4.2 crc32 instruction, 8 bytes at a time. It has a latency of three
+     cycles and a throughput of one, so buffers are cut into three blocks (4 KiB, then 256
+     bytes) checksummed together; the CRCs of the first two are moved over the bytes that follow
+     them by a multiplication with x^(8 * bytes) modulo the polynomial, then XORed together.
+     The multiplication is one pclmul with x^(8 * bytes - 33) and a crc32 of the product,
+     which does the reduction.
+   Versions are picked once at startup from cpuid (x86-64 only); checksum_isa() names the
+   choice. The two slicing tables (8 KiB each) are static arrays filled by the constructor, so
+   every file that includes this header carries and builds its own pair.
+*/
+
+#define CRC32_POLY 0xEDB88320u  // 0x04C11DB7, bit-reflected
+#define CRC32C_POLY 0x82F63B78u // 0x1EDC6F41, bit-reflected
+#define CRC32C_LONG 4096        // Bytes per stream in the three-stream loops
+#define CRC32C_SHORT 256
+#define INET_CSUM_PIECE ((size_t)1 << 30)
+
+/* ---------------- Internet checksum ---------------- */
+
+// A 64-bit one's-complement sum folded to 16 bits
+static inline uint16_t inet_fold(uint64_t s) {
+    s = (s & 0xFFFFFFFF) + (s >> 32);
+    s = (s & 0xFFFFFFFF) + (s >> 32);
+    s = (s & 0xFFFFFFFF) + (s >> 32);
+    s = (s & 0xFFFF) + (s >> 16);
+    s = (s & 0xFFFF) + (s >> 16);
+    return (uint16_t)s;
+}
+
+// Sum of the host-order 16-bit words of at most INET_CSUM_PIECE bytes, not folded
+static inline uint64_t inet_sum_scalar(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t a = 0, b = 0;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint64_t x, y;
+        memcpy(&x, p + i, 8);
+        memcpy(&y, p + i + 8, 8);
+        a += (x & 0xFFFFFFFF) + (x >> 32);
+        b += (y & 0xFFFFFFFF) + (y >> 32);
+    }
+    for (; i + 4 <= len; i += 4) {
+        uint32_t x;
+        memcpy(&x, p + i, 4);
+        a += x;
+    }
+    if (i + 2 <= len) {
+        uint16_t x;
+        memcpy(&x, p + i, 2);
+        a += x;
+        i += 2;
+    }
+    if (i < len) a += BYTE_ORDER_HOST_BIG ? (uint64_t)p[i] << 8 : p[i]; // Padded with a zero byte
+    return a + b;
+}
+
+#if CHECKSUM_X86
+__attribute__((target("avx2")))
+static inline uint64_t inet_sum_avx2(const void *data, size_t len) {
+    const unsigned char *p = data;
+    const __m256i low = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i a = _mm256_setzero_si256(), b = a, c = a, d = a;
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(const void *)(p + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(const void *)(p + i + 32));
+        a = _mm256_add_epi64(a, _mm256_and_si256(x, low));
+        b = _mm256_add_epi64(b, _mm256_srli_epi64(x, 32));
+        c = _mm256_add_epi64(c, _mm256_and_si256(y, low));
+        d = _mm256_add_epi64(d, _mm256_srli_epi64(y, 32));
+    }
+    __m256i s = _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_add_epi64(c, d));
+    __m128i h = _mm_add_epi64(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+    uint64_t total = (uint64_t)_mm_cvtsi128_si64(h) + (uint64_t)_mm_extract_epi64(h, 1);
+    return total + inet_sum_scalar(p + i, len - i);
+}
+#endif
+
+/* ---------------- CRC, software ---------------- */
+
+static uint32_t crc32_table[8][256], crc32c_table[8][256];
+
+static inline void crc_build_tables(uint32_t t[8][256], uint32_t poly) {
+    for (unsigned i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = c >> 1 ^ (poly & (0u - (c & 1)));
+        t[0][i] = c;
+    }
+    for (unsigned i = 0; i < 256; i++)
+        for (int j = 1; j < 8; j++) t[j][i] = t[j - 1][i] >> 8 ^ t[0][t[j - 1][i] & 0xFF];
+}
+
+// On the register, without the inversions before and after
+static inline uint32_t crc_slice8(uint32_t crc, const unsigned char *p, size_t len, const uint32_t t[8][256]) {
+    for (; len && ((uintptr_t)p & 7); len--) crc = crc >> 8 ^ t[0][(crc ^ *p++) & 0xFF];
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+#if BYTE_ORDER_HOST_BIG
+        w = __builtin_bswap64(w);
+#endif
+        w ^= crc;
+        crc = t[7][w & 0xFF] ^ t[6][(w >> 8) & 0xFF] ^ t[5][(w >> 16) & 0xFF] ^ t[4][(w >> 24) & 0xFF] ^
+              t[3][(w >> 32) & 0xFF] ^ t[2][(w >> 40) & 0xFF] ^ t[1][(w >> 48) & 0xFF] ^ t[0][w >> 56];
+    }
+    for (; len; len--) crc = crc >> 8 ^ t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+static inline uint32_t crc32_slice8(uint32_t crc, const void *data, size_t len) {
+    return ~crc_slice8(~crc, data, len, crc32_table);
+}
+
+static inline uint32_t crc32c_slice8(uint32_t crc, const void *data, size_t len) {
+    return ~crc_slice8(~crc, data, len, crc32c_table);
+}
+
+// a * b modulo the polynomial; bit 31 holds x^0
+static inline uint32_t crc_multiply(uint32_t a, uint32_t b, uint32_t poly) {
+    uint32_t product = 0;
+    for (; a; a <<= 1) {
+        if (a & 0x80000000u) product ^= b;
+        b = b >> 1 ^ (poly & (0u - (b & 1)));
+    }
+    return product;
+}
+
+// x^n modulo the polynomial, by squaring
+static inline uint32_t crc_x_pow(uint64_t n, uint32_t poly) {
+    uint32_t result = 0x80000000u, square = 0x40000000u; // x^0, x^1
+    for (; n; n >>= 1) {
+        if (n & 1) result = crc_multiply(result, square, poly);
+        square = crc_multiply(square, square, poly);
+    }
+    return result;
+}
+
+static inline uint32_t crc_combine(uint32_t crc1, uint32_t crc2, size_t len2, uint32_t poly) {
+    return crc_multiply(crc1, crc_x_pow(8 * (uint64_t)len2, poly), poly) ^ crc2;
+}
+
+/* ---------------- CRC-32C, sse4.2 ---------------- */
+
+#if CHECKSUM_X86
+// x^(8 * block - 33) for the first stream (moved over two blocks) and the second (one block)
+static uint64_t crc32c_long_shifts[2], crc32c_short_shifts[2];
+
+__attribute__((target("sse4.2")))
+static inline uint32_t crc32c_sse42_raw(uint32_t crc, const unsigned char *p, size_t len) {
+    uint64_t c = crc;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        c = _mm_crc32_u64(c, w);
+    }
+    crc = (uint32_t)c;
+    for (; len; len--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+// One stream: three cycles per 8 bytes
+__attribute__((target("sse4.2")))
+static inline uint32_t crc32c_sse42(uint32_t crc, const void *data, size_t len) {
+    return ~crc32c_sse42_raw(~crc, data, len);
+}
+
+// The register a after three blocks of 'block' bytes, checksummed together
+__attribute__((target("sse4.2,pclmul")))
+static inline uint64_t crc32c_sse42_3way(uint64_t a, const unsigned char *p, size_t block, const uint64_t shifts[2]) {
+    uint64_t b = 0, c = 0;
+    for (size_t i = 0; i < block; i += 8) {
+        uint64_t x, y, z;
+        memcpy(&x, p + i, 8);
+        memcpy(&y, p + block + i, 8);
+        memcpy(&z, p + 2 * block + i, 8);
+        a = _mm_crc32_u64(a, x);
+        b = _mm_crc32_u64(b, y);
+        c = _mm_crc32_u64(c, z);
+    }
+    // The products of a and b are under 64 bits, and reducing is linear: one crc32 for both
+    const __m128i k = _mm_set_epi64x((long long)shifts[1], (long long)shifts[0]);
+    __m128i pa = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a), k, 0x00);
+    __m128i pb = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)b), k, 0x10);
+    return _mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(_mm_xor_si128(pa, pb))) ^ c;
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static inline uint32_t crc32c_sse42_x3(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t a = ~crc;
+    for (; len >= 3 * CRC32C_LONG; p += 3 * CRC32C_LONG, len -= 3 * CRC32C_LONG)
+        a = crc32c_sse42_3way(a, p, CRC32C_LONG, crc32c_long_shifts);
+    for (; len >= 3 * CRC32C_SHORT; p += 3 * CRC32C_SHORT, len -= 3 * CRC32C_SHORT)
+        a = crc32c_sse42_3way(a, p, CRC32C_SHORT, crc32c_short_shifts);
+    return ~crc32c_sse42_raw((uint32_t)a, p, len);
+}
+#endif
+
+/* ---------------- dispatch ---------------- */
+
+static uint64_t (*inet_sum_impl)(const void *, size_t) = inet_sum_scalar;
+static uint32_t (*crc32c_impl)(uint32_t, const void *, size_t) = crc32c_slice8;
+static const char *checksum_impl_name = "scalar";
+
+// Constructor: tables and pclmul shift constants first, the CPU checks only choose pointers
+__attribute__((constructor)) static void checksum_select(void) {
+    crc_build_tables(crc32_table, CRC32_POLY);
+    crc_build_tables(crc32c_table, CRC32C_POLY);
+#if CHECKSUM_X86
+    crc32c_long_shifts[0] = crc_x_pow(16 * CRC32C_LONG - 33, CRC32C_POLY);
+    crc32c_long_shifts[1] = crc_x_pow(8 * CRC32C_LONG - 33, CRC32C_POLY);
+    crc32c_short_shifts[0] = crc_x_pow(16 * CRC32C_SHORT - 33, CRC32C_POLY);
+    crc32c_short_shifts[1] = crc_x_pow(8 * CRC32C_SHORT - 33, CRC32C_POLY);
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32c_impl = __builtin_cpu_supports("pclmul") ? crc32c_sse42_x3 : crc32c_sse42;
+        checksum_impl_name = "sse4.2";
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        inet_sum_impl = inet_sum_avx2;
+        checksum_impl_name = __builtin_cpu_supports("sse4.2") ? "avx2+sse4.2" : "avx2";
+    }
+#endif
+}
+
+struct inet_csum {
+    uint64_t sum;  // Folded sums of the pieces, in host order
+    size_t length; // Bytes so far: an odd count moves the next byte to the other half of a word
+};
+
+static inline void inet_csum_init(struct inet_csum *c) {
+    c->sum = 0;
+    c->length = 0;
+}
+
+static inline void inet_csum_update(struct inet_csum *c, const void *data, size_t len) {
+    const unsigned char *p = data;
+    while (len) {
+        size_t piece = len < INET_CSUM_PIECE ? len : INET_CSUM_PIECE;
+        uint16_t s = inet_fold(inet_sum_impl(p, piece));
+        c->sum += c->length & 1 ? __builtin_bswap16(s) : s;
+        c->length += piece;
+        p += piece;
+        len -= piece;
+    }
+}
+
+// The checksum field value; a buffer that already holds it sums to 0
+static inline uint16_t inet_csum_final(const struct inet_csum *c) {
+    uint16_t s = (uint16_t)~inet_fold(c->sum);
+    return BYTE_ORDER_HOST_BIG ? s : __builtin_bswap16(s);
+}
+
+static inline uint16_t inet_checksum(const void *data, size_t len) {
+    struct inet_csum c;
+    inet_csum_init(&c);
+    inet_csum_update(&c, data, len);
+    return inet_csum_final(&c);
+}
+
+static inline uint32_t crc32_update(uint32_t crc, const void *data, size_t len) {
+    return crc32_slice8(crc, data, len);
+}
+
+static inline uint32_t crc32c_update(uint32_t crc, const void *data, size_t len) {
+    return crc32c_impl(crc, data, len);
+}
+
+static inline uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2) {
+    return crc_combine(crc1, crc2, len2, CRC32_POLY);
+}
+
+static inline uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2) {
+    return crc_combine(crc1, crc2, len2, CRC32C_POLY);
+}
+
+static inline const char *checksum_isa(void) {
+    return checksum_impl_name;
+}
+
+#endif // CHECKSUM_H
@@ -1,24 +1,35 @@
-int main(short argc, char **argv)
+#include <stdio.h>
+#include <string.h>
+#include "checksum.h"
+
+/* The one's-complement checksum of the bytes of a serial number, expected FD2B.
+   The earlier version kept the sum in an unsigned short but returned (char)~chksum, which cut
+   the result to its low byte (only 2B was printed), and dropped the carries out of the 16-bit
+   sum, which one's-complement arithmetic adds back in. */
+
+unsigned short CalcChksum(const unsigned char *start_addr, size_t bytecnt)
 {
- 
-   unsigned char serNum [] = "DS0008D-0111A";
-   unsigned short checksum;
- 
-   checksum = CalcChksum(serNum, 13);
-    
-cout << hex << checksum << "\n" << "\n"; //Here I get only the first byte 2B on the output, should be FD 2B;
-}
- 
-unsigned short CalcChksum(unsigned char *start_addr, int bytecnt)
-{
-   int i;
-   unsigned short chksum;
- 
-   chksum = 0;
+   unsigned long chksum = 0;
+   size_t i;
+
    // Calculate 1's complement chksum
    for(i=0; i<bytecnt; i++)
-      chksum+= (unsigned short)*(start_addr+i);
-   chksum = (char)~chksum;
-   return(chksum);
- 
+      chksum += start_addr[i];
+   while(chksum >> 16)
+      chksum = (chksum & 0xFFFF) + (chksum >> 16);
+   return (unsigned short)~chksum;
+}
+
+int main(void)
+{
+   unsigned char serNum [] = "DS0008D-0111A";
+   size_t len = strlen((const char *)serNum);
+
+   printf("%X\n", CalcChksum(serNum, len)); // FD2B
+
+   // Over 16-bit words, as in IP/TCP/UDP headers, and the CRCs of the same bytes (checksum.h)
+   printf("RFC 1071: %04X\n", inet_checksum(serNum, len));
+   printf("CRC-32:   %08X\n", crc32_update(0, serNum, len));
+   printf("CRC-32C:  %08X\n", crc32c_update(0, serNum, len));
+   return 0;
 }
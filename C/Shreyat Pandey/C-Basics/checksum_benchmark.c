@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "checksum.h"
+#include "../../bench_harness.h"
+
+/* checksum.h against textbook loops, on a 64-byte and a 1500-byte packet, 64 KiB and 16 MiB:
+   - inet/...: calcchksum (checksum_basic.c, one byte at a time), rfc1071 (the sample code of
+     RFC 1071: 16-bit words into a 32-bit sum), scalar (64-bit sum), avx2,
+   - crc32/...: bitwise (one bit per step), sarwate (one table, one byte per step), slice8,
+   - crc32c/...: bitwise, slice8, sse42 (one crc32 stream), sse42_x3 (three streams, pclmul
+     to join them).
+   Every version is first checked against the bitwise / RFC 1071 loop on random lengths and
+   offsets, and the streaming and combine functions against one-shot results.
+   Usage: ./checksum_benchmark [max_bytes] [bench_harness options]   (default 16 MiB) */
+
+enum { INET, CRC32, CRC32C };
+
+struct variant {
+    const char *name;
+    int kind;
+    uint32_t (*fn)(const void *data, size_t len);
+};
+
+/* ---------------- textbook versions ---------------- */
+
+// checksum_basic.c: not the same checksum, timed as the starting point
+static uint32_t inet_calcchksum(const void *data, size_t len) {
+    const unsigned char *p = data;
+    unsigned long sum = 0;
+    for (size_t i = 0; i < len; i++) sum += p[i];
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+static uint32_t inet_rfc1071(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint32_t sum = 0;
+    for (; len > 1; len -= 2, p += 2) sum += (uint32_t)(p[0] << 8 | p[1]);
+    if (len) sum += (uint32_t)p[0] << 8;
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+static uint32_t crc_bitwise(uint32_t crc, const unsigned char *p, size_t len, uint32_t poly) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) crc = crc >> 1 ^ (poly & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static uint32_t crc_sarwate(uint32_t crc, const unsigned char *p, size_t len, const uint32_t t[256]) {
+    crc = ~crc;
+    while (len--) crc = crc >> 8 ^ t[(crc ^ *p++) & 0xFF];
+    return ~crc;
+}
+
+/* ---------------- variants, whole buffers ---------------- */
+
+static uint32_t inet_with(uint64_t (*sum)(const void *, size_t), const void *data, size_t len) {
+    uint16_t s = (uint16_t)~inet_fold(sum(data, len));
+    return BYTE_ORDER_HOST_BIG ? s : __builtin_bswap16(s);
+}
+
+static uint32_t inet_scalar(const void *data, size_t len) { return inet_with(inet_sum_scalar, data, len); }
+static uint32_t crc32_bitwise(const void *data, size_t len) { return crc_bitwise(0, data, len, CRC32_POLY); }
+static uint32_t crc32_sarwate(const void *data, size_t len) { return crc_sarwate(0, data, len, crc32_table[0]); }
+static uint32_t crc32_slice8_0(const void *data, size_t len) { return crc32_slice8(0, data, len); }
+static uint32_t crc32c_bitwise(const void *data, size_t len) { return crc_bitwise(0, data, len, CRC32C_POLY); }
+static uint32_t crc32c_slice8_0(const void *data, size_t len) { return crc32c_slice8(0, data, len); }
+#if CHECKSUM_X86
+static uint32_t inet_avx2(const void *data, size_t len) { return inet_with(inet_sum_avx2, data, len); }
+static uint32_t crc32c_sse42_0(const void *data, size_t len) { return crc32c_sse42(0, data, len); }
+static uint32_t crc32c_sse42_x3_0(const void *data, size_t len) { return crc32c_sse42_x3(0, data, len); }
+#endif
+
+struct checksum_job {
+    const struct variant *v;
+    const void *data;
+    size_t len;
+};
+
+static void bench_checksum(void *ctx, uint64_t iters) {
+    struct checksum_job *job = ctx;
+    for (uint64_t i = 0; i < iters; ++i) {
+        uint32_t r = job->v->fn(job->data, job->len);
+        BENCH_DO_NOT_OPTIMIZE(r);
+        BENCH_CLOBBER_MEMORY();
+    }
+}
+
+// Against the first variant of the same kind; returns the number of mismatches
+static int verify(const struct variant *v, const struct variant *reference) {
+    enum { SIZE = 1 << 17 };
+    static unsigned char data[SIZE];
+    uint64_t rng = 19;
+    int bad = 0;
+    for (size_t i = 0; i < SIZE; ++i) data[i] = (unsigned char)bench_next_random(&rng);
+    for (int round = 0; round < 2000; ++round) {
+        // Long enough for several three-stream blocks, and 0xFF runs for carries
+        size_t len = (size_t)(bench_next_random(&rng) % (round % 8 ? 2000 : SIZE - 64));
+        size_t offset = (size_t)(bench_next_random(&rng) % 64);
+        if (round % 16 == 3) memset(data + offset, 0xFF, len);
+        bad += v->fn(data + offset, len) != reference->fn(data + offset, len);
+    }
+    return bad;
+}
+
+// Streaming and combine against one-shot results; returns the number of mismatches
+static int verify_streaming(void) {
+    enum { SIZE = 1 << 16 };
+    static unsigned char data[SIZE + 2];
+    uint64_t rng = 23;
+    int bad = 0;
+    for (size_t i = 0; i < SIZE; ++i) data[i] = (unsigned char)bench_next_random(&rng);
+    bad += crc32_update(0, "123456789", 9) != 0xCBF43926u || crc32c_update(0, "123456789", 9) != 0xE3069283u;
+    for (int round = 0; round < 500; ++round) {
+        size_t len = (size_t)(bench_next_random(&rng) % SIZE);
+        struct inet_csum c;
+        inet_csum_init(&c);
+        uint32_t crc = 0, crcc = 0;
+        for (size_t at = 0; at < len;) {
+            size_t piece = (size_t)(bench_next_random(&rng) % (round % 2 ? 16 : 20000)) + 1;
+            if (piece > len - at) piece = len - at;
+            inet_csum_update(&c, data + at, piece);
+            crc = crc32_update(crc, data + at, piece);
+            crcc = crc32c_update(crcc, data + at, piece);
+            at += piece;
+        }
+        bad += inet_csum_final(&c) != inet_rfc1071(data, len);
+        bad += crc != crc32_bitwise(data, len) || crcc != crc32c_bitwise(data, len);
+
+        size_t split = len ? (size_t)(bench_next_random(&rng) % len) : 0;
+        bad += crc32_combine(crc32_update(0, data, split), crc32_update(0, data + split, len - split), len - split) != crc;
+        bad += crc32c_combine(crc32c_update(0, data, split), crc32c_update(0, data + split, len - split), len - split) != crcc;
+
+        // With its checksum appended on an even offset, a buffer checks to 0
+        size_t even = len & ~(size_t)1;
+        uint16_t sum = inet_checksum(data, even);
+        unsigned char saved[2] = {data[even], data[even + 1]};
+        data[even] = (unsigned char)(sum >> 8);
+        data[even + 1] = (unsigned char)sum;
+        bad += inet_checksum(data, even + 2) != 0;
+        memcpy(data + even, saved, 2);
+    }
+    return bad;
+}
+
+int main(int argc, char **argv) {
+    size_t max_bytes = (argc > 1 && argv[1][0] != '-') ? strtoull(argv[1], NULL, 10) : ((size_t)16 << 20);
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    struct variant variants[16];
+    int count = 0;
+    variants[count++] = (struct variant){"inet/rfc1071", INET, inet_rfc1071};
+    variants[count++] = (struct variant){"inet/calcchksum", INET, inet_calcchksum};
+    variants[count++] = (struct variant){"inet/scalar", INET, inet_scalar};
+#if CHECKSUM_X86
+    if (__builtin_cpu_supports("avx2")) variants[count++] = (struct variant){"inet/avx2", INET, inet_avx2};
+#endif
+    variants[count++] = (struct variant){"crc32/bitwise", CRC32, crc32_bitwise};
+    variants[count++] = (struct variant){"crc32/sarwate", CRC32, crc32_sarwate};
+    variants[count++] = (struct variant){"crc32/slice8", CRC32, crc32_slice8_0};
+    variants[count++] = (struct variant){"crc32c/bitwise", CRC32C, crc32c_bitwise};
+    variants[count++] = (struct variant){"crc32c/slice8", CRC32C, crc32c_slice8_0};
+#if CHECKSUM_X86
+    if (__builtin_cpu_supports("sse4.2")) variants[count++] = (struct variant){"crc32c/sse42", CRC32C, crc32c_sse42_0};
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul"))
+        variants[count++] = (struct variant){"crc32c/sse42_x3", CRC32C, crc32c_sse42_x3_0};
+#endif
+
+    int failures = 0;
+    for (int v = 0; v < count; ++v) {
+        const struct variant *reference = variants;
+        while (reference->kind != variants[v].kind) ++reference;
+        if (reference == &variants[v] || variants[v].fn == inet_calcchksum) continue;
+        int bad = verify(&variants[v], reference);
+        failures += bad;
+        printf("check %-16s %s\n", variants[v].name, bad ? "MISMATCH" : "ok");
+    }
+    int bad = verify_streaming();
+    failures += bad;
+    printf("check %-16s %s\n", "streaming", bad ? "MISMATCH" : "ok");
+    printf("dispatch: %s\n\n", checksum_isa());
+
+    size_t buffer_bytes = (max_bytes + 4095) & ~(size_t)4095;
+    unsigned char *data = aligned_alloc(4096, buffer_bytes);
+    if (!data) return 1;
+    uint64_t rng = 29;
+    for (size_t i = 0; i < buffer_bytes; ++i) data[i] = (unsigned char)bench_next_random(&rng);
+
+    static const size_t sizes[] = {64, 1500, 65536, (size_t)16 << 20};
+    char name[64];
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= max_bytes; ++s) {
+        for (int v = 0; v < count; ++v) {
+            struct checksum_job job = {&variants[v], data, sizes[s]};
+            snprintf(name, sizeof(name), "%s/%zu", variants[v].name, sizes[s]);
+            bench_set_bytes(bench_run(&session, name, bench_checksum, &job), (double)sizes[s]);
+        }
+    }
+
+    free(data);
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
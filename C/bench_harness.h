@@ -0,0 +1,395 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+/* Small header-only micro-benchmark harness, usable from C (C99) and C++.
+
+   What it does for every benchmark:
+   - warm-up: runs the body until warmup_sec has elapsed (caches, branch predictors, page faults,
+     CPU frequency ramp-up),
+   - adaptive iteration count: grows the batch size until one batch lasts min_rep_sec, so the
+     clock resolution is negligible,
+   - repetitions: times 'repetitions' batches and reports ns/op as median, MAD (median absolute
+     deviation), min/max and p5/p95/p99,
+   - optional hardware counters through perf_event_open (cycles, instructions, cache misses per op),
+     silently skipped when the kernel refuses (perf_event_paranoid, containers, non-Linux),
+   - JSON output for regression tracking.
+
+   Usage (C):
+       static void body(void *ctx, uint64_t iters) {
+           for (uint64_t i = 0; i < iters; ++i) { int r = work(ctx); BENCH_DO_NOT_OPTIMIZE(r); }
+       }
+       int main(int argc, char **argv) {
+           bench_session_t s;
+           bench_session_init(&s, argc, argv);
+           bench_run(&s, "work", body, NULL);
+           return bench_session_finish(&s);
+       }
+   Usage (C++): bench::run(&s, "work", [&](uint64_t iters) { ... });
+
+   Command line options understood by bench_session_init():
+       --json=FILE   write JSON results to FILE ("-" for stdout)
+       --reps=N      repetitions per benchmark (default 15)
+       --min-time=S  minimum seconds per repetition (default 0.01)
+       --warmup=S    warm-up seconds (default 0.05)
+       --perf        enable hardware counters
+       --filter=STR  run only benchmarks whose name contains STR
+   Other arguments are ignored, so programs can keep their own positional parameters.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define BENCH_HAVE_PERF 1
+#else
+#define BENCH_HAVE_PERF 0
+#endif
+
+#define BENCH_MAX_REPS 101
+#define BENCH_MAX_RESULTS 128
+
+/* Keep the compiler from deleting a computation whose result is otherwise unused */
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_DO_NOT_OPTIMIZE(x) __asm__ __volatile__("" : : "r,m"(x) : "memory")
+#define BENCH_CLOBBER_MEMORY() __asm__ __volatile__("" : : : "memory")
+#else
+static volatile uint64_t bench_sink;
+#define BENCH_DO_NOT_OPTIMIZE(x) (bench_sink = (uint64_t)(uintptr_t)&(x))
+#define BENCH_CLOBBER_MEMORY() ((void)0)
+#endif
+
+/* xorshift64: cheap pseudo-random test data that is the same on every run (state must not be 0) */
+static inline uint64_t bench_next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+typedef void (*bench_fn)(void *ctx, uint64_t iterations);
+
+typedef struct {
+    int repetitions;
+    double min_rep_sec;
+    double warmup_sec;
+    int use_perf;
+    const char *json_path;
+    const char *filter;
+} bench_config_t;
+
+typedef struct {
+    char name[96];
+    uint64_t iterations;      /* per repetition */
+    int repetitions;
+    double ns_per_op[BENCH_MAX_REPS];
+    double median, mad, min, max, p5, p95, p99;
+    double bytes_per_op;      /* optional, set with bench_set_bytes() for GB/s reporting */
+    double items_per_op;      /* optional, set with bench_set_items() */
+    int perf_valid;
+    double cycles_per_op, instructions_per_op, cache_misses_per_op;
+} bench_result_t;
+
+typedef struct {
+    bench_config_t cfg;
+    bench_result_t results[BENCH_MAX_RESULTS];
+    size_t count;
+    int perf_fd[3];
+} bench_session_t;
+
+static inline double bench_now_sec(void) {
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* ---------------- hardware counters ---------------- */
+
+#if BENCH_HAVE_PERF
+static inline int bench_perf_open(uint32_t type, uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group_fd == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+static inline void bench_perf_setup(bench_session_t *s) {
+    s->perf_fd[0] = s->perf_fd[1] = s->perf_fd[2] = -1;
+#if BENCH_HAVE_PERF
+    if (!s->cfg.use_perf) return;
+    s->perf_fd[0] = bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (s->perf_fd[0] < 0) {
+        fprintf(stderr, "bench: perf_event_open unavailable, hardware counters disabled\n");
+        s->cfg.use_perf = 0;
+        return;
+    }
+    s->perf_fd[1] = bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, s->perf_fd[0]);
+    s->perf_fd[2] = bench_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, s->perf_fd[0]);
+#endif
+}
+
+static inline void bench_perf_start(bench_session_t *s) {
+#if BENCH_HAVE_PERF
+    if (s->perf_fd[0] < 0) return;
+    ioctl(s->perf_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(s->perf_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    (void)s;
+#endif
+}
+
+/* values[0..2] = cycles, instructions, cache misses; returns 0 if not available */
+static inline int bench_perf_stop(bench_session_t *s, uint64_t values[3]) {
+#if BENCH_HAVE_PERF
+    uint64_t buf[1 + 3];
+    ssize_t n;
+    int i;
+    if (s->perf_fd[0] < 0) return 0;
+    ioctl(s->perf_fd[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    n = read(s->perf_fd[0], buf, sizeof(buf));
+    if (n < (ssize_t)(2 * sizeof(uint64_t))) return 0;
+    for (i = 0; i < 3; ++i) values[i] = (i < (int)buf[0]) ? buf[1 + i] : 0;
+    return 1;
+#else
+    (void)s;
+    (void)values;
+    return 0;
+#endif
+}
+
+/* ---------------- statistics ---------------- */
+
+static inline int bench_cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Linear interpolation between closest ranks; 'sorted' must be ascending */
+static inline double bench_percentile(const double *sorted, int n, double p) {
+    double rank = p / 100.0 * (n - 1);
+    int lo = (int)rank;
+    int hi = lo + 1 < n ? lo + 1 : lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+static inline void bench_compute_stats(bench_result_t *r) {
+    double sorted[BENCH_MAX_REPS], dev[BENCH_MAX_REPS];
+    int n = r->repetitions, i;
+    memcpy(sorted, r->ns_per_op, sizeof(double) * n);
+    qsort(sorted, n, sizeof(double), bench_cmp_double);
+    r->min = sorted[0];
+    r->max = sorted[n - 1];
+    r->median = bench_percentile(sorted, n, 50);
+    r->p5 = bench_percentile(sorted, n, 5);
+    r->p95 = bench_percentile(sorted, n, 95);
+    r->p99 = bench_percentile(sorted, n, 99);
+    for (i = 0; i < n; ++i) dev[i] = fabs(sorted[i] - r->median);
+    qsort(dev, n, sizeof(double), bench_cmp_double);
+    r->mad = bench_percentile(dev, n, 50);
+}
+
+/* ---------------- session ---------------- */
+
+static inline void bench_session_init(bench_session_t *s, int argc, char **argv) {
+    int i;
+    memset(s, 0, sizeof(*s));
+    s->cfg.repetitions = 15;
+    s->cfg.min_rep_sec = 0.01;
+    s->cfg.warmup_sec = 0.05;
+    for (i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        if (strncmp(a, "--json=", 7) == 0) s->cfg.json_path = a + 7;
+        else if (strncmp(a, "--reps=", 7) == 0) s->cfg.repetitions = atoi(a + 7);
+        else if (strncmp(a, "--min-time=", 11) == 0) s->cfg.min_rep_sec = atof(a + 11);
+        else if (strncmp(a, "--warmup=", 9) == 0) s->cfg.warmup_sec = atof(a + 9);
+        else if (strncmp(a, "--filter=", 9) == 0) s->cfg.filter = a + 9;
+        else if (strcmp(a, "--perf") == 0) s->cfg.use_perf = 1;
+    }
+    if (s->cfg.repetitions < 1) s->cfg.repetitions = 1;
+    if (s->cfg.repetitions > BENCH_MAX_REPS) s->cfg.repetitions = BENCH_MAX_REPS;
+    bench_perf_setup(s);
+}
+
+/* Runs one benchmark; returns its result slot (NULL if filtered out or the table is full) */
+static inline bench_result_t *bench_run(bench_session_t *s, const char *name, bench_fn fn, void *ctx) {
+    bench_result_t *r;
+    uint64_t iters = 1, counters[3], totals[3] = {0, 0, 0};
+    double start, elapsed;
+    int rep, perf_ok = s->cfg.use_perf;
+
+    if (s->cfg.filter && !strstr(name, s->cfg.filter)) return NULL;
+    if (s->count == BENCH_MAX_RESULTS) return NULL;
+    r = &s->results[s->count++];
+    memset(r, 0, sizeof(*r));
+    strncpy(r->name, name, sizeof(r->name) - 1);
+
+    /* Warm-up */
+    start = bench_now_sec();
+    do { fn(ctx, 1); } while (bench_now_sec() - start < s->cfg.warmup_sec);
+
+    /* Grow the batch until it is long enough to time reliably */
+    for (;;) {
+        start = bench_now_sec();
+        fn(ctx, iters);
+        elapsed = bench_now_sec() - start;
+        if (elapsed >= s->cfg.min_rep_sec || iters >= (UINT64_C(1) << 40)) break;
+        /* Jump straight to the estimated size, at most 10x at a time */
+        if (elapsed <= 0) iters *= 10;
+        else {
+            double grow = 1.2 * s->cfg.min_rep_sec / elapsed;
+            iters = (uint64_t)(iters * (grow > 10 ? 10 : (grow < 2 ? 2 : grow)));
+        }
+    }
+
+    r->iterations = iters;
+    r->repetitions = s->cfg.repetitions;
+    for (rep = 0; rep < s->cfg.repetitions; ++rep) {
+        bench_perf_start(s);
+        start = bench_now_sec();
+        fn(ctx, iters);
+        elapsed = bench_now_sec() - start;
+        if (bench_perf_stop(s, counters)) {
+            totals[0] += counters[0];
+            totals[1] += counters[1];
+            totals[2] += counters[2];
+        } else {
+            perf_ok = 0;
+        }
+        r->ns_per_op[rep] = elapsed * 1e9 / (double)iters;
+    }
+    bench_compute_stats(r);
+
+    if (perf_ok) {
+        double ops = (double)iters * s->cfg.repetitions;
+        r->perf_valid = 1;
+        r->cycles_per_op = totals[0] / ops;
+        r->instructions_per_op = totals[1] / ops;
+        r->cache_misses_per_op = totals[2] / ops;
+    }
+
+    printf("%-40s %12.2f ns/op  (MAD %6.2f, p95 %10.2f, %llu iters x %d)",
+           r->name, r->median, r->mad, r->p95, (unsigned long long)iters, r->repetitions);
+    if (r->perf_valid)
+        printf("  %.1f cyc  %.1f ins  %.3f miss", r->cycles_per_op, r->instructions_per_op, r->cache_misses_per_op);
+    printf("\n");
+    return r;
+}
+
+/* Declares how many bytes / logical items one iteration processes (for GB/s, Mitems/s in JSON) */
+static inline void bench_set_bytes(bench_result_t *r, double bytes_per_op) { if (r) r->bytes_per_op = bytes_per_op; }
+static inline void bench_set_items(bench_result_t *r, double items_per_op) { if (r) r->items_per_op = items_per_op; }
+
+/* Writes str as a JSON string literal: quotes, backslashes and control characters escaped */
+static inline void bench_write_json_string(FILE *out, const char *str) {
+    const unsigned char *p;
+    fputc('"', out);
+    for (p = (const unsigned char *)str; *p; ++p) {
+        if (*p == '"' || *p == '\\') fprintf(out, "\\%c", *p);
+        else if (*p < 0x20) fprintf(out, "\\u%04x", *p);
+        else fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+static inline void bench_write_json(const bench_session_t *s, FILE *out) {
+    size_t i;
+    int k;
+    fprintf(out, "{\n  \"context\": {\"repetitions\": %d, \"min_rep_sec\": %g, \"warmup_sec\": %g, \"perf\": %d},\n",
+            s->cfg.repetitions, s->cfg.min_rep_sec, s->cfg.warmup_sec, s->cfg.use_perf);
+    fprintf(out, "  \"benchmarks\": [\n");
+    for (i = 0; i < s->count; ++i) {
+        const bench_result_t *r = &s->results[i];
+        fprintf(out, "    {\"name\": ");
+        bench_write_json_string(out, r->name);
+        fprintf(out, ", \"iterations\": %llu, \"repetitions\": %d,\n", (unsigned long long)r->iterations,
+                r->repetitions);
+        fprintf(out, "     \"ns_per_op\": {\"median\": %.4f, \"mad\": %.4f, \"min\": %.4f, \"max\": %.4f, "
+                     "\"p5\": %.4f, \"p95\": %.4f, \"p99\": %.4f},\n",
+                r->median, r->mad, r->min, r->max, r->p5, r->p95, r->p99);
+        fprintf(out, "     \"samples\": [");
+        for (k = 0; k < r->repetitions; ++k) fprintf(out, "%s%.4f", k ? ", " : "", r->ns_per_op[k]);
+        fprintf(out, "]");
+        if (r->bytes_per_op > 0) fprintf(out, ",\n     \"gb_per_sec\": %.4f", r->bytes_per_op / r->median);
+        if (r->items_per_op > 0) fprintf(out, ",\n     \"mitems_per_sec\": %.4f", r->items_per_op * 1e3 / r->median);
+        if (r->perf_valid)
+            fprintf(out, ",\n     \"counters\": {\"cycles_per_op\": %.4f, \"instructions_per_op\": %.4f, "
+                         "\"cache_misses_per_op\": %.6f}",
+                    r->cycles_per_op, r->instructions_per_op, r->cache_misses_per_op);
+        fprintf(out, "}%s\n", i + 1 < s->count ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+/* Writes JSON if requested, closes counters. Returns 0 so main() can 'return bench_session_finish(&s);' */
+static inline int bench_session_finish(bench_session_t *s) {
+    int i;
+    if (s->cfg.json_path) {
+        if (strcmp(s->cfg.json_path, "-") == 0) {
+            bench_write_json(s, stdout);
+        } else {
+            FILE *f = fopen(s->cfg.json_path, "w");
+            if (f) {
+                bench_write_json(s, f);
+                fclose(f);
+            } else {
+                fprintf(stderr, "bench: cannot write %s\n", s->cfg.json_path);
+            }
+        }
+    }
+#if BENCH_HAVE_PERF
+    for (i = 0; i < 3; ++i)
+        if (s->perf_fd[i] >= 0) close(s->perf_fd[i]);
+#else
+    (void)i;
+#endif
+    return 0;
+}
+
+#ifdef __cplusplus
+#include <type_traits>
+#include <utility>
+
+namespace bench {
+
+// Any value, including class types, forced to be materialised
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    __asm__ __volatile__("" : : "r,m"(value) : "memory");
+#else
+    bench_sink = reinterpret_cast<uintptr_t>(&value);
+#endif
+}
+
+inline void clobberMemory() { BENCH_CLOBBER_MEMORY(); }
+
+// Lambda-friendly wrapper: body(iterations)
+template <typename Body>
+inline bench_result_t* run(bench_session_t* s, const char* name, Body&& body) {
+    using B = typename std::remove_reference<Body>::type;
+    return bench_run(s, name, [](void* ctx, uint64_t iters) { (*static_cast<B*>(ctx))(iters); },
+                     const_cast<void*>(static_cast<const void*>(&body)));
+}
+
+} // namespace bench
+#endif
+
+#endif /* BENCH_HARNESS_H */
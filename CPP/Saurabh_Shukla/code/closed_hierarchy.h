@@ -0,0 +1,128 @@
+#ifndef CLOSED_HIERARCHY_H
+#define CLOSED_HIERARCHY_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/* Polymorphism without vtables, for hierarchies whose set of types is known up front
+   (virtual_function.cpp, pure_virtual_function.cpp, inheritance.cpp).
+   - StaticInterface<Derived> (CRTP): the base calls the derived implementation through
+     static_cast, resolved at compile time and inlinable. No vptr in the object. Use it when
+     the concrete type is known where the call is made (templates, TypeBatches below).
+   - VariantVector<Ts...>: one vector of std::variant<Ts...>. Objects are stored by value
+     (no pointer chase) and std::visit dispatches on the stored index, which the compiler
+     turns into a jump table or a compare chain it can inline through.
+   - TypeBatches<Ts...>: one vector per type. for_each(f) runs f over all Circles, then all
+     Rectangles, ...: inside each batch the call target never changes, so there is no
+     per-object dispatch at all and the loops can be vectorized. Insertion order across types
+     is not kept.
+   - overloaded{lambda...} builds a visitor out of one lambda per type.
+*/
+
+template <typename Derived>
+class StaticInterface {
+protected:
+    Derived& self() { return static_cast<Derived&>(*this); }
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <typename... Fs>
+struct overloaded : Fs... {
+    using Fs::operator()...;
+};
+template <typename... Fs>
+overloaded(Fs...) -> overloaded<Fs...>;
+
+template <typename... Ts>
+using VariantVector = std::vector<std::variant<Ts...>>;
+
+// Calls f on every element of a VariantVector with the element's concrete type
+template <typename F, typename... Ts>
+void visit_all(VariantVector<Ts...>& items, F&& f) {
+    for (auto& item : items) std::visit(f, item);
+}
+template <typename F, typename... Ts>
+void visit_all(const VariantVector<Ts...>& items, F&& f) {
+    for (const auto& item : items) std::visit(f, item);
+}
+
+template <typename... Ts>
+class TypeBatches {
+    static_assert(sizeof...(Ts) > 0, "TypeBatches needs at least one type");
+
+    template <typename T>
+    static constexpr bool kIsMember = (std::is_same_v<T, Ts> || ...);
+
+public:
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        static_assert(kIsMember<T>, "type is not part of this TypeBatches");
+        return batch<T>().emplace_back(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    void push_back(T&& value) {
+        emplace<std::decay_t<T>>(std::forward<T>(value));
+    }
+
+    // All objects of one type, contiguous
+    template <typename T>
+    std::vector<T>& batch() {
+        return std::get<std::vector<T>>(batches);
+    }
+    template <typename T>
+    const std::vector<T>& batch() const {
+        return std::get<std::vector<T>>(batches);
+    }
+
+    // f(obj) for every object, one type at a time
+    template <typename F>
+    void for_each(F&& f) {
+        std::apply([&f](auto&... vectors) { (forEachIn(vectors, f), ...); }, batches);
+    }
+    template <typename F>
+    void for_each(F&& f) const {
+        std::apply([&f](const auto&... vectors) { (forEachIn(vectors, f), ...); }, batches);
+    }
+
+    // f(std::vector<T>&) for every type: for loops that want a whole batch at once
+    template <typename F>
+    void for_each_batch(F&& f) {
+        std::apply([&f](auto&... vectors) { (f(vectors), ...); }, batches);
+    }
+
+    size_t size() const {
+        return std::apply([](const auto&... vectors) { return (vectors.size() + ...); }, batches);
+    }
+    bool empty() const { return size() == 0; }
+
+    template <typename T>
+    void reserve(size_t n) {
+        batch<T>().reserve(n);
+    }
+    void clear() {
+        for_each_batch([](auto& v) { v.clear(); });
+    }
+
+    // O(1) removal of batch<T>()[i]: the last object of that type takes its place
+    template <typename T>
+    void erase_unordered(size_t i) {
+        std::vector<T>& v = batch<T>();
+        if (i + 1 != v.size()) v[i] = std::move(v.back());
+        v.pop_back();
+    }
+
+private:
+    std::tuple<std::vector<Ts>...> batches;
+
+    template <typename Vector, typename F>
+    static void forEachIn(Vector& v, F& f) {
+        for (auto& item : v) f(item);
+    }
+};
+
+#endif // CLOSED_HIERARCHY_H
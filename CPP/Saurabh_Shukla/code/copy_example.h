@@ -0,0 +1,141 @@
+#ifndef COPY_EXAMPLE_H
+#define COPY_EXAMPLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <utility>
+
+/* CopyExample with two copy modes:
+   - Deep copy: every copy allocates and copies the characters (always safe, costs O(n) per copy).
+   - Copy-on-write: copies share one reference-counted, immutable buffer (O(1) per copy, as fast as
+     the old shallow copy). The first mutation through a copy whose buffer is shared detaches it
+     (allocates a private copy); unshared buffers are mutated in place.
+   The old shallow mode handed out the same char* without ownership: freeing it in every copy
+   double-frees, freeing it in none leaks. Copy-on-write gives the speed of the shallow copy with
+   the safety of the deep copy.
+*/
+
+class CopyExample {
+public:
+    static inline bool logging = true;                        // Set to false for benchmarks
+    static inline std::atomic<size_t> liveBufferBytes{0};     // Heap bytes held by all buffers
+
+    // Constructor (isDeepCopy = false selects copy-on-write)
+    CopyExample(const char* s, bool isDeepCopy = true) : deepCopy(isDeepCopy) {
+        buf = Buffer::create(s, strlen(s));
+    }
+
+    // Copy Constructor (Handles both Deep Copy and Copy-on-Write)
+    CopyExample(const CopyExample& obj) : deepCopy(obj.deepCopy) {
+        if (deepCopy) {
+            buf = Buffer::create(obj.buf->data, obj.buf->length); // Perform Deep Copy
+            if (logging) std::cout << "Deep Copy performed.\n";
+        } else {
+            buf = Buffer::share(obj.buf); // Share the buffer, just bump its count
+            if (logging) std::cout << "Copy-on-Write copy performed (buffer shared).\n";
+        }
+    }
+
+    // Steals the buffer; the source is left holding the static empty buffer (no allocation)
+    CopyExample(CopyExample&& obj) noexcept : buf(obj.buf), deepCopy(obj.deepCopy) {
+        obj.buf = &emptyBuffer;
+    }
+
+    CopyExample& operator=(CopyExample other) noexcept { // Copy-and-swap covers both modes
+        std::swap(buf, other.buf);
+        std::swap(deepCopy, other.deepCopy);
+        return *this;
+    }
+
+    // Display function
+    void display() const {
+        std::cout << "String: " << buf->data << std::endl;
+    }
+
+    // ✅ Read access never copies
+    const char* c_str() const { return buf->data; }
+    size_t length() const { return buf->length; }
+    char charAt(size_t i) const { return buf->data[i]; }
+    bool sharesBufferWith(const CopyExample& other) const { return buf == other.buf; }
+
+    // ✅ Write access detaches a shared buffer first
+    void setChar(size_t i, char c) {
+        detach(buf->length);
+        buf->data[i] = c;
+    }
+
+    void append(const char* s) {
+        size_t extra = strlen(s);
+        detach(buf->length + extra);
+        memcpy(buf->data + buf->length, s, extra + 1);
+        buf->length += extra;
+    }
+
+    // Destructor
+    ~CopyExample() {
+        Buffer::release(buf); // Frees only when the last sharer goes away
+    }
+
+private:
+    // Header + characters in one allocation
+    struct Buffer {
+        std::atomic<int> refs;
+        size_t length;
+        size_t capacity;
+        char data[1];
+
+        static size_t bytesFor(size_t capacity) { return offsetof(Buffer, data) + capacity + 1; }
+
+        static Buffer* create(const char* s, size_t n, size_t capacity = 0) {
+            if (capacity < n) capacity = n;
+            void* mem = ::operator new(bytesFor(capacity));
+            Buffer* b = new (mem) Buffer;
+            b->refs.store(1, std::memory_order_relaxed);
+            b->length = n;
+            b->capacity = capacity;
+            memcpy(b->data, s, n);
+            b->data[n] = '\0';
+            liveBufferBytes += bytesFor(capacity);
+            return b;
+        }
+
+        // The static empty buffer is not counted: its count stays 0, so a write always replaces it
+        static Buffer* share(Buffer* b) {
+            if (b != &emptyBuffer) b->refs.fetch_add(1, std::memory_order_relaxed);
+            return b;
+        }
+
+        static void release(Buffer* b) {
+            if (b == &emptyBuffer) return;
+            if (b->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                liveBufferBytes -= bytesFor(b->capacity);
+                b->~Buffer();
+                ::operator delete(b);
+                if (logging) std::cout << "Memory Freed.\n";
+            }
+        }
+    };
+
+    static inline Buffer emptyBuffer{}; // "" held by moved-from objects, zero-initialized, never freed
+
+    Buffer* buf;
+    bool deepCopy; // Flag to indicate deep copy or copy-on-write
+
+    // Makes the buffer private and large enough for 'capacity' characters
+    void detach(size_t capacity) {
+        bool shared = buf->refs.load(std::memory_order_acquire) != 1;
+        if (!shared && buf->capacity >= capacity) return; // Sole owner: mutate in place
+        size_t grown = capacity > buf->capacity ? (capacity > 2 * buf->capacity ? capacity : 2 * buf->capacity)
+                                                : buf->capacity;
+        Buffer* fresh = Buffer::create(buf->data, buf->length, grown);
+        shared = shared && buf != &emptyBuffer;
+        Buffer::release(buf);
+        buf = fresh;
+        if (logging && shared) std::cout << "Copy-on-Write: buffer detached on write.\n";
+    }
+};
+
+#endif // COPY_EXAMPLE_H
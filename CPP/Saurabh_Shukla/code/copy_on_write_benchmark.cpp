@@ -0,0 +1,64 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include "copy_example.h"
+#include "../../../C/bench_harness.h"
+
+/* Read-mostly workload for CopyExample: deep copy against copy-on-write.
+   One iteration: make 'copies' copies of one source string, read every character of every copy,
+   and mutate 1% of the copies. Also reports the heap bytes held while all copies are alive.
+   Usage: ./copy_on_write_benchmark [copies] [bench_harness options]   (default 10,000) */
+
+template <bool Deep>
+void readMostly(size_t copies, size_t length, uint64_t iters) {
+    std::string text(length, 'x');
+    CopyExample source(text.c_str(), Deep);
+    for (uint64_t it = 0; it < iters; ++it) {
+        std::vector<CopyExample> v;
+        v.reserve(copies);
+        for (size_t i = 0; i < copies; ++i) v.push_back(source);
+
+        unsigned long sum = 0;
+        for (const CopyExample& c : v)
+            for (size_t k = 0; k < c.length(); ++k) sum += static_cast<unsigned char>(c.charAt(k));
+        for (size_t i = 0; i < copies; i += 100) v[i].setChar(0, 'y'); // 1% writes
+        bench::doNotOptimize(sum);
+    }
+}
+
+template <bool Deep>
+size_t bytesWhileAlive(size_t copies, size_t length) {
+    std::string text(length, 'x');
+    size_t before = CopyExample::liveBufferBytes.load();
+    CopyExample source(text.c_str(), Deep);
+    std::vector<CopyExample> v;
+    v.reserve(copies);
+    for (size_t i = 0; i < copies; ++i) v.push_back(source);
+    for (size_t i = 0; i < copies; i += 100) v[i].setChar(0, 'y');
+    return CopyExample::liveBufferBytes.load() - before;
+}
+
+int main(int argc, char** argv) {
+    size_t copies = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+    CopyExample::logging = false;
+
+    const size_t lengths[] = {16, 256, 4096};
+    for (size_t length : lengths) {
+        std::string suffix = "/len" + std::to_string(length);
+        bench_set_items(bench::run(&session, ("deep_copy" + suffix).c_str(),
+                                   [&](uint64_t n) { readMostly<true>(copies, length, n); }),
+                        static_cast<double>(copies));
+        bench_set_items(bench::run(&session, ("copy_on_write" + suffix).c_str(),
+                                   [&](uint64_t n) { readMostly<false>(copies, length, n); }),
+                        static_cast<double>(copies));
+
+        size_t deepBytes = bytesWhileAlive<true>(copies, length);
+        size_t cowBytes = bytesWhileAlive<false>(copies, length);
+        std::cout << "    heap bytes for " << copies << " copies: deep " << deepBytes << ", copy-on-write "
+                  << cowBytes << " (" << 100.0 * (1.0 - static_cast<double>(cowBytes) / deepBytes) << "% saved)\n";
+    }
+    return bench_session_finish(&session);
+}
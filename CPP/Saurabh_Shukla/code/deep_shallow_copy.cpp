@@ -1,49 +1,10 @@
 #include <iostream>
 #include <cstring>
+#include "copy_example.h"
 
-class CopyExample {
-private:
-    char* str;
-    bool deepCopy;  // Flag to indicate deep or shallow copy
-
-public:
-    // Constructor
-    CopyExample(const char* s, bool isDeepCopy = true) : deepCopy(isDeepCopy) {
-        str = new char[strlen(s) + 1];
-        strcpy(str, s);
-    }
-
-    // Copy Constructor (Handles both Deep and Shallow Copy)
-    CopyExample(const CopyExample& obj) {
-        deepCopy = obj.deepCopy;  // Copy the flag
-
-        if (deepCopy) {
-            // Perform Deep Copy
-            str = new char[strlen(obj.str) + 1];
-            strcpy(str, obj.str);
-            std::cout << "Deep Copy performed.\n";
-        } else {
-            // Perform Shallow Copy
-            str = obj.str;
-            std::cout << "Shallow Copy performed.\n";
-        }
-    }
-
-    // Display function
-    void display() {
-        std::cout << "String: " << str << std::endl;
-    }
-
-    // Destructor
-    ~CopyExample() {
-        if (deepCopy) {
-            delete[] str;  // Free memory only in deep copy mode
-            std::cout << "Memory Freed (Deep Copy).\n";
-        } else {
-            std::cout << "Shallow Copy - No memory freed.\n";
-        }
-    }
-};
+/* CopyExample lives in copy_example.h. The unsafe shallow-copy mode (shared char* that was either
+   leaked or double-freed) is replaced by copy-on-write: copies share a reference-counted buffer
+   and the first write through a shared copy gives it a private one. */
 
 int main() {
     std::cout << "Creating obj1 (Deep Copy)...\n";
@@ -55,16 +16,24 @@ int main() {
     obj1.display();
     obj2.display();
 
-    std::cout << "\nCreating obj3 (Shallow Copy)...\n";
-    CopyExample obj3("World", false);  // Shallow Copy enabled
+    std::cout << "\nCreating obj3 (Copy-on-Write)...\n";
+    CopyExample obj3("World", false);  // Copy-on-Write enabled
+
+    std::cout << "\nCopying obj3 to obj4 (Copy-on-Write)...\n";
+    CopyExample obj4 = obj3;  // Shares obj3's buffer, no allocation
 
-    std::cout << "\nCopying obj3 to obj4 (Shallow Copy)...\n";
-    CopyExample obj4 = obj3;  // Shallow Copy
+    obj3.display();
+    obj4.display();
+    std::cout << "obj3 and obj4 share a buffer: " << (obj3.sharesBufferWith(obj4) ? "yes" : "no") << "\n";
 
+    std::cout << "\nModifying obj4...\n";
+    obj4.setChar(0, 'w'); // Detaches: obj3 keeps "World"
     obj3.display();
     obj4.display();
+    std::cout << "obj3 and obj4 share a buffer: " << (obj3.sharesBufferWith(obj4) ? "yes" : "no") << "\n\n";
 
     // Destructor will be called automatically for all objects at the end of main()
+    // and every buffer is freed exactly once
 
     return 0;
 }
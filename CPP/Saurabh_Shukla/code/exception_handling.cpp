@@ -1,6 +1,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <exception>
+#include "expected.h"
 
 // Custom exception class
 class CustomException : public std::exception {
@@ -31,6 +32,34 @@ void wrapperFunction(int x) {
     }
 }
 
+// ✅ The same failure modes as return values (expected.h): no throw, no unwinding.
+// Use this style where failures are frequent (hot paths); exceptions stay for rare errors.
+enum class RiskyError { DivisionByZero, Custom, Unknown };
+
+const char* describe(RiskyError e) {
+    switch (e) {
+    case RiskyError::DivisionByZero: return "Division by zero error!";
+    case RiskyError::Custom: return "CustomException occurred!";
+    case RiskyError::Unknown: return "Unknown exception type!";
+    }
+    return "?";
+}
+
+expected<void, RiskyError> riskyChecked(int x) {
+    if (x == 0) return make_unexpected(RiskyError::DivisionByZero);
+    if (x == 1) return make_unexpected(RiskyError::Custom);
+    if (x == 2) return make_unexpected(RiskyError::Unknown);
+    return {};
+}
+
+// Counterpart of wrapperFunction: logs, then passes the error up (the "rethrow")
+expected<void, RiskyError> wrapperChecked(int x) {
+    auto result = riskyChecked(x);
+    if (!result) std::cerr << "wrapperChecked got: " << describe(result.error()) << "\n";
+    EXPECTED_CHECK(result);
+    return {};
+}
+
 // RAII (Resource Acquisition Is Initialization) class
 class ResourceHandler {
 public:
@@ -46,6 +75,9 @@ int main() {
         std::cout << "Enter a number (0-2) to trigger an exception: ";
         std::cin >> testCase;
 
+        if (auto checked = wrapperChecked(testCase); !checked) // Error as a value, handled right here
+            std::cerr << "Checked path returned: " << describe(checked.error()) << "\n";
+
         wrapperFunction(testCase); // Function that catches and rethrows exceptions
         std::cout << "Function executed successfully.\n";
     } 
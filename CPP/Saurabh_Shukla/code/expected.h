@@ -0,0 +1,260 @@
+#ifndef EXPECTED_H
+#define EXPECTED_H
+
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/* expected<T, E>: either a T (success) or an E (error), returned by value.
+   For operations that fail often (division by zero, parse errors), where a throw costs
+   microseconds of unwinding per failure. A failed expected is an ordinary return: same cost
+   as the success path, no unwinding, no heap allocation.
+   - Build:   return value;  /  return make_unexpected(error);
+   - Inspect: if (r) use(*r); else handle(r.error());   value() throws bad_expected_access
+              if there is no value (for callers that do want an exception at the boundary).
+   - Chain:   r.and_then(f)   f(T) -> expected<U, E>, skipped on error
+              r.transform(f)  f(T) -> U, skipped on error
+              r.or_else(f)    f(E) -> expected<T, E>, only called on error
+              r.transform_error(f), r.value_or(fallback)
+   - Early return: EXPECTED_TRY(auto x, expr) declares x = *expr, or returns expr's error from
+     the enclosing function; EXPECTED_CHECK(expr) does the same for expected<void, E>.
+   Same shape as C++23 std::expected, so switching to it later is a rename.
+*/
+
+template <typename E>
+class unexpected {
+public:
+    explicit unexpected(E e) : err(std::move(e)) {}
+    const E& error() const& { return err; }
+    E&& error() && { return std::move(err); }
+
+private:
+    E err;
+};
+
+template <typename E>
+unexpected<std::decay_t<E>> make_unexpected(E&& e) {
+    return unexpected<std::decay_t<E>>(std::forward<E>(e));
+}
+
+template <typename E>
+class bad_expected_access : public std::exception {
+public:
+    explicit bad_expected_access(E e) : err(std::move(e)) {}
+    const char* what() const noexcept override { return "bad_expected_access: expected holds an error"; }
+    const E& error() const { return err; }
+
+private:
+    E err;
+};
+
+template <typename T, typename E>
+class expected;
+
+namespace expected_detail {
+template <typename X>
+struct IsExpected : std::false_type {};
+template <typename T, typename E>
+struct IsExpected<expected<T, E>> : std::true_type {};
+} // namespace expected_detail
+
+template <typename T, typename E>
+class expected {
+public:
+    using value_type = T;
+    using error_type = E;
+
+    expected() : ok(true) { ::new (&val) T(); }
+    expected(const T& v) : ok(true) { ::new (&val) T(v); }
+    expected(T&& v) : ok(true) { ::new (&val) T(std::move(v)); }
+    template <typename G>
+    expected(const unexpected<G>& u) : ok(false) { ::new (&err) E(u.error()); }
+    template <typename G>
+    expected(unexpected<G>&& u) : ok(false) { ::new (&err) E(std::move(u).error()); }
+
+    expected(const expected& o) : ok(o.ok) {
+        if (ok) ::new (&val) T(o.val);
+        else ::new (&err) E(o.err);
+    }
+    expected(expected&& o) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                    std::is_nothrow_move_constructible_v<E>)
+        : ok(o.ok) {
+        if (ok) ::new (&val) T(std::move(o.val));
+        else ::new (&err) E(std::move(o.err));
+    }
+    // Strong guarantee: if building the new member throws, *this keeps its old contents
+    expected& operator=(expected o) {
+        if (ok && o.ok) val = std::move(o.val);
+        else if (!ok && !o.ok) err = std::move(o.err);
+        else if (o.ok) replace(err, val, std::move(o.val));
+        else replace(val, err, std::move(o.err));
+        ok = o.ok;
+        return *this;
+    }
+    ~expected() { destroy(); }
+
+    bool has_value() const noexcept { return ok; }
+    explicit operator bool() const noexcept { return ok; }
+
+    // Unchecked access (like std::optional): only after testing has_value()
+    T& operator*() & { return val; }
+    const T& operator*() const& { return val; }
+    T&& operator*() && { return std::move(val); }
+    T* operator->() { return &val; }
+    const T* operator->() const { return &val; }
+    const E& error() const& { return err; }
+    E&& error() && { return std::move(err); }
+
+    // Checked access: throws bad_expected_access<E> when there is no value
+    T& value() & {
+        if (!ok) throw bad_expected_access<E>(err);
+        return val;
+    }
+    const T& value() const& {
+        if (!ok) throw bad_expected_access<E>(err);
+        return val;
+    }
+    T&& value() && {
+        if (!ok) throw bad_expected_access<E>(err);
+        return std::move(val);
+    }
+
+    template <typename U>
+    T value_or(U&& fallback) const& {
+        return ok ? val : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    // f(T) -> expected<U, E>
+    template <typename F>
+    auto and_then(F&& f) const& {
+        using R = std::invoke_result_t<F, const T&>;
+        static_assert(expected_detail::IsExpected<R>::value, "and_then: f must return an expected");
+        if (ok) return std::forward<F>(f)(val);
+        return R(make_unexpected(err));
+    }
+    template <typename F>
+    auto and_then(F&& f) && {
+        using R = std::invoke_result_t<F, T&&>;
+        static_assert(expected_detail::IsExpected<R>::value, "and_then: f must return an expected");
+        if (ok) return std::forward<F>(f)(std::move(val));
+        return R(make_unexpected(std::move(err)));
+    }
+
+    // f(T) -> U, wrapped as expected<U, E>
+    template <typename F>
+    auto transform(F&& f) const& {
+        using R = expected<std::decay_t<std::invoke_result_t<F, const T&>>, E>;
+        if (ok) return R(std::forward<F>(f)(val));
+        return R(make_unexpected(err));
+    }
+
+    // f(E) -> expected<T, E>: recover from (or replace) an error
+    template <typename F>
+    expected or_else(F&& f) const& {
+        if (ok) return *this;
+        return std::forward<F>(f)(err);
+    }
+
+    // f(E) -> G, wrapped as expected<T, G>
+    template <typename F>
+    auto transform_error(F&& f) const& {
+        using R = expected<T, std::decay_t<std::invoke_result_t<F, const E&>>>;
+        if (ok) return R(val);
+        return R(make_unexpected(std::forward<F>(f)(err)));
+    }
+
+private:
+    union {
+        T val;
+        E err;
+    };
+    bool ok;
+
+    void destroy() {
+        if (ok) val.~T();
+        else err.~E();
+    }
+
+    // Swaps the active member 'from' for a 'to' built from 'src'. When that construction can
+    // throw, 'from' is first moved into a backup and put back if it does.
+    template <typename Old, typename New>
+    static void replace(Old& from, New& to, New&& src) {
+        static_assert(std::is_nothrow_move_constructible_v<Old> || std::is_nothrow_move_constructible_v<New>,
+                      "expected: assignment needs T or E to be nothrow move constructible");
+        if constexpr (std::is_nothrow_move_constructible_v<New>) {
+            from.~Old();
+            ::new (&to) New(std::move(src));
+        } else {
+            Old backup(std::move(from));
+            from.~Old();
+            try {
+                ::new (&to) New(std::move(src));
+            } catch (...) {
+                ::new (&from) Old(std::move(backup));
+                throw;
+            }
+        }
+    }
+};
+
+// expected<void, E>: success carries no value
+template <typename E>
+class expected<void, E> {
+public:
+    using value_type = void;
+    using error_type = E;
+
+    expected() : ok(true), err() {}
+    template <typename G>
+    expected(const unexpected<G>& u) : ok(false), err(u.error()) {}
+    template <typename G>
+    expected(unexpected<G>&& u) : ok(false), err(std::move(u).error()) {}
+
+    bool has_value() const noexcept { return ok; }
+    explicit operator bool() const noexcept { return ok; }
+    const E& error() const& { return err; }
+    E&& error() && { return std::move(err); }
+    void value() const {
+        if (!ok) throw bad_expected_access<E>(err);
+    }
+
+    // f() -> expected<U, E>
+    template <typename F>
+    auto and_then(F&& f) const {
+        using R = std::invoke_result_t<F>;
+        static_assert(expected_detail::IsExpected<R>::value, "and_then: f must return an expected");
+        if (ok) return std::forward<F>(f)();
+        return R(make_unexpected(err));
+    }
+
+    template <typename F>
+    expected or_else(F&& f) const {
+        if (ok) return *this;
+        return std::forward<F>(f)(err);
+    }
+
+private:
+    bool ok;
+    E err; // Default-constructed (unused) on success; errors are small enum/code types
+};
+
+#define EXPECTED_CONCAT_INNER(a, b) a##b
+#define EXPECTED_CONCAT(a, b) EXPECTED_CONCAT_INNER(a, b)
+
+// EXPECTED_TRY(auto x, parse(s));  ->  x is the value, or the function returns parse's error.
+// __COUNTER__ names the temporary, so two uses on one line (e.g. inside another macro) are fine.
+#define EXPECTED_TRY(decl, expr) EXPECTED_TRY_IMPL(EXPECTED_CONCAT(expectedTry_, __COUNTER__), decl, expr)
+#define EXPECTED_TRY_IMPL(tmp, decl, expr)                                                    \
+    auto tmp = (expr);                                                                        \
+    if (!tmp) return make_unexpected(std::move(tmp).error());                                 \
+    decl = *std::move(tmp)
+
+// EXPECTED_CHECK(validate(x));  ->  returns validate's error, if any
+#define EXPECTED_CHECK(expr)                                                                  \
+    do {                                                                                      \
+        auto expectedCheck_ = (expr);                                                         \
+        if (!expectedCheck_) return make_unexpected(std::move(expectedCheck_).error());       \
+    } while (0)
+
+#endif // EXPECTED_H
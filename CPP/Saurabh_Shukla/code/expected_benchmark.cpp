@@ -0,0 +1,118 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <stdexcept>
+#include <charconv>
+#include <cstdlib>
+#include "number.h"
+#include "../../../C/bench_harness.h"
+
+/* Parse two numbers and divide them, over a batch where a given fraction of the divisors is
+   "0" (0%, 1%, 50% failures):
+   - exceptions: parse throws std::invalid_argument, Number::operator/ throws runtime_error,
+     the error crosses two call frames (as in wrapperFunction) and is caught per item,
+   - expected: Number::parse / checkedDivide return expected<Number, NumberError>, chained with
+     and_then / EXPECTED_TRY through the same two frames.
+   Usage: ./expected_benchmark [items] [bench_harness options]   (default 100,000) */
+
+struct Item {
+    std::string numerator, divisor;
+};
+
+// ✅ Exception style (same from_chars parsing as Number::parse, so only error handling differs)
+__attribute__((noinline)) Number parseOrThrow(const std::string& s) {
+    int v = 0;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (s.empty() || ec != std::errc() || end != s.data() + s.size()) throw std::invalid_argument("not a number");
+    return Number(v);
+}
+
+__attribute__((noinline)) Number divideThrowing(const Item& item) {
+    return parseOrThrow(item.numerator) / parseOrThrow(item.divisor);
+}
+
+// ✅ expected style, monadic chaining
+__attribute__((noinline)) expected<Number, NumberError> divideChained(const Item& item) {
+    return Number::parse(item.numerator).and_then([&](const Number& n) {
+        return Number::parse(item.divisor).and_then([&](const Number& d) { return n.checkedDivide(d); });
+    });
+}
+
+// ✅ expected style, early-return macro
+__attribute__((noinline)) expected<Number, NumberError> divideEarlyReturn(const Item& item) {
+    EXPECTED_TRY(Number n, Number::parse(item.numerator));
+    EXPECTED_TRY(Number d, Number::parse(item.divisor));
+    return n.checkedDivide(d);
+}
+
+std::vector<Item> makeItems(size_t count, double failureRate) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::vector<Item> items;
+    items.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int d = coin(rng) < failureRate ? 0 : static_cast<int>(rng() % 1000) + 1;
+        items.push_back({std::to_string(rng() % 1000000), std::to_string(d)});
+    }
+    return items;
+}
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    for (double rate : {0.0, 0.01, 0.5}) {
+        std::vector<Item> items = makeItems(count, rate);
+        std::string suffix = "/fail_" + std::to_string(static_cast<int>(rate * 100)) + "pct";
+        long sums[3] = {0, 0, 0};
+
+        bench_set_items(bench::run(&session, ("exceptions" + suffix).c_str(), [&](uint64_t iters) {
+            for (uint64_t it = 0; it < iters; ++it) {
+                long sum = 0, failures = 0;
+                for (const Item& item : items) {
+                    try {
+                        sum += static_cast<int>(divideThrowing(item));
+                    } catch (const std::exception&) {
+                        ++failures;
+                    }
+                }
+                sums[0] = sum + failures;
+            }
+        }), static_cast<double>(count));
+
+        bench_set_items(bench::run(&session, ("expected_and_then" + suffix).c_str(), [&](uint64_t iters) {
+            for (uint64_t it = 0; it < iters; ++it) {
+                long sum = 0, failures = 0;
+                for (const Item& item : items) {
+                    auto r = divideChained(item);
+                    if (r) sum += static_cast<int>(*r);
+                    else ++failures;
+                }
+                sums[1] = sum + failures;
+            }
+        }), static_cast<double>(count));
+
+        bench_set_items(bench::run(&session, ("expected_try_macro" + suffix).c_str(), [&](uint64_t iters) {
+            for (uint64_t it = 0; it < iters; ++it) {
+                long sum = 0, failures = 0;
+                for (const Item& item : items) {
+                    auto r = divideEarlyReturn(item);
+                    if (r) sum += static_cast<int>(*r);
+                    else ++failures;
+                }
+                sums[2] = sum + failures;
+            }
+        }), static_cast<double>(count));
+
+        std::cout << "    results agree: " << (sums[0] == sums[1] && sums[1] == sums[2] ? "yes" : "NO") << "\n";
+    }
+
+    // ✅ Error reporting at the boundary
+    auto bad = Number::parse("12x").and_then([](const Number& n) { return n.checkedDivide(Number(0)); });
+    auto zero = Number::parse("12").and_then([](const Number& n) { return n.checkedDivide(Number(0)); });
+    std::cout << "\n\"12x\" / 0 -> " << describe(bad.error()) << "\n\"12\" / 0 -> " << describe(zero.error())
+              << "\n\"84\" / 2 -> " << divideEarlyReturn({"84", "2"}).value() << "\n";
+    return bench_session_finish(&session);
+}
@@ -1,5 +1,5 @@
 #include <iostream>
-#include <functional> // For std::function
+#include "inplace_function.h" // For function_ref / inplace_function (non-allocating std::function)
 
 // A regular function
 int multiply(int a, int b) {
@@ -11,11 +11,18 @@ void processWithFunctionPointer(int a, int b, int (*funcPtr)(int, int)) {
     std::cout << "Using Function Pointer: " << funcPtr(a, b) << std::endl;
 }
 
-// Function that accepts std::function (can take function pointer or lambda)
-void processWithStdFunction(int a, int b, std::function<int(int, int)> func) {
-    std::cout << "Using std::function: " << func(a, b) << std::endl;
+// Function that accepts any callable (function pointer or lambda) without owning it.
+// function_ref is two pointers: unlike a std::function parameter, it never allocates
+void processWithFunctionRef(int a, int b, function_ref<int(int, int)> func) {
+    std::cout << "Using function_ref: " << func(a, b) << std::endl;
 }
 
+// A callback that is stored for later: inplace_function keeps the lambda (and its captures)
+// inside itself, so storing it never allocates; captures over 32 bytes fail to compile
+struct Calculator {
+    inplace_function<int(int)> onResult;
+};
+
 int main() {
     int x = 10;
 
@@ -35,8 +42,9 @@ int main() {
     // Calling functions with function pointer
     processWithFunctionPointer(4, 5, funcPtr);
 
-    // Calling function with lambda
-    processWithStdFunction(4, 5, lambdaSimple);
+    // Calling function with lambda (and with the plain function)
+    processWithFunctionRef(4, 5, lambdaSimple);
+    processWithFunctionRef(4, 5, multiply);
 
     // Calling lambda directly
     std::cout << "Calling lambda directly: " << lambdaSimple(6, 7) << std::endl;
@@ -44,5 +52,10 @@ int main() {
     // Calling lambda that captures a variable
     std::cout << "Lambda with capture: " << lambdaWithCapture(20) << std::endl;
 
+    // Storing the capturing lambda as a callback
+    Calculator calc;
+    calc.onResult = lambdaWithCapture;
+    std::cout << "Stored callback: " << calc.onResult(30) << std::endl;
+
     return 0;
 }
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <functional>
+#include <deque>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "inplace_function.h"
+#include "../../../C/bench_harness.h"
+
+/* Callback wrappers from function_pointer_lambda.cpp and the ThreadPool task type:
+   raw function pointer, std::function, inplace_function and function_ref.
+   - call: invoke an already-built wrapper (indirect call overhead),
+   - pass_and_call: build the wrapper from a lambda capturing 32 bytes and call it once, i.e. a
+     callback parameter (std::function's small buffer is 16 bytes in libstdc++, so it allocates),
+   - task_queue: push and pop tasks through a deque, as ThreadPool does.
+   Allocations per operation are printed under each result.
+   Usage: ./function_wrapper_benchmark [calls] [bench_harness options]   (default 1,000,000) */
+
+static std::atomic<uint64_t> allocationCount(0);
+
+static void* countedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// 64-bit operands and product: the loops below sum i * 3 for millions of i, past INT_MAX
+__attribute__((noinline)) long long multiply(long long a, long long b) { return a * b; }
+using BinaryOp = long long(long long, long long);
+
+// The callee side of each API; noinline so every call goes through the wrapper
+__attribute__((noinline)) long long callPointer(long long a, long long b, BinaryOp* f) { return f(a, b); }
+__attribute__((noinline)) long long callStd(long long a, long long b, std::function<BinaryOp> f) { return f(a, b); }
+__attribute__((noinline)) long long callInplace(long long a, long long b, inplace_function<BinaryOp, 32> f) {
+    return f(a, b);
+}
+__attribute__((noinline)) long long callRef(long long a, long long b, function_ref<BinaryOp> f) { return f(a, b); }
+
+int main(int argc, char** argv) {
+    size_t calls = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    auto runCounted = [&](const char* name, auto body) {
+        uint64_t before = allocationCount.load();
+        uint64_t ops = 0;
+        bench_result_t* r = bench::run(&session, name, [&](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) body();
+            ops += iters;
+        });
+        if (r) {
+            bench_set_items(r, static_cast<double>(calls));
+            std::cout << "    allocations per op: "
+                      << static_cast<double>(allocationCount.load() - before) / (static_cast<double>(ops) * calls) << "\n";
+        }
+    };
+
+    // ✅ Call overhead of a pre-built wrapper
+    BinaryOp* pointer = multiply;
+    std::function<BinaryOp> stdFn = multiply;
+    inplace_function<BinaryOp, 32> inplaceFn = multiply;
+    function_ref<BinaryOp> refFn = multiply;
+    bench::doNotOptimize(pointer);
+    runCounted("call/function_pointer", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += pointer(static_cast<long long>(i), 3);
+        bench::doNotOptimize(sum);
+    });
+    runCounted("call/std_function", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += stdFn(static_cast<long long>(i), 3);
+        bench::doNotOptimize(sum);
+    });
+    runCounted("call/inplace_function", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += inplaceFn(static_cast<long long>(i), 3);
+        bench::doNotOptimize(sum);
+    });
+    runCounted("call/function_ref", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += refFn(static_cast<long long>(i), 3);
+        bench::doNotOptimize(sum);
+    });
+
+    // ✅ Passing a capturing lambda as a callback parameter (construct + one call)
+    long long w = 1, x = 2, y = 3, z = 4; // 32 bytes of captures
+    bench::doNotOptimize(w);
+    // Copied into a fresh wrapper on every call below
+    auto capturing = [w, x, y, z](long long a, long long b) { return a * b + w + x + y + z; };
+    runCounted("pass_and_call/function_pointer", [&] {
+        uint64_t sum = 0;
+        // No captures possible
+        for (size_t i = 0; i < calls; ++i) sum += callPointer(static_cast<long long>(i), 3, multiply);
+        bench::doNotOptimize(sum);
+    });
+    runCounted("pass_and_call/std_function", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += callStd(static_cast<long long>(i), 3, capturing);
+        bench::doNotOptimize(sum);
+    });
+    runCounted("pass_and_call/inplace_function", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += callInplace(static_cast<long long>(i), 3, capturing);
+        bench::doNotOptimize(sum);
+    });
+    runCounted("pass_and_call/function_ref", [&] {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < calls; ++i) sum += callRef(static_cast<long long>(i), 3, capturing);
+        bench::doNotOptimize(sum);
+    });
+
+    // ✅ ThreadPool-style task queue: enqueue a capturing task, dequeue and run it
+    auto taskQueue = [&](auto tag) {
+        using Task = decltype(tag);
+        std::deque<Task> tasks;
+        long long sum = 0;
+        for (size_t i = 0; i < calls; ++i) {
+            tasks.push_back([&sum, i, w, x] { sum += static_cast<long long>(i) + w + x; });
+            if (tasks.size() >= 64) {
+                while (!tasks.empty()) {
+                    tasks.front()();
+                    tasks.pop_front();
+                }
+            }
+        }
+        for (auto& t : tasks) t();
+        bench::doNotOptimize(sum);
+    };
+    runCounted("task_queue/std_function", [&] { taskQueue(std::function<void()>()); });
+    runCounted("task_queue/inplace_function", [&] { taskQueue(inplace_function<void(), 64>()); });
+
+    return bench_session_finish(&session);
+}
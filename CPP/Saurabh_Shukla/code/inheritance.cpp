@@ -1,4 +1,5 @@
 #include <iostream>
+#include "closed_hierarchy.h"
 using namespace std;
 
 // Base class
@@ -14,7 +15,7 @@ public:
 // Single Inheritance: Dog inherits from Animal
 class Dog : public Animal {
 public:
-    void bark() { cout << "Dog barks." << endl; }
+    void bark() const { cout << "Dog barks." << endl; }
     void accessProtected() { protectedMethod(); } // Allowed
     // void accessPrivate() { privateMethod(); } // Error: privateMethod is inaccessible
 };
@@ -35,14 +36,14 @@ public:
 
 class Bird : public Animal, public Flyer {
 public:
-    void chirp() { cout << "Bird chirps." << endl; }
+    void chirp() const { cout << "Bird chirps." << endl; }
     void accessFlyerProtected() { protectedFly(); } // Allowed
 };
 
 // Hierarchical Inheritance: Multiple classes inherit from Animal
 class Cat : public Animal {
 public:
-    void meow() { cout << "Cat meows." << endl; }
+    void meow() const { cout << "Cat meows." << endl; }
 };
 
 // Hybrid Inheritance with Virtual Base Class (Diamond Problem Solution)
@@ -81,6 +82,20 @@ public:
     void showOwner() { owner->showOwnership(); }
 };
 
+// Hierarchical inheritance without virtual functions: Dog, Cat and Bird have different
+// methods (bark, meow, chirp), so there is no common virtual to call. A closed set of animal
+// types in a std::variant still gives "do the right thing for each animal" via std::visit.
+using AnyAnimal = std::variant<Dog, Cat, Bird>;
+
+void makeSound(const AnyAnimal& a) {
+    std::visit(overloaded{
+                   [](const Dog& dog) { dog.bark(); },
+                   [](const Cat& cat) { cat.meow(); },
+                   [](const Bird& bird) { bird.chirp(); },
+               },
+               a);
+}
+
 int main() {
     Dog d;
     d.eat(); // Inherited from Animal
@@ -116,5 +131,8 @@ int main() {
     Pet pet(&o);
     pet.showOwner();
 
+    VariantVector<Dog, Cat, Bird> zoo = {Dog(), Cat(), Bird()};
+    for (const AnyAnimal& a : zoo) makeSound(a);
+
     return 0;
 }
@@ -0,0 +1,177 @@
+#ifndef INPLACE_FUNCTION_H
+#define INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/* Two replacements for std::function in callback APIs:
+   - inplace_function<R(Args...), Capacity>: owning, copyable, type-erased like std::function,
+     but the callable always lives in a Capacity-byte buffer inside the object: construction,
+     copy and move never allocate. A callable that does not fit is a compile error
+     (static_assert), not a silent heap allocation. Use it where the callback is stored
+     (task queues, member callbacks).
+   - function_ref<R(Args...)>: non-owning, two pointers, trivially copyable. It refers to a
+     callable that must outlive it, which is always true for a parameter that is only called
+     during the function call. Use it for "call me back now" parameters (cheaper than
+     passing std::function by value, which may allocate just to make the call).
+   Calling an empty inplace_function throws std::bad_function_call, as std::function does.
+*/
+
+template <typename Signature, size_t Capacity = 32, size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+template <typename R, typename... Args, size_t Capacity, size_t Alignment>
+class inplace_function<R(Args...), Capacity, Alignment> {
+    // One static table per stored callable type
+    struct VTable {
+        R (*invoke)(void* self, Args&&... args);
+        void (*copy)(void* dst, const void* src);
+        void (*move)(void* dst, void* src) noexcept; // Move-constructs into dst, destroys src
+        void (*destroy)(void* self) noexcept;
+    };
+
+    template <typename F>
+    static constexpr VTable kVTableFor = {
+        [](void* self, Args&&... args) -> R {
+            return std::invoke(*static_cast<F*>(self), std::forward<Args>(args)...);
+        },
+        [](void* dst, const void* src) { ::new (dst) F(*static_cast<const F*>(src)); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        },
+        [](void* self) noexcept { static_cast<F*>(self)->~F(); },
+    };
+
+    template <typename F>
+    static constexpr bool kIsCallable =
+        !std::is_same_v<std::decay_t<F>, inplace_function> &&
+        std::is_invocable_r_v<R, std::decay_t<F>&, Args...>;
+
+public:
+    static constexpr size_t capacity = Capacity;
+
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template <typename F, std::enable_if_t<kIsCallable<F>, int> = 0>
+    inplace_function(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity,
+                      "inplace_function: the callable (its captures) is larger than Capacity; "
+                      "capture less or raise Capacity");
+        static_assert(Alignment % alignof(Fn) == 0, "inplace_function: the callable needs a stricter alignment");
+        static_assert(std::is_copy_constructible_v<Fn>, "inplace_function: the callable must be copyable");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>,
+                      "inplace_function: the callable must be nothrow move constructible");
+        using Given = std::remove_cv_t<std::remove_reference_t<F>>; // A function reference is never null
+        if constexpr (std::is_pointer_v<Given> || std::is_member_pointer_v<Given>) {
+            if (f == nullptr) return; // Null function pointer: empty, like std::function
+        }
+        ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+        vtable = &kVTableFor<Fn>;
+    }
+
+    inplace_function(const inplace_function& other) : vtable(other.vtable) {
+        if (vtable) vtable->copy(storage, other.storage);
+    }
+
+    inplace_function(inplace_function&& other) noexcept : vtable(other.vtable) {
+        if (vtable) vtable->move(storage, other.storage);
+        other.vtable = nullptr;
+    }
+
+    inplace_function& operator=(const inplace_function& other) {
+        if (this != &other) {
+            inplace_function copy(other); // May throw; *this is untouched if it does
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    inplace_function& operator=(inplace_function&& other) noexcept {
+        if (this != &other) {
+            reset();
+            vtable = other.vtable;
+            if (vtable) vtable->move(storage, other.storage);
+            other.vtable = nullptr;
+        }
+        return *this;
+    }
+
+    inplace_function& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    ~inplace_function() { reset(); }
+
+    R operator()(Args... args) const {
+        if (!vtable) throw std::bad_function_call();
+        return vtable->invoke(const_cast<unsigned char*>(storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return vtable != nullptr; }
+
+    void swap(inplace_function& other) noexcept {
+        inplace_function tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    const VTable* vtable = nullptr;
+    alignas(Alignment) unsigned char storage[Capacity];
+
+    void reset() noexcept {
+        if (vtable) vtable->destroy(storage);
+        vtable = nullptr;
+    }
+};
+
+template <typename Signature>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)> {
+    // Either a pointer to the callable object or a function pointer (which may not be cast to void*)
+    union Target {
+        void* object;
+        void (*function)();
+    };
+
+    template <typename F>
+    static constexpr bool kIsCallable =
+        !std::is_same_v<std::decay_t<F>, function_ref> && std::is_invocable_r_v<R, F&, Args...>;
+
+public:
+    template <typename F, std::enable_if_t<kIsCallable<F>, int> = 0>
+    function_ref(F&& f) noexcept {
+        using Fn = std::remove_reference_t<F>;
+        if constexpr (std::is_function_v<Fn> || std::is_pointer_v<std::decay_t<F>>) {
+            // Plain functions and function pointers are stored by value
+            using Pointer = std::decay_t<F>;
+            target.function = reinterpret_cast<void (*)()>(static_cast<Pointer>(f));
+            thunk = [](Target t, Args&&... args) -> R {
+                return reinterpret_cast<Pointer>(t.function)(std::forward<Args>(args)...);
+            };
+        } else {
+            target.object = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            thunk = [](Target t, Args&&... args) -> R {
+                return std::invoke(*static_cast<Fn*>(t.object), std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    R operator()(Args... args) const { return thunk(target, std::forward<Args>(args)...); }
+
+private:
+    Target target;
+    R (*thunk)(Target, Args&&...);
+};
+
+#endif // INPLACE_FUNCTION_H
@@ -0,0 +1,294 @@
+#ifndef INTRUSIVE_PTR_H
+#define INTRUSIVE_PTR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Intrusive reference counting + pooled allocation.
+   - std::shared_ptr keeps its count in a separate control block. Built from a raw `new` that is a
+     second allocation, and every copy/destroy is an atomic RMW on a line far from the object.
+   - Here the count lives inside the object (derive from RefCounted<T>), so intrusive_ptr is one
+     pointer wide, creation is one allocation and the count shares the object's cache line.
+   - RefCounted<T, ThreadUnsafeCount> uses a plain integer for objects that never leave one
+     thread: copies cost a normal increment, no lock prefix.
+   - make_pooled<T>() takes memory from an ObjectPool<T> and gives it back to the pool when the
+     last reference goes away, so steady-state create/destroy does not touch malloc at all.
+   - Hierarchies: the root derives from RefCounted<Root> and has a virtual destructor (the last
+     release deletes through Root*). intrusive_ptr<Derived> converts to intrusive_ptr<Root>, and
+     make_pooled<Derived>() works too: its pool recycles Derived-sized slots.
+*/
+
+// ✅ Counter policies
+struct ThreadSafeCount {
+    std::atomic<uint32_t> value{0};
+    void increment() { value.fetch_add(1, std::memory_order_relaxed); }
+    // acq_rel: the thread that drops the last reference must see every write made through others
+    bool decrementIsLast() { return value.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+    uint32_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct ThreadUnsafeCount {
+    uint32_t value = 0;
+    void increment() { ++value; }
+    bool decrementIsLast() { return --value == 0; }
+    uint32_t get() const { return value; }
+};
+
+// ✅ Lock policies for ObjectPool
+struct NullLock {
+    void lock() {}
+    void unlock() {}
+};
+
+class SpinLock {
+public:
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            while (locked.load(std::memory_order_relaxed)) {} // Spin on a read, not on the RMW
+        }
+    }
+    void unlock() { locked.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> locked{false};
+};
+
+// ✅ Pool that recycles storage for one object type
+// 🚨 Prevents: malloc/free on every create/destroy ✅ (free list of fixed-size slots)
+/* The pool must outlive every object allocated from it. */
+template <typename T, typename Lock = SpinLock>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t firstSlabObjects = 64) : nextSlabObjects(firstSlabObjects ? firstSlabObjects : 1) {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Raw storage for one T (not constructed)
+    void* allocate() {
+        std::lock_guard<Lock> guard(lock);
+        if (!freeList) grow();
+        Slot* slot = freeList;
+        freeList = slot->next;
+        ++liveCount;
+        return slot;
+    }
+
+    // Storage of an already destroyed T
+    void deallocate(void* p) {
+        std::lock_guard<Lock> guard(lock);
+        Slot* slot = static_cast<Slot*>(p);
+        slot->next = freeList;
+        freeList = slot;
+        --liveCount;
+    }
+
+    size_t live() const { return liveCount; }
+    size_t slabs() const { return slabList.size(); }
+
+private:
+    union Slot {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    void grow() {
+        // Slabs double in size (capped) so a growing pool makes O(log n) system allocations
+        std::unique_ptr<Slot[]> slab(new Slot[nextSlabObjects]);
+        for (size_t i = 0; i < nextSlabObjects; ++i) {
+            slab[i].next = freeList;
+            freeList = &slab[i];
+        }
+        slabList.push_back(std::move(slab));
+        if (nextSlabObjects < 4096) nextSlabObjects *= 2;
+    }
+
+    Lock lock;
+    Slot* freeList = nullptr;
+    size_t liveCount = 0;
+    size_t nextSlabObjects;
+    std::vector<std::unique_ptr<Slot[]>> slabList;
+};
+
+template <typename T, typename L, typename... Args>
+class PooledFactory;
+
+// ✅ Base class holding the embedded count
+template <typename Derived, typename CountPolicy = ThreadSafeCount>
+class RefCounted {
+public:
+    using count_policy = CountPolicy;
+
+    uint32_t use_count() const { return refs.get(); }
+
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) {}                       // A copy is a new object: count starts at 0
+    RefCounted& operator=(const RefCounted&) { return *this; }
+    ~RefCounted() = default;
+
+private:
+    // Who gives the memory back: nullptr -> delete, otherwise the pool's deallocate
+    using Recycler = void (*)(void* pool, Derived* obj);
+
+    mutable CountPolicy refs;
+    void* pool = nullptr;
+    Recycler recycler = nullptr;
+
+    friend void intrusive_ptr_add_ref(const Derived* p) { p->refs.increment(); }
+
+    friend void intrusive_ptr_release(const Derived* p) {
+        if (!p->refs.decrementIsLast()) return;
+        Derived* obj = const_cast<Derived*>(p);
+        if (obj->recycler) obj->recycler(obj->pool, obj);
+        else delete obj;
+    }
+
+    template <typename T, typename L, typename... Args>
+    friend class PooledFactory;
+};
+
+// ✅ Smart pointer over an embedded count (one pointer wide)
+template <typename T>
+class intrusive_ptr {
+public:
+    using element_type = T;
+
+    intrusive_ptr() noexcept = default;
+    intrusive_ptr(std::nullptr_t) noexcept {}
+
+    // Adopts p and adds one reference (the count lives in *p, so this is always safe)
+    explicit intrusive_ptr(T* p, bool addRef = true) : ptr(p) {
+        if (ptr && addRef) intrusive_ptr_add_ref(ptr);
+    }
+
+    intrusive_ptr(const intrusive_ptr& other) : ptr(other.ptr) {
+        if (ptr) intrusive_ptr_add_ref(ptr);
+    }
+
+    intrusive_ptr(intrusive_ptr&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+
+    // intrusive_ptr<Derived> -> intrusive_ptr<Base>
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    intrusive_ptr(const intrusive_ptr<U>& other) : ptr(other.get()) {
+        if (ptr) intrusive_ptr_add_ref(ptr);
+    }
+
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    intrusive_ptr(intrusive_ptr<U>&& other) noexcept : ptr(other.detach()) {}
+
+    ~intrusive_ptr() {
+        if (ptr) intrusive_ptr_release(ptr);
+    }
+
+    intrusive_ptr& operator=(const intrusive_ptr& other) {
+        intrusive_ptr(other).swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr&& other) noexcept {
+        intrusive_ptr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    intrusive_ptr& operator=(const intrusive_ptr<U>& other) {
+        intrusive_ptr(other).swap(*this);
+        return *this;
+    }
+
+    template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    intrusive_ptr& operator=(intrusive_ptr<U>&& other) noexcept {
+        intrusive_ptr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { intrusive_ptr().swap(*this); }
+    void swap(intrusive_ptr& other) noexcept { std::swap(ptr, other.ptr); }
+
+    // Gives up ownership without releasing (pair with intrusive_ptr(p, false))
+    T* detach() noexcept {
+        T* p = ptr;
+        ptr = nullptr;
+        return p;
+    }
+
+    T* get() const noexcept { return ptr; }
+    T& operator*() const noexcept { return *ptr; }
+    T* operator->() const noexcept { return ptr; }
+    explicit operator bool() const noexcept { return ptr != nullptr; }
+    uint32_t use_count() const { return ptr ? ptr->use_count() : 0; }
+
+private:
+    T* ptr = nullptr;
+};
+
+template <typename T, typename U>
+bool operator==(const intrusive_ptr<T>& a, const intrusive_ptr<U>& b) { return a.get() == b.get(); }
+template <typename T, typename U>
+bool operator!=(const intrusive_ptr<T>& a, const intrusive_ptr<U>& b) { return a.get() != b.get(); }
+
+// One allocation, like std::make_shared
+template <typename T, typename... Args>
+intrusive_ptr<T> make_intrusive(Args&&... args) {
+    return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+// ✅ Pooled construction
+template <typename T, typename L, typename... Args>
+class PooledFactory {
+public:
+    static intrusive_ptr<T> make(ObjectPool<T, L>& pool, Args&&... args) {
+        void* mem = pool.allocate();
+        T* obj;
+        try {
+            obj = new (mem) T(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(mem);
+            throw;
+        }
+        obj->pool = &pool;
+        // The recycler receives the root type of the hierarchy; the slot always holds exactly a T
+        obj->recycler = [](void* p, auto* root) {
+            T* o = static_cast<T*>(root);
+            o->~T();
+            static_cast<ObjectPool<T, L>*>(p)->deallocate(o);
+        };
+        return intrusive_ptr<T>(obj);
+    }
+};
+
+// Allocates from an explicit pool (the pool must outlive the returned objects)
+template <typename T, typename L, typename... Args>
+intrusive_ptr<T> make_pooled(ObjectPool<T, L>& pool, Args&&... args) {
+    return PooledFactory<T, L, Args...>::make(pool, std::forward<Args>(args)...);
+}
+
+/* Default pool per type:
+   - thread-safe count  -> one process-wide pool guarded by a spin lock,
+   - thread-unsafe count -> one pool per thread, no locking (objects must stay on that thread). */
+template <typename T>
+ObjectPool<T, SpinLock>& defaultPool(std::true_type /*threadSafe*/) {
+    static ObjectPool<T, SpinLock> pool;
+    return pool;
+}
+
+template <typename T>
+ObjectPool<T, NullLock>& defaultPool(std::false_type /*threadSafe*/) {
+    thread_local ObjectPool<T, NullLock> pool;
+    return pool;
+}
+
+template <typename T, typename... Args>
+intrusive_ptr<T> make_pooled(Args&&... args) {
+    using ThreadSafe = std::is_same<typename T::count_policy, ThreadSafeCount>;
+    return make_pooled(defaultPool<T>(ThreadSafe()), std::forward<Args>(args)...);
+}
+
+#endif // INTRUSIVE_PTR_H
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include "intrusive_ptr.h"
+#include "../../../C/bench_harness.h"
+
+/* std::shared_ptr against intrusive_ptr (atomic and non-atomic counts) and make_pooled().
+   Measures copy+destroy of an existing pointer, and create+destroy of a new object, and counts
+   heap allocations per operation by replacing the global operator new. Pointer conversions
+   within a hierarchy and pooled subclasses are checked first.
+   Accepts the bench_harness.h options (--json=FILE, --reps=N, --perf, ...). */
+
+// ✅ Allocation counter
+static std::atomic<uint64_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Same payload for every variant, like the Resource class in smart_unique_weak_shared_pointers.cpp
+struct PlainResource {
+    int id;
+    explicit PlainResource(int id) : id(id) {}
+};
+
+struct SharedResource : RefCounted<SharedResource> {
+    int id;
+    explicit SharedResource(int id) : id(id) {}
+};
+
+struct LocalResource : RefCounted<LocalResource, ThreadUnsafeCount> {
+    int id;
+    explicit LocalResource(int id) : id(id) {}
+};
+
+// Hierarchy: the root holds the count and is deleted through Shape*
+struct Shape : RefCounted<Shape> {
+    virtual ~Shape() = default;
+    virtual int area() const = 0;
+};
+
+struct Square : Shape {
+    int side;
+    explicit Square(int side) : side(side) {}
+    int area() const override { return side * side; }
+};
+
+// Derived -> base copies and moves keep the counts right, pooled squares go back to their pool
+static int verifyHierarchy() {
+    int bad = 0;
+    ObjectPool<Square> pool;
+    {
+        intrusive_ptr<Square> square = make_pooled(pool, 3);
+        intrusive_ptr<Shape> shape = square; // Copy: two references
+        bad += square.use_count() != 2 || shape->area() != 9;
+        intrusive_ptr<Shape> moved = std::move(square); // Move: still two, square is empty
+        bad += square || moved.use_count() != 2 || moved != shape;
+        shape = make_intrusive<Square>(4); // Converting move-assignment releases one reference
+        bad += shape->area() != 16 || moved.use_count() != 1 || pool.live() != 1;
+        moved = shape; // Drops the last reference to the pooled square
+        bad += pool.live() != 0 || shape.use_count() != 2;
+        intrusive_ptr<Square> other = make_pooled(pool, 5);
+        shape = other; // Converting copy-assignment
+        bad += shape.use_count() != 2 || pool.live() != 1;
+    }
+    bad += pool.live() != 0;
+    return bad;
+}
+
+// Runs one benchmark and prints how many allocations each operation made
+template <typename Body>
+void runCounted(bench_session_t* session, const char* name, Body body) {
+    uint64_t before = allocationCount.load();
+    uint64_t ops = 0;
+    bench_result_t* r = bench::run(session, name, [&](uint64_t iterations) {
+        body(iterations);
+        ops += iterations;
+    });
+    if (r) {
+        bench_set_items(r, 1);
+        std::cout << "    allocations/op: " << static_cast<double>(allocationCount.load() - before) / ops << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    // 🚨 Prevents: Misleading shared_ptr numbers ✅
+    /* libstdc++ skips the atomic refcount ops while the process has never created a thread.
+       Hot paths in real programs run multithreaded, so start (and join) one thread first. */
+    std::thread([] {}).join();
+
+    int failures = verifyHierarchy();
+    std::cout << "check hierarchy " << (failures ? "MISMATCH" : "ok") << "\n";
+
+    std::cout << "sizeof(shared_ptr) = " << sizeof(std::shared_ptr<PlainResource>)
+              << ", sizeof(intrusive_ptr) = " << sizeof(intrusive_ptr<SharedResource>) << "\n\n";
+
+    // ✅ Copy + destroy of an existing pointer (refcount traffic only)
+    {
+        auto sp = std::make_shared<PlainResource>(1);
+        runCounted(&session, "copy_destroy/shared_ptr", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                std::shared_ptr<PlainResource> copy = sp;
+                bench::doNotOptimize(copy);
+            }
+        });
+        auto ip = make_intrusive<SharedResource>(1);
+        runCounted(&session, "copy_destroy/intrusive_atomic", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                intrusive_ptr<SharedResource> copy = ip;
+                bench::doNotOptimize(copy);
+            }
+        });
+        auto lp = make_intrusive<LocalResource>(1);
+        runCounted(&session, "copy_destroy/intrusive_plain", [&](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                intrusive_ptr<LocalResource> copy = lp;
+                bench::doNotOptimize(copy);
+            }
+        });
+    }
+
+    // ✅ Create + destroy (allocation path)
+    runCounted(&session, "create_destroy/shared_ptr(new)", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            std::shared_ptr<PlainResource> p(new PlainResource(static_cast<int>(i))); // Object + control block
+            bench::doNotOptimize(p);
+        }
+    });
+    runCounted(&session, "create_destroy/make_shared", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto p = std::make_shared<PlainResource>(static_cast<int>(i));
+            bench::doNotOptimize(p);
+        }
+    });
+    runCounted(&session, "create_destroy/make_intrusive", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto p = make_intrusive<SharedResource>(static_cast<int>(i));
+            bench::doNotOptimize(p);
+        }
+    });
+    runCounted(&session, "create_destroy/make_pooled_atomic", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto p = make_pooled<SharedResource>(static_cast<int>(i));
+            bench::doNotOptimize(p);
+        }
+    });
+    runCounted(&session, "create_destroy/make_pooled_plain", [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto p = make_pooled<LocalResource>(static_cast<int>(i));
+            bench::doNotOptimize(p);
+        }
+    });
+
+    // ✅ Batch workload: many objects alive at once, then released (pool grows once, then recycles)
+    const size_t batch = 1024;
+    runCounted(&session, "batch1024/make_shared", [&](uint64_t n) {
+        std::vector<std::shared_ptr<PlainResource>> live;
+        live.reserve(batch);
+        for (uint64_t i = 0; i < n; ++i) {
+            live.push_back(std::make_shared<PlainResource>(static_cast<int>(i)));
+            if (live.size() == batch) live.clear();
+        }
+    });
+    runCounted(&session, "batch1024/make_pooled_plain", [&](uint64_t n) {
+        std::vector<intrusive_ptr<LocalResource>> live;
+        live.reserve(batch);
+        for (uint64_t i = 0; i < n; ++i) {
+            live.push_back(make_pooled<LocalResource>(static_cast<int>(i)));
+            if (live.size() == batch) live.clear();
+        }
+    });
+
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
@@ -0,0 +1,332 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <climits>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+/* Bounded multi-producer / multi-consumer queue (Dmitry Vyukov's design).
+   - Each slot carries a sequence number telling whether it is free for the producer of lap N
+     or filled for the consumer of lap N, so producers and consumers only contend on their own
+     position counter (one CAS per operation, no locks).
+   - Capacity is rounded up to a power of two so that "pos % capacity" is a mask.
+   - try_push_n / try_pop_n claim a run of consecutive slots with a single CAS.
+   - BlockingMPMCQueue adds push()/pop() that sleep on a futex, but only when the ring is
+     actually full or empty; the fast path never makes a system call.
+*/
+
+constexpr size_t kCacheLine = 64;
+
+template <typename T>
+class MPMCQueue {
+public:
+    explicit MPMCQueue(size_t requestedCapacity)
+        : capacity(roundUpPow2(requestedCapacity < 2 ? 2 : requestedCapacity)),
+          mask(capacity - 1),
+          cells(new Cell[capacity]) {
+        for (size_t i = 0; i < capacity; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    ~MPMCQueue() {
+        // Destroy elements pushed but never popped, in place: T need not be default-constructible
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        for (size_t pos = dequeuePos.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            Cell& cell = cells[pos & mask];
+            if (cell.seq.load(std::memory_order_acquire) == pos + 1) cell.ptr()->~T();
+        }
+    }
+
+    template <typename U>
+    bool try_push(U&& item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Slot still holds last lap's element: queue is full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed); // Another producer won, reload
+            }
+        }
+        new (&cell->storage) T(std::forward<U>(item));
+        cell->seq.store(pos + 1, std::memory_order_release); // Publish to consumers
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // Slot not yet filled: queue is empty
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        T* slot = cell->ptr();
+        item = std::move(*slot);
+        slot->~T();
+        cell->seq.store(pos + mask + 1, std::memory_order_release); // Free for next lap's producer
+        return true;
+    }
+
+    // Pushes up to n items (copied), claiming all slots with one CAS. Returns how many were pushed.
+    size_t try_push_n(const T* items, size_t n) {
+        if (n == 0) return 0;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        size_t count;
+        while (true) {
+            count = 0;
+            // Count how many consecutive slots are free for this lap
+            while (count < n && count < capacity) {
+                size_t seq = cells[(pos + count) & mask].seq.load(std::memory_order_acquire);
+                if (seq != pos + count) break;
+                ++count;
+            }
+            if (count == 0) {
+                size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0) return 0; // Full
+                pos = enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) break;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Cell& cell = cells[(pos + i) & mask];
+            new (&cell.storage) T(items[i]);
+            cell.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Pops up to n items into out[], claiming all slots with one CAS. Returns how many were popped.
+    size_t try_pop_n(T* out, size_t n) {
+        if (n == 0) return 0;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        size_t count;
+        while (true) {
+            count = 0;
+            while (count < n && count < capacity) {
+                size_t seq = cells[(pos + count) & mask].seq.load(std::memory_order_acquire);
+                if (seq != pos + count + 1) break;
+                ++count;
+            }
+            if (count == 0) {
+                size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) return 0; // Empty
+                pos = dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) break;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Cell& cell = cells[(pos + i) & mask];
+            T* slot = cell.ptr();
+            out[i] = std::move(*slot);
+            slot->~T();
+            cell.seq.store(pos + i + mask + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Approximate (racy by nature) size, useful for statistics only
+    size_t size_approx() const {
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t get_capacity() const { return capacity; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        T* ptr() { return std::launder(reinterpret_cast<T*>(&storage)); }
+    };
+
+    static size_t roundUpPow2(size_t v) {
+        size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    // Separate cache lines: producers and consumers must not false-share their counters
+    alignas(kCacheLine) std::atomic<size_t> enqueuePos{0};
+    alignas(kCacheLine) std::atomic<size_t> dequeuePos{0};
+};
+
+// ✅ Minimal futex wrapper (falls back to yielding where futexes are unavailable)
+inline void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    while (word.load(std::memory_order_acquire) == expected) std::this_thread::yield();
+#endif
+}
+
+inline void futexWake(std::atomic<uint32_t>& word, int count) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)count;
+#endif
+}
+
+inline void futexWakeAll(std::atomic<uint32_t>& word) { futexWake(word, INT_MAX); }
+
+// ✅ Blocking wrapper: lock-free fast path, futex sleep only on empty/full
+// 🚨 Prevents: Lost wake-ups ✅ (waiter count + seq_cst fences form a Dekker-style handshake)
+template <typename T>
+class BlockingMPMCQueue {
+public:
+    explicit BlockingMPMCQueue(size_t capacity) : queue(capacity) {}
+
+    // Blocks while full. Returns false if close() ran before the call (see close()).
+    template <typename U>
+    bool push(U&& item) {
+        if (closed.load(std::memory_order_acquire)) return false;
+        if (!waitUntil<false>(notFull, waitingProducers, [&] { return queue.try_push(std::forward<U>(item)); }))
+            return false;
+        assertNoCloseInFlight();
+        signal(notEmpty, waitingConsumers);
+        return true;
+    }
+
+    // Blocks while empty. Returns false once the queue is closed and drained.
+    bool pop(T& item) {
+        if (!waitUntil<true>(notEmpty, waitingConsumers, [&] { return queue.try_pop(item); }))
+            return false;
+        signal(notFull, waitingProducers);
+        return true;
+    }
+
+    // Pushes all n items, blocking as needed. Returns how many were pushed (< n only if closed).
+    size_t push_n(const T* items, size_t n) {
+        size_t done = 0;
+        while (done < n && !closed.load(std::memory_order_acquire)) {
+            size_t got = 0;
+            if (!waitUntil<false>(notFull, waitingProducers,
+                                  [&] { return (got = queue.try_push_n(items + done, n - done)) != 0; }))
+                break;
+            done += got;
+            assertNoCloseInFlight();
+            signal(notEmpty, waitingConsumers, static_cast<int>(got));
+        }
+        return done;
+    }
+
+    // Pops between 1 and n items, blocking only while empty. Returns 0 once closed and drained.
+    size_t pop_n(T* out, size_t n) {
+        size_t got = 0;
+        if (!waitUntil<true>(notEmpty, waitingConsumers, [&] { return (got = queue.try_pop_n(out, n)) != 0; }))
+            return 0;
+        signal(notFull, waitingProducers, static_cast<int>(got));
+        return got;
+    }
+
+    bool try_push(const T& item) {
+        if (closed.load(std::memory_order_acquire) || !queue.try_push(item)) return false;
+        assertNoCloseInFlight();
+        signal(notEmpty, waitingConsumers);
+        return true;
+    }
+    bool try_pop(T& item) { return queue.try_pop(item) ? (signal(notFull, waitingProducers), true) : false; }
+
+    /* No more pushes; consumers drain what is left and then pop() returns false.
+       Call it only after every producer has returned from its last push. A push that overlaps
+       close() can land after a consumer has seen "closed and empty" and exited, and its item
+       would only be destroyed with the queue. Checking for in-flight pushes would put a shared
+       counter on the producers' fast path, so the rule is asserted in debug builds instead.
+       Pushes that start after close() are fine: they return false. */
+    void close() {
+        closed.store(true, std::memory_order_seq_cst);
+        notEmpty.fetch_add(1, std::memory_order_seq_cst);
+        notFull.fetch_add(1, std::memory_order_seq_cst);
+        futexWakeAll(notEmpty);
+        futexWakeAll(notFull);
+    }
+
+    bool is_closed() const { return closed.load(std::memory_order_acquire); }
+
+private:
+    MPMCQueue<T> queue;
+    alignas(kCacheLine) std::atomic<uint32_t> notEmpty{0};  // Futex word bumped after each push
+    std::atomic<uint32_t> waitingConsumers{0};
+    alignas(kCacheLine) std::atomic<uint32_t> notFull{0};   // Futex word bumped after each pop
+    std::atomic<uint32_t> waitingProducers{0};
+    alignas(kCacheLine) std::atomic<bool> closed{false};
+
+    // A push that succeeded while close() ran broke the rule above
+    void assertNoCloseInFlight() const {
+        assert(!closed.load(std::memory_order_relaxed) && "close() called while a push was in flight");
+    }
+
+    // Only touch the futex when somebody is actually asleep. One item frees one waiter;
+    // waking more would just send the rest straight back to sleep.
+    void signal(std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiters, int count = 1) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) != 0) {
+            word.fetch_add(1, std::memory_order_release);
+            futexWake(word, count);
+        }
+    }
+
+    // Once closed, consumers (DrainOnClose) still take what is left; producers give up at once
+    template <bool DrainOnClose, typename TryOp>
+    bool waitUntil(std::atomic<uint32_t>& word, std::atomic<uint32_t>& waiters, TryOp tryOp) {
+        // Short spin first: most empty/full conditions clear within a few hundred cycles.
+        // Yield in the second half so an oversubscribed peer gets the CPU to make progress.
+        for (int spin = 0; spin < 64; ++spin) {
+            if (closed.load(std::memory_order_acquire)) return DrainOnClose && tryOp();
+            if (tryOp()) return true;
+            if (spin >= 32) std::this_thread::yield();
+        }
+        while (true) {
+            uint32_t seen = word.load(std::memory_order_acquire);
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (closed.load(std::memory_order_acquire)) {
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+                return DrainOnClose && tryOp(); // Drain anything pushed right before close()
+            }
+            if (tryOp()) {
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            futexWait(word, seen); // Returns immediately if word changed since 'seen'
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif // MPMC_QUEUE_H
@@ -0,0 +1,159 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <queue>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include "mpmc_queue.h"
+
+/* Producer-consumer throughput: std::queue + mutex + condition variables (the design used by
+   producer()/consumer() in thread_pool_consumer_producer.cpp) against the lock-free
+   BlockingMPMCQueue from mpmc_queue.h, item by item and in batches.
+   Usage: ./mpmc_queue_benchmark [items_per_run]   (default 4,000,000) */
+
+// ✅ Baseline: bounded std::queue guarded by one mutex and two condition variables
+class MutexQueue {
+public:
+    explicit MutexQueue(size_t capacity) : capacity(capacity) {}
+
+    bool push(int item) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        notFull.wait(lock, [this] { return dataQueue.size() < capacity || done; });
+        if (done) return false;
+        dataQueue.push(item);
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(int& item) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        notEmpty.wait(lock, [this] { return !dataQueue.empty() || done; });
+        if (dataQueue.empty()) return false; // done and drained
+        item = dataQueue.front();
+        dataQueue.pop();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            done = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    size_t capacity;
+    std::queue<int> dataQueue;
+    std::mutex queueMutex;
+    std::condition_variable notEmpty, notFull;
+    bool done = false;
+};
+
+constexpr size_t kQueueCapacity = 4096;
+constexpr size_t kBatch = 32;
+
+// Runs P producers and C consumers moving 'items' ints; returns million items per second.
+template <typename PushFn, typename PopFn, typename CloseFn>
+double runScenario(int producers, int consumers, size_t items, PushFn producerBody, PopFn consumerBody,
+                   CloseFn closeQueue, bool& checksumOk) {
+    std::atomic<uint64_t> consumedSum(0);
+    std::vector<std::thread> threads;
+    size_t perProducer = items / producers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < consumers; ++c)
+        threads.emplace_back([&] { consumedSum.fetch_add(consumerBody(), std::memory_order_relaxed); });
+    std::vector<std::thread> producerThreads;
+    for (int p = 0; p < producers; ++p)
+        producerThreads.emplace_back([&, p] { producerBody(static_cast<int>(p * perProducer), perProducer); });
+    for (std::thread& t : producerThreads) t.join();
+    closeQueue();
+    for (std::thread& t : threads) t.join();
+    auto end = std::chrono::steady_clock::now();
+
+    // Every value 0 .. producers*perProducer-1 is sent exactly once
+    uint64_t n = static_cast<uint64_t>(producers) * perProducer;
+    checksumOk = consumedSum.load() == n * (n - 1) / 2;
+    return n / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+double benchMutex(int producers, int consumers, size_t items, bool& ok) {
+    MutexQueue q(kQueueCapacity);
+    return runScenario(producers, consumers, items,
+        [&](int first, size_t count) {
+            for (size_t i = 0; i < count; ++i) q.push(first + static_cast<int>(i));
+        },
+        [&]() {
+            uint64_t sum = 0;
+            int item;
+            while (q.pop(item)) sum += item;
+            return sum;
+        },
+        [&] { q.close(); }, ok);
+}
+
+double benchLockFree(int producers, int consumers, size_t items, bool& ok) {
+    BlockingMPMCQueue<int> q(kQueueCapacity);
+    return runScenario(producers, consumers, items,
+        [&](int first, size_t count) {
+            for (size_t i = 0; i < count; ++i) q.push(first + static_cast<int>(i));
+        },
+        [&]() {
+            uint64_t sum = 0;
+            int item;
+            while (q.pop(item)) sum += item;
+            return sum;
+        },
+        [&] { q.close(); }, ok);
+}
+
+double benchLockFreeBatch(int producers, int consumers, size_t items, bool& ok) {
+    BlockingMPMCQueue<int> q(kQueueCapacity);
+    return runScenario(producers, consumers, items,
+        [&](int first, size_t count) {
+            int batch[kBatch];
+            for (size_t i = 0; i < count; i += kBatch) {
+                size_t n = std::min(kBatch, count - i);
+                for (size_t j = 0; j < n; ++j) batch[j] = first + static_cast<int>(i + j);
+                q.push_n(batch, n);
+            }
+        },
+        [&]() {
+            uint64_t sum = 0;
+            int batch[kBatch];
+            size_t got;
+            while ((got = q.pop_n(batch, kBatch)) != 0)
+                for (size_t j = 0; j < got; ++j) sum += batch[j];
+            return sum;
+        },
+        [&] { q.close(); }, ok);
+}
+
+int main(int argc, char** argv) {
+    size_t items = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    std::cout << "Items per run: " << items << ", queue capacity: " << kQueueCapacity
+              << ", batch: " << kBatch << ", hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+    std::cout << std::left << std::setw(8) << "config" << std::right << std::setw(16) << "mutex+cv Mops/s"
+              << std::setw(18) << "lock-free Mops/s" << std::setw(16) << "batched Mops/s" << "\n";
+
+    const int configs[] = {1, 4, 16};
+    for (int n : configs) {
+        bool ok1, ok2, ok3;
+        double mutexRate = benchMutex(n, n, items, ok1);
+        double lockFreeRate = benchLockFree(n, n, items, ok2);
+        double batchRate = benchLockFreeBatch(n, n, items, ok3);
+        std::string label = std::to_string(n) + "P" + std::to_string(n) + "C";
+        std::cout << std::left << std::setw(8) << label << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(16) << mutexRate << std::setw(18) << lockFreeRate << std::setw(16) << batchRate
+                  << ((ok1 && ok2 && ok3) ? "" : "   CHECKSUM MISMATCH") << "\n";
+    }
+    return 0;
+}
@@ -4,19 +4,22 @@
 #include <chrono>
 #include <atomic>
 #include <future>
+#include "sharded_counter.h"
+#include "../../../C/bench_harness.h"
 
 // Shared resources
 std::mutex mtx1, mtx2;  // Mutex for deadlock example
-std::atomic<int> counter(0); // Atomic variable to prevent race conditions
+ShardedCounter<> counter; // Per-thread cells prevent race conditions without contention
 
 // 🚨 Prevents: Race Condition ✅
 /* Bug Fix:
    - Multiple threads updating `counter` simultaneously could lead to incorrect values.
-   - Solution: Using `std::atomic<int>` ensures thread-safe operations.
+   - Solution: `std::atomic<int>` is thread-safe, but every thread hammers the same cache line.
+     `ShardedCounter` gives each thread its own padded cell and sums them on read.
 */
 void safeIncrement() {
     for (int i = 0; i < 1000; ++i) {
-        counter++; // Atomic operation prevents race conditions.
+        counter++; // Uncontended update of this thread's cell.
     }
 }
 
@@ -46,22 +49,27 @@ void detachedFunction() {
 // 🚨 Prevents: Inaccurate Timing ✅
 /* Bug Fix:
    - `clock()` or other timing methods might not be **precise** in multithreading.
-   - Solution: Use `std::chrono::high_resolution_clock` for **accurate timing**.
+   - A single timed run is dominated by noise (thread start-up, cold caches, frequency ramp-up).
+   - Solution: The benchmark harness warms up, repeats the run and reports the **median** with
+     its spread (MAD, p95), based on a monotonic clock.
 */
-void timedFunction() {
-    auto start = std::chrono::high_resolution_clock::now(); // Start timing
-
-    std::thread t1(safeIncrement);
-    std::thread t2(safeIncrement);
-
-    t1.join();
-    t2.join(); // Ensure threads complete execution before proceeding
-
-    auto end = std::chrono::high_resolution_clock::now(); // End timing
-    std::chrono::duration<double> duration = end - start;
-
-    std::cout << "Final Counter Value: " << counter.load() << "\n";
-    std::cout << "Execution Time: " << duration.count() << " seconds\n";
+void timedFunction(int argc, char** argv) {
+    static bench_session_t session; // Large result table, keep it off the stack
+    bench_session_init(&session, argc, argv); // --reps=, --json=, ...
+
+    bench::run(&session, "two_threads_safeIncrement", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            counter.reset(); // Each run starts from zero
+            std::thread t1(safeIncrement);
+            std::thread t2(safeIncrement);
+
+            t1.join();
+            t2.join(); // Ensure threads complete execution before proceeding
+        }
+    });
+    bench_session_finish(&session);
+
+    std::cout << "Final Counter Value: " << counter.load() << "\n"; // Last run: 2 x 1000
 }
 
 // 🚨 Prevents: Manual Thread Management Issues ✅
@@ -74,11 +82,11 @@ int computeValue() {
     return 42; // Sample computation
 }
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "Starting Multithreading Example...\n";
 
     // ✅ Prevents: Race Conditions using atomic variables
-    timedFunction();
+    timedFunction(argc, argv);
 
     // ✅ Prevents: Deadlock by ensuring proper locking order
     std::thread deadlockThread1(deadlockSafeFunction);
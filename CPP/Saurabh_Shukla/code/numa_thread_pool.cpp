@@ -0,0 +1,482 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include "inplace_function.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/* NUMA-aware thread pool (Linux).
+   - Workers are pinned to CPUs using a placement policy (compact / scatter / explicit CPU list).
+   - Every NUMA node owns its own task queue and wake-up. Enqueueing wakes a worker of that
+     node only; an idle worker steals from another node only while every worker of that node
+     is busy, so node-targeted tasks run on their node whenever it has a free worker.
+   - allocOnNode() returns memory bound to one node, so task data lives next to the worker
+     that will touch it.
+   - On a single-node machine (or without sysfs / mbind) everything collapses to one node,
+     one queue and plain first-touch allocation: the pool keeps working, it just can't help.
+*/
+
+// ✅ Topology: which CPUs belong to which NUMA node
+struct NumaTopology {
+    std::vector<std::vector<int>> nodeCpus; // nodeCpus[node] = CPUs of that node
+    std::vector<int> nodeIds;               // nodeIds[node] = kernel node id (sysfs nodeN), -1 if unknown
+    std::vector<int> cpuToNode;             // cpuToNode[cpu] = node (or -1 if not usable)
+
+    size_t numNodes() const { return nodeCpus.size(); }
+
+    // Parses the kernel cpulist format, e.g. "0-3,8-11"
+    static std::vector<int> parseCpuList(const std::string& text) {
+        std::vector<int> cpus;
+        std::stringstream ss(text);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty() || range == "\n") continue;
+            size_t dash = range.find('-');
+            int first = std::atoi(range.c_str());
+            int last = (dash == std::string::npos) ? first : std::atoi(range.c_str() + dash + 1);
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    // CPUs this process may run on (respects taskset / cgroup cpusets)
+    static std::vector<int> allowedCpus() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+#endif
+        if (cpus.empty()) {
+            unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned cpu = 0; cpu < n; ++cpu) cpus.push_back(static_cast<int>(cpu));
+        }
+        return cpus;
+    }
+
+    static NumaTopology detect() {
+        NumaTopology topo;
+        std::vector<int> allowed = allowedCpus();
+        int maxCpu = *std::max_element(allowed.begin(), allowed.end());
+        topo.cpuToNode.assign(maxCpu + 1, -1);
+
+        // Nodes may be sparse (node0, node2, ...), so probe a reasonable range
+        for (int node = 0; node < 64; ++node) {
+            std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!in) continue;
+            std::string text;
+            std::getline(in, text);
+            std::vector<int> cpus;
+            for (int cpu : parseCpuList(text))
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) cpus.push_back(cpu);
+            if (cpus.empty()) continue; // memory-only node or outside our cpuset
+            for (int cpu : cpus) topo.cpuToNode[cpu] = static_cast<int>(topo.nodeCpus.size());
+            topo.nodeCpus.push_back(cpus);
+            topo.nodeIds.push_back(node); // Dense index -> real id: nodes 0 and 2 become 0 and 1
+        }
+
+        // 🚨 Graceful degradation: no sysfs NUMA info -> one node holding every allowed CPU
+        if (topo.nodeCpus.empty()) {
+            topo.nodeCpus.push_back(allowed);
+            topo.nodeIds.push_back(-1); // Nothing to bind to
+            for (int cpu : allowed) topo.cpuToNode[cpu] = 0;
+        }
+        return topo;
+    }
+
+    int nodeOfCpu(int cpu) const {
+        if (cpu < 0 || cpu >= static_cast<int>(cpuToNode.size()) || cpuToNode[cpu] < 0) return 0;
+        return cpuToNode[cpu];
+    }
+
+    // Kernel node id of a dense node index, for mbind (-1: none)
+    int kernelNodeId(int node) const {
+        if (node < 0 || node >= static_cast<int>(nodeIds.size())) return -1;
+        return nodeIds[node];
+    }
+};
+
+// ✅ Placement policy for worker threads
+enum class Placement {
+    None,     // Unpinned: the scheduler decides (original ThreadPool behaviour)
+    Compact,  // Fill node 0's CPUs first, then node 1, ... (maximise sharing of caches)
+    Scatter,  // Round-robin across nodes (maximise aggregate memory bandwidth)
+    Explicit  // Use the CPU list given by the caller, in order
+};
+
+struct PlacementPolicy {
+    Placement kind = Placement::None;
+    std::vector<int> cpus; // Only used with Placement::Explicit
+
+    static PlacementPolicy none() { return {Placement::None, {}}; }
+    static PlacementPolicy compact() { return {Placement::Compact, {}}; }
+    static PlacementPolicy scatter() { return {Placement::Scatter, {}}; }
+    static PlacementPolicy explicitCpus(std::vector<int> list) { return {Placement::Explicit, std::move(list)}; }
+};
+
+// ✅ Node-local memory
+/* mbind() binds the pages of an anonymous mapping to one node before they are touched.
+   kernelNode is the kernel's id (NumaTopology::kernelNodeId), not the dense index: with nodes
+   0 and 2 the second node is bit 2 of the mask. If the kernel refuses (no NUMA support,
+   seccomp, node offlined) the mapping is still valid, *bound is set to false and the pages
+   follow the first-touch policy of whichever thread writes them first. */
+void* allocOnNode(size_t bytes, int kernelNode, bool* bound = nullptr) {
+    if (bound) *bound = false;
+#ifdef __linux__
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+#if defined(SYS_mbind)
+    const int bitsPerWord = static_cast<int>(sizeof(unsigned long) * 8);
+    if (kernelNode >= 0 && kernelNode < 64 * bitsPerWord) {
+        const int MPOL_PREFERRED_ = 1; // Prefer the node, fall back to others when it is full
+        unsigned long mask[64] = {};
+        mask[kernelNode / bitsPerWord] = 1UL << (kernelNode % bitsPerWord);
+        // maxnode is one more than the number of bits the kernel should read
+        long rc = syscall(SYS_mbind, p, bytes, MPOL_PREFERRED_, mask, static_cast<unsigned long>(kernelNode) + 2, 0);
+        if (bound) *bound = (rc == 0);
+    }
+#endif
+    return p;
+#else
+    (void)kernelNode;
+    return std::malloc(bytes);
+#endif
+}
+
+void freeOnNode(void* p, size_t bytes) {
+    if (!p) return;
+#ifdef __linux__
+    munmap(p, bytes);
+#else
+    (void)bytes;
+    std::free(p);
+#endif
+}
+
+// ✅ Thread Pool with pinned workers and per-node queues
+// 🚨 Prevents: Cross-socket task bouncing ✅ (Tasks queued on a node run on that node first)
+class NumaThreadPool {
+public:
+    using Task = inplace_function<void(), 64>; // Captures up to 64 bytes, stored without allocating
+
+    NumaThreadPool(size_t numThreads, PlacementPolicy policy = PlacementPolicy::none())
+        : topo(NumaTopology::detect()) {
+        std::vector<int> cpus = chooseCpus(numThreads, policy);
+        queues.reserve(topo.numNodes());
+        for (size_t n = 0; n < topo.numNodes(); ++n) queues.emplace_back(new NodeQueue);
+
+        for (size_t i = 0; i < numThreads; ++i) {
+            int cpu = cpus.empty() ? -1 : cpus[i];
+            int node = (cpu < 0) ? static_cast<int>(i % topo.numNodes()) : topo.nodeOfCpu(cpu);
+            workerNodes.push_back(node);
+            workers.emplace_back([this, cpu, node] { workerLoop(cpu, node); });
+        }
+    }
+
+    // Enqueue on a specific node (-1: the node of the calling thread)
+    void enqueue(Task task, int node = -1) {
+        if (node < 0 || node >= static_cast<int>(queues.size())) node = callerNode();
+        outstanding.fetch_add(1);
+        NodeQueue& q = *queues[node];
+        bool idleHere;
+        {
+            std::lock_guard<std::mutex> lock(q.mtx);
+            q.tasks.push_back(std::move(task));
+            idleHere = q.sleeping > 0;
+        }
+        if (idleHere) {
+            q.wake.notify_one(); // Only this node's workers: the task stays local
+            return;
+        }
+        // Every worker of that node is busy: let one idle worker elsewhere steal it
+        for (size_t k = 1; k < queues.size(); ++k) {
+            NodeQueue& other = *queues[(node + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(other.mtx);
+            if (other.sleeping > other.stealHints) {
+                ++other.stealHints;
+                other.wake.notify_one();
+                return;
+            }
+        }
+    }
+
+    // Blocks until every queued task has finished
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idleCondition.wait(lock, [this] { return outstanding.load() == 0; });
+    }
+
+    size_t numNodes() const { return topo.numNodes(); }
+    int kernelNodeId(int node) const { return topo.kernelNodeId(node); }
+    const std::vector<int>& nodesOfWorkers() const { return workerNodes; }
+
+    // Node of the worker currently executing (0 when called from outside the pool)
+    static int currentNode() { return tlsNode < 0 ? 0 : tlsNode; }
+
+    ~NumaThreadPool() {
+        for (auto& q : queues) {
+            {
+                std::lock_guard<std::mutex> lock(q->mtx);
+                q->stop = true;
+            }
+            q->wake.notify_all();
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+
+private:
+    // Everything a node's workers sleep on; other nodes only touch it to steal or hand over work
+    struct NodeQueue {
+        std::mutex mtx;
+        std::condition_variable wake;
+        std::deque<Task> tasks;
+        size_t sleeping = 0;   // Workers of this node with nothing local to do
+        size_t stealHints = 0; // Wake-ups asking a sleeper to steal from a busy node
+        bool stop = false;
+    };
+
+    NumaTopology topo;
+    std::vector<std::unique_ptr<NodeQueue>> queues;
+    std::vector<std::thread> workers;
+    std::vector<int> workerNodes;
+    std::atomic<size_t> outstanding{0}; // Queued or running
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+
+    static thread_local int tlsNode;
+
+    std::vector<int> chooseCpus(size_t numThreads, const PlacementPolicy& policy) const {
+        std::vector<int> order;
+        switch (policy.kind) {
+        case Placement::None:
+            return {};
+        case Placement::Explicit:
+            order = policy.cpus;
+            break;
+        case Placement::Compact:
+            for (const auto& cpus : topo.nodeCpus) order.insert(order.end(), cpus.begin(), cpus.end());
+            break;
+        case Placement::Scatter: {
+            size_t longest = 0;
+            for (const auto& cpus : topo.nodeCpus) longest = std::max(longest, cpus.size());
+            for (size_t i = 0; i < longest; ++i)
+                for (const auto& cpus : topo.nodeCpus)
+                    if (i < cpus.size()) order.push_back(cpus[i]);
+            break;
+        }
+        }
+        if (order.empty()) return {};
+        // More workers than CPUs: wrap around (oversubscription, but still placed)
+        std::vector<int> result(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) result[i] = order[i % order.size()];
+        return result;
+    }
+
+    int callerNode() const {
+        if (tlsNode >= 0) return tlsNode;
+#ifdef __linux__
+        int cpu = sched_getcpu();
+        if (cpu >= 0) return topo.nodeOfCpu(cpu);
+#endif
+        return 0;
+    }
+
+    static void pinTo(int cpu) {
+#ifdef __linux__
+        if (cpu < 0) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        // Failure (e.g. CPU offlined meanwhile) just leaves the worker unpinned
+        sched_setaffinity(0, sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+
+    /* Steals only from nodes whose workers are all busy (none sleeping): a node with an idle
+       worker was notified and will run its own task. Nodes without workers are always
+       stolen from. */
+    bool steal(int node, Task& task) {
+        size_t n = queues.size();
+        for (size_t k = 1; k < n; ++k) {
+            NodeQueue& q = *queues[(node + k) % n];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (q.tasks.empty() || q.sleeping > 0) continue;
+            task = std::move(q.tasks.back()); // Steal from the cold end
+            q.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int cpu, int node) {
+        pinTo(cpu);
+        tlsNode = node;
+        NodeQueue& q = *queues[node];
+        while (true) {
+            Task task;
+            bool got = false;
+            {
+                std::lock_guard<std::mutex> lock(q.mtx);
+                if (!q.tasks.empty()) {
+                    task = std::move(q.tasks.front()); // FIFO for local work
+                    q.tasks.pop_front();
+                    got = true;
+                } else {
+                    ++q.sleeping; // From here on enqueue() may send us a steal hint
+                }
+            }
+            if (!got) {
+                // Counted as sleeping before looking elsewhere, so a hint sent meanwhile is not lost
+                got = steal(node, task);
+                std::unique_lock<std::mutex> lock(q.mtx);
+                if (!got) {
+                    q.wake.wait(lock, [&q] { return !q.tasks.empty() || q.stealHints > 0 || q.stop; });
+                    if (q.stealHints > 0) --q.stealHints;
+                }
+                --q.sleeping;
+                if (!got) {
+                    if (q.stop && q.tasks.empty()) return;
+                    continue; // Local task or hint: look again
+                }
+            }
+            task(); // Execute the task
+            if (outstanding.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(idleMutex); // Pairs with the check in waitIdle()
+                idleCondition.notify_all();
+            }
+        }
+    }
+};
+
+thread_local int NumaThreadPool::tlsNode = -1;
+
+// ✅ Memory-bandwidth-bound benchmark
+/* Every task streams over its own chunk of a large array (read + sum).
+   Baseline: unpinned pool, every chunk allocated and first-touched by main() (so on one node).
+   NUMA:     scatter-pinned pool, chunk i allocated on node i % nodes, initialised by a worker of
+             that node, and the summing task queued on the same node. */
+struct Chunk {
+    uint64_t* data;
+    size_t count;
+    int node;
+};
+
+double runBandwidthBenchmark(const char* label, NumaThreadPool& pool, bool numaAware,
+                             size_t chunks, size_t chunkElems, int passes) {
+    std::vector<Chunk> data(chunks);
+    size_t unbound = 0;
+    for (size_t i = 0; i < chunks; ++i) {
+        int node = numaAware ? static_cast<int>(i % pool.numNodes()) : 0;
+        bool bound = false;
+        int kernelNode = numaAware ? pool.kernelNodeId(node) : -1;
+        data[i] = {static_cast<uint64_t*>(allocOnNode(chunkElems * sizeof(uint64_t), kernelNode, &bound)),
+                   chunkElems, node};
+        if (!data[i].data) {
+            std::cerr << "mmap failed\n";
+            std::exit(1);
+        }
+        if (kernelNode >= 0 && !bound) ++unbound;
+    }
+    // 🚨 Chunks that mbind refused still get first-touch placement from their node's worker
+    if (unbound) std::cout << label << ": mbind failed for " << unbound << " chunk(s), using first touch\n";
+
+    // First touch: NUMA-aware chunks are initialised on their own node
+    for (size_t i = 0; i < chunks; ++i) {
+        Chunk c = data[i];
+        auto init = [c] { for (size_t j = 0; j < c.count; ++j) c.data[j] = j; };
+        if (numaAware) pool.enqueue(init, c.node);
+        else init();
+    }
+    pool.waitIdle();
+
+    std::atomic<uint64_t> total(0);
+    std::atomic<size_t> stolen(0); // Summing tasks that ran on another node than their chunk
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (size_t i = 0; i < chunks; ++i) {
+            Chunk c = data[i];
+            pool.enqueue([c, &total, &stolen] {
+                uint64_t sum = 0;
+                for (size_t j = 0; j < c.count; ++j) sum += c.data[j];
+                total.fetch_add(sum, std::memory_order_relaxed);
+                if (NumaThreadPool::currentNode() != c.node) stolen.fetch_add(1, std::memory_order_relaxed);
+            }, numaAware ? c.node : -1);
+        }
+    }
+    pool.waitIdle();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double gb = static_cast<double>(chunks) * chunkElems * sizeof(uint64_t) * passes / 1e9;
+    std::cout << label << ": " << gb / seconds << " GB/s (checksum " << total.load() << ")\n";
+    if (numaAware)
+        std::cout << "  " << stolen.load() << " of " << chunks * passes << " tasks ran off their node\n";
+
+    for (Chunk& c : data) freeOnNode(c.data, c.count * sizeof(uint64_t));
+    return gb / seconds;
+}
+
+int main(int argc, char** argv) {
+    NumaTopology topo = NumaTopology::detect();
+    std::cout << "Detected " << topo.numNodes() << " NUMA node(s)\n";
+    for (size_t n = 0; n < topo.numNodes(); ++n)
+        std::cout << "  node " << n << " (kernel id " << topo.nodeIds[n] << "): " << topo.nodeCpus[n].size()
+                  << " CPU(s)\n";
+
+    size_t threads = 0;
+    for (const auto& cpus : topo.nodeCpus) threads += cpus.size();
+    size_t megabytesPerChunk = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 64;
+    size_t chunkElems = megabytesPerChunk * 1024 * 1024 / sizeof(uint64_t);
+    size_t chunks = threads * 2;
+    const int passes = 5;
+
+    // ✅ Demonstrate placement policies
+    {
+        NumaThreadPool pool(threads, PlacementPolicy::compact());
+        std::cout << "Compact placement -> worker nodes:";
+        for (int node : pool.nodesOfWorkers()) std::cout << ' ' << node;
+        std::cout << "\n";
+    }
+    {
+        NumaThreadPool pool(threads, PlacementPolicy::explicitCpus(topo.nodeCpus[0]));
+        pool.enqueue([] { std::cout << "Task executed on node " << NumaThreadPool::currentNode() << "\n"; }, 0);
+        pool.waitIdle();
+    }
+
+    if (topo.numNodes() == 1)
+        std::cout << "Single-node machine: both runs should be roughly equal\n";
+
+    double baseline, placed;
+    {
+        NumaThreadPool pool(threads, PlacementPolicy::none());
+        baseline = runBandwidthBenchmark("Unpinned, main-thread allocation", pool, false, chunks, chunkElems, passes);
+    }
+    {
+        NumaThreadPool pool(threads, PlacementPolicy::scatter());
+        placed = runBandwidthBenchmark("Scatter-pinned, node-local data  ", pool, true, chunks, chunkElems, passes);
+    }
+    std::cout << "Speedup: " << placed / baseline << "x\n";
+    return 0;
+}
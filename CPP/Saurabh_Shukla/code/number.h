@@ -0,0 +1,155 @@
+#ifndef NUMBER_H
+#define NUMBER_H
+
+#include <charconv>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include "expected.h"
+
+/* Number from operator_overloading.cpp, shared with NumberArray (number_array.h).
+   The checked operations (checkedDivide, checkedModulo, parse) report failures as an
+   expected<Number, NumberError> instead of throwing, for hot paths where failures are common. */
+
+enum class NumberError { DivisionByZero, ModuloByZero, EmptyInput, InvalidCharacter, OutOfRange };
+
+inline const char* describe(NumberError e) {
+    switch (e) {
+    case NumberError::DivisionByZero: return "Division by zero!";
+    case NumberError::ModuloByZero: return "Modulo by zero!";
+    case NumberError::EmptyInput: return "Empty input";
+    case NumberError::InvalidCharacter: return "Invalid character in number";
+    case NumberError::OutOfRange: return "Number out of range";
+    }
+    return "Unknown error";
+}
+
+class Number {
+private:
+    int value;
+
+public:
+    // Constructor
+    Number(int v = 0) : value(v) {}
+
+    // Copy Constructor (Important when dealing with deep copies)
+    Number(const Number& other) {
+        value = other.value;
+    }
+
+    // Overloading Assignment Operator
+    Number& operator=(const Number& other) {
+        if (this != &other) { // Prevent self-assignment
+            value = other.value;
+        }
+        return *this;
+    }
+
+    // Overloading Unary Minus (-n)
+    Number operator-() const {
+        return Number(-value);
+    }
+
+    // Overloading Prefix Increment (++n)
+    Number& operator++() {
+        ++value;
+        return *this;
+    }
+
+    // Overloading Postfix Increment (n++)
+    Number operator++(int) {
+        Number temp = *this;
+        ++value;
+        return temp;
+    }
+
+    // Overloading Binary Addition (n1 + n2)
+    Number operator+(const Number& other) const {
+        return Number(value + other.value);
+    }
+
+    // Overloading Binary Subtraction (n1 - n2)
+    Number operator-(const Number& other) const {
+        return Number(value - other.value);
+    }
+
+    // Overloading Multiplication
+    Number operator*(const Number& other) const {
+        return Number(value * other.value);
+    }
+
+    // Overloading Division (with zero-check)
+    Number operator/(const Number& other) const {
+        if (other.value == 0) {
+            throw std::runtime_error("Division by zero!");
+        }
+        return Number(value / other.value);
+    }
+
+    // Overloading Modulus
+    Number operator%(const Number& other) const {
+        if (other.value == 0) {
+            throw std::runtime_error("Modulo by zero!");
+        }
+        return Number(value % other.value);
+    }
+
+    // ✅ Non-throwing division and modulus: the error is a return value
+    expected<Number, NumberError> checkedDivide(const Number& other) const {
+        if (other.value == 0) return make_unexpected(NumberError::DivisionByZero);
+        return Number(value / other.value);
+    }
+
+    expected<Number, NumberError> checkedModulo(const Number& other) const {
+        if (other.value == 0) return make_unexpected(NumberError::ModuloByZero);
+        return Number(value % other.value);
+    }
+
+    // ✅ Parses a whole string ("42", "-7") without exceptions or locale lookups
+    static expected<Number, NumberError> parse(std::string_view text) {
+        if (text.empty()) return make_unexpected(NumberError::EmptyInput);
+        int v = 0;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), v);
+        if (ec == std::errc::result_out_of_range) return make_unexpected(NumberError::OutOfRange);
+        if (ec != std::errc() || end != text.data() + text.size())
+            return make_unexpected(NumberError::InvalidCharacter);
+        return Number(v);
+    }
+
+    // Overloading Comparison Operators
+    bool operator==(const Number& other) const { return value == other.value; }
+    bool operator!=(const Number& other) const { return value != other.value; }
+    bool operator<(const Number& other) const { return value < other.value; }
+    bool operator>(const Number& other) const { return value > other.value; }
+    bool operator<=(const Number& other) const { return value <= other.value; }
+    bool operator>=(const Number& other) const { return value >= other.value; }
+
+    // Overloading Stream Insertion (<<) using Friend Function
+    friend std::ostream& operator<<(std::ostream& os, const Number& n) {
+        os << n.value;
+        return os;
+    }
+
+    // Overloading Stream Extraction (>>) using Friend Function
+    friend std::istream& operator>>(std::istream& is, Number& n) {
+        is >> n.value;
+        return is;
+    }
+
+    // Overloading Subscript Operator ([])
+    int operator[](int index) const {
+        return value * index;  // Just an example (no real use case)
+    }
+
+    // Overloading Function Call Operator ()
+    void operator()() const {
+        std::cout << "Number is: " << value << std::endl;
+    }
+
+    // Overloading Type Conversion (int)
+    operator int() const {
+        return value;
+    }
+};
+
+#endif // NUMBER_H
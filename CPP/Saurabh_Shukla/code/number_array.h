@@ -0,0 +1,205 @@
+#ifndef NUMBER_ARRAY_H
+#define NUMBER_ARRAY_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "number.h"
+
+/* NumberArray: an array of Numbers with lazy (expression template) arithmetic.
+   - a*b + c - d/e does not compute anything: each operator returns a small node that remembers
+     its operands (arrays by reference, sub-expressions by value). Assigning the tree to a
+     NumberArray runs one fused loop, out[i] = a[i]*b[i] + c[i] - d[i]/e[i], with no temporary
+     arrays and no per-element Number objects, which the compiler can vectorize.
+   - Division by zero still throws std::runtime_error("Division by zero!") like Number::operator/.
+     Inside the loop a zero divisor only sets a flag (and is replaced by 1 so the loop keeps its
+     shape); the exception is thrown after the loop. A NumberArray being constructed from the
+     expression is then never created; an existing NumberArray being assigned to keeps whatever
+     the loop wrote (basic guarantee).
+   - Division goes through double: for 32-bit ints, trunc(double(a) / double(b)) == a / b exactly,
+     and SIMD has double division but no integer division.
+   - Operands must have equal sizes (std::length_error otherwise); a Number operand is
+     broadcast to every element.
+*/
+
+class NumberArray;
+
+namespace number_expr {
+
+// CRTP base of every array-valued expression
+template <typename E>
+struct Expr {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+struct Add {
+    static int apply(int a, int b, int&) { return a + b; }
+};
+struct Sub {
+    static int apply(int a, int b, int&) { return a - b; }
+};
+struct Mul {
+    static int apply(int a, int b, int&) { return a * b; }
+};
+struct Div {
+    static int apply(int a, int b, int& zero) {
+        zero |= (b == 0);
+        int safe = b | (b == 0); // 0 -> 1, branch-free
+        return static_cast<int>(static_cast<double>(a) / static_cast<double>(safe));
+    }
+};
+
+template <typename E>
+struct Stored {
+    using type = E; // Sub-expressions are tiny and may be temporaries: keep a copy
+};
+
+template <>
+struct Stored<NumberArray> {
+    using type = const NumberArray&; // Arrays are never copied into the tree
+};
+
+template <typename L, typename R, typename Op>
+class BinaryExpr : public Expr<BinaryExpr<L, R, Op>> {
+public:
+    BinaryExpr(const L& l, const R& r) : lhs(l), rhs(r) {
+        if (lhs.size() != npos() && rhs.size() != npos() && lhs.size() != rhs.size())
+            throw std::length_error("NumberArray: size mismatch");
+    }
+    int eval(size_t i, int& zero) const { return Op::apply(lhs.eval(i, zero), rhs.eval(i, zero), zero); }
+    size_t size() const { return lhs.size() == npos() ? rhs.size() : lhs.size(); }
+
+private:
+    typename Stored<L>::type lhs;
+    typename Stored<R>::type rhs;
+    static constexpr size_t npos() { return static_cast<size_t>(-1); }
+};
+
+// A Number used in array arithmetic: same value for every element
+class Scalar : public Expr<Scalar> {
+public:
+    explicit Scalar(const Number& n) : value(static_cast<int>(n)) {}
+    explicit Scalar(int v) : value(v) {}
+    int eval(size_t, int&) const { return value; }
+    size_t size() const { return static_cast<size_t>(-1); } // Matches any size
+
+private:
+    int value;
+};
+
+template <typename E>
+class Negate : public Expr<Negate<E>> {
+public:
+    explicit Negate(const E& e) : inner(e) {}
+    int eval(size_t i, int& zero) const { return -inner.eval(i, zero); }
+    size_t size() const { return inner.size(); }
+
+private:
+    typename Stored<E>::type inner;
+};
+
+} // End of namespace number_expr
+
+class NumberArray : public number_expr::Expr<NumberArray> {
+public:
+    NumberArray() = default;
+    explicit NumberArray(size_t n, const Number& fill = Number()) : values(n, static_cast<int>(fill)) {}
+    NumberArray(std::initializer_list<int> init) : values(init) {}
+
+    // ✅ Evaluates the whole expression in one loop
+    template <typename E>
+    NumberArray(const number_expr::Expr<E>& e) {
+        assign(e.self());
+    }
+
+    template <typename E>
+    NumberArray& operator=(const number_expr::Expr<E>& e) {
+        assign(e.self());
+        return *this;
+    }
+
+    template <typename E>
+    NumberArray& operator+=(const number_expr::Expr<E>& e);
+    template <typename E>
+    NumberArray& operator-=(const number_expr::Expr<E>& e);
+    template <typename E>
+    NumberArray& operator*=(const number_expr::Expr<E>& e);
+
+    size_t size() const { return values.size(); }
+    Number operator[](size_t i) const { return Number(values[i]); }
+    void set(size_t i, const Number& n) { values[i] = static_cast<int>(n); }
+    const int* data() const { return values.data(); }
+    int* data() { return values.data(); }
+
+    int eval(size_t i, int&) const { return values[i]; }
+
+private:
+    std::vector<int> values;
+
+    template <typename E>
+    void assign(const E& e) {
+        size_t n = e.size();
+        if (n == static_cast<size_t>(-1)) throw std::length_error("NumberArray: expression has no array operand");
+        // Element i only reads element i of each operand, so a = a * b is safe; the size is
+        // unchanged in that case, so the vector is not reallocated under the expression
+        values.resize(n);
+        int* out = values.data();
+        int zero = 0;
+        for (size_t i = 0; i < n; ++i) out[i] = e.eval(i, zero);
+        if (zero) throw std::runtime_error("Division by zero!");
+    }
+};
+
+namespace number_expr {
+
+template <typename T>
+inline constexpr bool kIsScalar = std::is_same_v<T, Number> || std::is_integral_v<T>;
+
+template <typename T>
+using AsExpr = std::conditional_t<kIsScalar<T>, Scalar, T>;
+
+// At least one side must be an array expression; Number op Number stays Number's own operator
+template <typename L, typename R>
+inline constexpr bool kArrayOperands =
+    (std::is_base_of_v<Expr<L>, L> && (kIsScalar<R> || std::is_base_of_v<Expr<R>, R>)) ||
+    (kIsScalar<L> && std::is_base_of_v<Expr<R>, R>);
+
+// Wraps scalars, passes expressions (and arrays) through by reference
+template <typename T>
+decltype(auto) asExpr(const T& t) {
+    if constexpr (kIsScalar<T>) return Scalar(t);
+    else return (t);
+}
+
+template <typename Op, typename L, typename R>
+BinaryExpr<AsExpr<L>, AsExpr<R>, Op> make(const L& l, const R& r) {
+    return BinaryExpr<AsExpr<L>, AsExpr<R>, Op>(asExpr(l), asExpr(r));
+}
+
+template <typename L, typename R, std::enable_if_t<kArrayOperands<L, R>, int> = 0>
+auto operator+(const L& l, const R& r) { return make<Add>(l, r); }
+
+template <typename L, typename R, std::enable_if_t<kArrayOperands<L, R>, int> = 0>
+auto operator-(const L& l, const R& r) { return make<Sub>(l, r); }
+
+template <typename L, typename R, std::enable_if_t<kArrayOperands<L, R>, int> = 0>
+auto operator*(const L& l, const R& r) { return make<Mul>(l, r); }
+
+template <typename L, typename R, std::enable_if_t<kArrayOperands<L, R>, int> = 0>
+auto operator/(const L& l, const R& r) { return make<Div>(l, r); }
+
+template <typename E>
+Negate<E> operator-(const Expr<E>& e) { return Negate<E>(e.self()); }
+
+} // End of namespace number_expr
+
+template <typename E>
+NumberArray& NumberArray::operator+=(const number_expr::Expr<E>& e) { return *this = *this + e.self(); }
+template <typename E>
+NumberArray& NumberArray::operator-=(const number_expr::Expr<E>& e) { return *this = *this - e.self(); }
+template <typename E>
+NumberArray& NumberArray::operator*=(const number_expr::Expr<E>& e) { return *this = *this * e.self(); }
+
+#endif // NUMBER_ARRAY_H
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include "number_array.h"
+#include "../../../C/bench_harness.h"
+
+/* r = a*b + c - d/e over arrays of Numbers:
+   - eager: operators on std::vector<Number> that each return a new vector (the Number operators
+     applied element-wise), so the expression allocates and fills four temporary arrays,
+   - element_loop: one hand-written loop of Number operators (no temporary arrays, but
+     Number::operator/ throws, so the loop cannot be vectorized),
+   - expression_template: NumberArray, one fused loop generated from the expression.
+   Build with -O3 (plus -march=native for 256-bit vectors): GCC's -O2 cost model does not
+   vectorize the fused loop. Usage: ./number_array_benchmark [elements] [bench_harness options]
+   (default 10,000,000) */
+
+using EagerArray = std::vector<Number>;
+
+template <typename Op>
+EagerArray elementwise(const EagerArray& x, const EagerArray& y, Op op) {
+    EagerArray out;
+    out.reserve(x.size());
+    for (size_t i = 0; i < x.size(); ++i) out.push_back(op(x[i], y[i]));
+    return out;
+}
+EagerArray operator+(const EagerArray& x, const EagerArray& y) {
+    return elementwise(x, y, [](const Number& p, const Number& q) { return p + q; });
+}
+EagerArray operator-(const EagerArray& x, const EagerArray& y) {
+    return elementwise(x, y, [](const Number& p, const Number& q) { return p - q; });
+}
+EagerArray operator*(const EagerArray& x, const EagerArray& y) {
+    return elementwise(x, y, [](const Number& p, const Number& q) { return p * q; });
+}
+EagerArray operator/(const EagerArray& x, const EagerArray& y) {
+    return elementwise(x, y, [](const Number& p, const Number& q) { return p / q; });
+}
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> small(-1000, 1000), divisor(1, 100);
+    NumberArray a(count), b(count), c(count), d(count), e(count);
+    EagerArray ea(count), eb(count), ec(count), ed(count), ee(count);
+    for (size_t i = 0; i < count; ++i) {
+        int s = divisor(rng) * (rng() & 1 ? 1 : -1);
+        a.set(i, small(rng)); b.set(i, small(rng)); c.set(i, small(rng)); d.set(i, small(rng)); e.set(i, s);
+        ea[i] = a[i]; eb[i] = b[i]; ec[i] = c[i]; ed[i] = d[i]; ee[i] = e[i];
+    }
+
+    EagerArray eagerResult;
+    bench_result_t* r = bench::run(&session, "eager_temporaries", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            eagerResult = ea * eb + ec - ed / ee;
+            bench::doNotOptimize(eagerResult.data());
+        }
+    });
+    bench_set_items(r, static_cast<double>(count));
+
+    EagerArray loopResult(count);
+    r = bench::run(&session, "element_loop", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            for (size_t i = 0; i < count; ++i) loopResult[i] = ea[i] * eb[i] + ec[i] - ed[i] / ee[i];
+            bench::doNotOptimize(loopResult.data());
+        }
+    });
+    bench_set_items(r, static_cast<double>(count));
+
+    NumberArray fused(count);
+    r = bench::run(&session, "expression_template", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            fused = a * b + c - d / e;
+            bench::doNotOptimize(fused.data());
+        }
+    });
+    bench_set_items(r, static_cast<double>(count));
+
+    // ✅ Same results, and division by zero still throws
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) mismatches += (fused[i] != eagerResult[i]) + (fused[i] != loopResult[i]);
+    std::cout << "\nmismatches: " << mismatches << "\n";
+    e.set(count / 2, 0);
+    try {
+        NumberArray bad = a * b + c - d / e;
+        std::cout << "no exception (BUG)\n";
+    } catch (const std::runtime_error& ex) {
+        std::cout << "zero divisor: " << ex.what() << "\n";
+    }
+    return bench_session_finish(&session);
+}
@@ -1,113 +1,9 @@
 #include <iostream>
+#include "number.h"
 using namespace std;
 
 /* read comments: https://chatgpt.com/share/67e0c54f-3dc0-8003-a99f-a27b94a7d529 */
-class Number {
-private:
-    int value;
-
-public:
-    // Constructor
-    Number(int v = 0) : value(v) {}
-
-    // Copy Constructor (Important when dealing with deep copies)
-    Number(const Number& other) {
-        value = other.value;
-    }
-
-    // Overloading Assignment Operator
-    Number& operator=(const Number& other) {
-        if (this != &other) { // Prevent self-assignment
-            value = other.value;
-        }
-        return *this;
-    }
-
-    // Overloading Unary Minus (-n)
-    Number operator-() const {
-        return Number(-value);
-    }
-
-    // Overloading Prefix Increment (++n)
-    Number& operator++() {
-        ++value;
-        return *this;
-    }
-
-    // Overloading Postfix Increment (n++)
-    Number operator++(int) {
-        Number temp = *this;
-        ++value;
-        return temp;
-    }
-
-    // Overloading Binary Addition (n1 + n2)
-    Number operator+(const Number& other) const {
-        return Number(value + other.value);
-    }
-
-    // Overloading Binary Subtraction (n1 - n2)
-    Number operator-(const Number& other) const {
-        return Number(value - other.value);
-    }
-
-    // Overloading Multiplication
-    Number operator*(const Number& other) const {
-        return Number(value * other.value);
-    }
-
-    // Overloading Division (with zero-check)
-    Number operator/(const Number& other) const {
-        if (other.value == 0) {
-            throw runtime_error("Division by zero!");
-        }
-        return Number(value / other.value);
-    }
-
-    // Overloading Modulus
-    Number operator%(const Number& other) const {
-        if (other.value == 0) {
-            throw runtime_error("Modulo by zero!");
-        }
-        return Number(value % other.value);
-    }
-
-    // Overloading Comparison Operators
-    bool operator==(const Number& other) const { return value == other.value; }
-    bool operator!=(const Number& other) const { return value != other.value; }
-    bool operator<(const Number& other) const { return value < other.value; }
-    bool operator>(const Number& other) const { return value > other.value; }
-    bool operator<=(const Number& other) const { return value <= other.value; }
-    bool operator>=(const Number& other) const { return value >= other.value; }
-
-    // Overloading Stream Insertion (<<) using Friend Function
-    friend ostream& operator<<(ostream& os, const Number& n) {
-        os << n.value;
-        return os;
-    }
-
-    // Overloading Stream Extraction (>>) using Friend Function
-    friend istream& operator>>(istream& is, Number& n) {
-        is >> n.value;
-        return is;
-    }
-
-    // Overloading Subscript Operator ([])
-    int operator[](int index) const {
-        return value * index;  // Just an example (no real use case)
-    }
-
-    // Overloading Function Call Operator ()
-    void operator()() const {
-        cout << "Number is: " << value << endl;
-    }
-
-    // Overloading Type Conversion (int)
-    operator int() const {
-        return value;
-    }
-};
-
+/* Number lives in number.h, so NumberArray (number_array.h) can build array expressions of it */
 int main() {
     Number n1(10), n2(5), n3;
 
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include "closed_hierarchy.h"
+#include "../../../C/bench_harness.h"
+
+/* Total area of N heterogeneous shapes (4 types, random order), as in pure_virtual_function.cpp:
+   - virtual: std::vector<std::unique_ptr<Shape>>, one heap object and one indirect call each,
+   - virtual_sorted: same objects, pointers sorted by type (predictable indirect branch, but the
+     heap objects are now visited out of allocation order),
+   - variant: VariantVector of the value types, std::visit per object,
+   - type_batches: TypeBatches of the CRTP value types, one tight loop per type.
+   Usage: ./polymorphism_benchmark [objects] [bench_harness options]   (default 10,000,000) */
+
+// ✅ Virtual hierarchy
+struct Shape {
+    virtual ~Shape() = default;
+    virtual double area() const = 0;
+    virtual int kind() const = 0;
+};
+struct VCircle : Shape {
+    double r;
+    explicit VCircle(double r_) : r(r_) {}
+    double area() const override { return 3.141592653589793 * r * r; }
+    int kind() const override { return 0; }
+};
+struct VSquare : Shape {
+    double side;
+    explicit VSquare(double s) : side(s) {}
+    double area() const override { return side * side; }
+    int kind() const override { return 1; }
+};
+struct VRectangle : Shape {
+    double w, h;
+    VRectangle(double w_, double h_) : w(w_), h(h_) {}
+    double area() const override { return w * h; }
+    int kind() const override { return 2; }
+};
+struct VTriangle : Shape {
+    double base, height;
+    VTriangle(double b, double h) : base(b), height(h) {}
+    double area() const override { return 0.5 * base * height; }
+    int kind() const override { return 3; }
+};
+
+// ✅ Closed hierarchy: value types with a CRTP interface
+template <typename Derived>
+struct StaticShape : StaticInterface<Derived> {
+    double area() const { return this->self().areaImpl(); }
+};
+struct Circle : StaticShape<Circle> {
+    double r;
+    explicit Circle(double r_) : r(r_) {}
+    double areaImpl() const { return 3.141592653589793 * r * r; }
+};
+struct Square : StaticShape<Square> {
+    double side;
+    explicit Square(double s) : side(s) {}
+    double areaImpl() const { return side * side; }
+};
+struct Rectangle : StaticShape<Rectangle> {
+    double w, h;
+    Rectangle(double w_, double h_) : w(w_), h(h_) {}
+    double areaImpl() const { return w * h; }
+};
+struct Triangle : StaticShape<Triangle> {
+    double base, height;
+    Triangle(double b, double h) : base(b), height(h) {}
+    double areaImpl() const { return 0.5 * base * height; }
+};
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    std::vector<std::unique_ptr<Shape>> virtualShapes;
+    VariantVector<Circle, Square, Rectangle, Triangle> variantShapes;
+    TypeBatches<Circle, Square, Rectangle, Triangle> batches;
+    virtualShapes.reserve(count);
+    variantShapes.reserve(count);
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dim(0.5, 2.0);
+    for (size_t i = 0; i < count; ++i) {
+        double a = dim(rng), b = dim(rng);
+        switch (rng() % 4) {
+        case 0:
+            virtualShapes.emplace_back(new VCircle(a));
+            variantShapes.emplace_back(Circle(a));
+            batches.emplace<Circle>(a);
+            break;
+        case 1:
+            virtualShapes.emplace_back(new VSquare(a));
+            variantShapes.emplace_back(Square(a));
+            batches.emplace<Square>(a);
+            break;
+        case 2:
+            virtualShapes.emplace_back(new VRectangle(a, b));
+            variantShapes.emplace_back(Rectangle(a, b));
+            batches.emplace<Rectangle>(a, b);
+            break;
+        default:
+            virtualShapes.emplace_back(new VTriangle(a, b));
+            variantShapes.emplace_back(Triangle(a, b));
+            batches.emplace<Triangle>(a, b);
+            break;
+        }
+    }
+    std::vector<const Shape*> sortedByType;
+    sortedByType.reserve(count);
+    for (const auto& s : virtualShapes) sortedByType.push_back(s.get());
+    std::stable_sort(sortedByType.begin(), sortedByType.end(),
+                     [](const Shape* x, const Shape* y) { return x->kind() < y->kind(); });
+
+    double totals[4] = {0, 0, 0, 0};
+    bench_result_t* results[4];
+    bench_set_items(results[0] = bench::run(&session, "virtual", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            double total = 0;
+            for (const auto& s : virtualShapes) total += s->area();
+            totals[0] = total;
+            bench::doNotOptimize(total);
+        }
+    }), static_cast<double>(count));
+
+    bench_set_items(results[1] = bench::run(&session, "virtual_sorted", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            double total = 0;
+            for (const Shape* s : sortedByType) total += s->area();
+            totals[1] = total;
+            bench::doNotOptimize(total);
+        }
+    }), static_cast<double>(count));
+
+    bench_set_items(results[2] = bench::run(&session, "variant", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            double total = 0;
+            visit_all(variantShapes, [&total](const auto& s) { total += s.area(); });
+            totals[2] = total;
+            bench::doNotOptimize(total);
+        }
+    }), static_cast<double>(count));
+
+    bench_set_items(results[3] = bench::run(&session, "type_batches", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            double total = 0;
+            batches.for_each([&total](const auto& s) { total += s.area(); });
+            totals[3] = total;
+            bench::doNotOptimize(total);
+        }
+    }), static_cast<double>(count));
+
+    std::cout << "\nsizeof: VRectangle " << sizeof(VRectangle) << " + heap block, variant "
+              << sizeof(variantShapes[0]) << ", Rectangle " << sizeof(Rectangle) << "\n"
+              << "totals: virtual " << totals[0] << ", sorted " << totals[1] << ", variant " << totals[2]
+              << ", batches " << totals[3] << "\n";
+
+    // Every back-end that ran must find the same total; sorted and batches add in a different order
+    int failures = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (!results[0] || !results[i]) continue; // Filtered out
+        double tolerance = i == 2 ? 0 : 1e-9 * std::fabs(totals[0]);
+        if (std::fabs(totals[i] - totals[0]) > tolerance) {
+            std::cout << "CHECK FAILED: total " << i << " differs from virtual\n";
+            ++failures;
+        }
+    }
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
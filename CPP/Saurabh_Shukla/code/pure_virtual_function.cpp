@@ -1,4 +1,5 @@
 #include <iostream>
+#include "closed_hierarchy.h"
 using namespace std;
 
 // Abstract Base Class (ABC) with a Pure Virtual Function
@@ -72,6 +73,23 @@ public:
     }
 };
 
+/*
+   Closed Hierarchy Alternative (closed_hierarchy.h)
+   -------------------------------------------------
+   When every shape type is known up front, the same "draw any shape" can be written without
+   VPTR/VTABLE: each shape is a plain value type, a std::variant holds one of them, and
+   std::visit picks the right draw() from the variant's type index. Grouping objects by type
+   (TypeBatches) removes the per-object dispatch entirely.
+   The trade-off: adding a new shape means editing the variant's type list.
+*/
+struct CircleShape {
+    void draw() const { cout << "Drawing Circle (no vtable)" << endl; }
+};
+
+struct RectangleShape {
+    void draw() const { cout << "Drawing Rectangle (no vtable)" << endl; }
+};
+
 int main() {
     // Polymorphic behavior using base class pointer
     Shape* s1 = new Circle();   // VPTR points to Circle's VTABLE
@@ -97,5 +115,16 @@ int main() {
     delete s1; // Calls Circle's destructor, then Shape's destructor
     delete s2; // Calls Rectangle's destructor, then Shape's destructor
 
+    // Same calls through std::variant + std::visit: objects stored by value, no new/delete
+    VariantVector<CircleShape, RectangleShape> shapes = {CircleShape{}, RectangleShape{}, CircleShape{}};
+    visit_all(shapes, [](const auto& shape) { shape.draw(); });
+
+    // Grouped by type: all circles are drawn, then all rectangles
+    TypeBatches<CircleShape, RectangleShape> batches;
+    batches.emplace<CircleShape>();
+    batches.emplace<RectangleShape>();
+    batches.emplace<CircleShape>();
+    batches.for_each([](const auto& shape) { shape.draw(); });
+
     return 0;
 }
@@ -0,0 +1,119 @@
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/* Scalable counter: one cache-line-padded cell per thread, summed on read.
+   - A single std::atomic<int> hammered by N threads bounces one cache line between all cores;
+     every increment is a cross-core transfer. Here each thread owns its cell, so an increment
+     is an uncontended load + store on a line that stays in the owner's L1.
+   - Threads get a small index from a process-wide registry. Indices are recycled when a thread
+     exits, so long-running programs that keep creating threads do not run out of cells.
+   - Threads beyond MaxThreads share an overflow cell updated with fetch_add (still correct,
+     just slower).
+   - read(Relaxed): plain relaxed loads, cheapest; may lag behind in-flight increments.
+     read(Exact):   fence + acquire loads; includes every update that happened-before the call
+                    (e.g. after join()). While writers are running it is still a sum of
+                    per-cell loads taken one after the other, not a linearizable read: it
+                    need not be a total the counter ever held (for increment-only use it lies
+                    between the totals at the start and at the end of the read).
+*/
+
+enum class ReadMode { Relaxed, Exact };
+
+namespace detail {
+
+// Process-wide registry of small thread indices, recycled on thread exit
+class ThreadIndexRegistry {
+public:
+    static size_t current() {
+        thread_local Slot slot;
+        return slot.index;
+    }
+
+private:
+    struct Slot {
+        size_t index;
+        Slot() : index(acquire()) {}
+        ~Slot() { release(index); }
+    };
+
+    static std::mutex& registryMutex() { static std::mutex m; return m; }
+    static std::vector<size_t>& freeList() { static std::vector<size_t> v; return v; }
+    static size_t& nextIndex() { static size_t n = 0; return n; }
+
+    static size_t acquire() {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        if (!freeList().empty()) {
+            size_t index = freeList().back();
+            freeList().pop_back();
+            return index;
+        }
+        return nextIndex()++;
+    }
+
+    static void release(size_t index) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        freeList().push_back(index);
+    }
+};
+
+} // namespace detail
+
+template <size_t MaxThreads = 128>
+class ShardedCounter {
+public:
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(int64_t delta) {
+        size_t index = detail::ThreadIndexRegistry::current();
+        if (index < MaxThreads) {
+            // Only this thread writes this cell: no lock prefix needed, just keep it atomic
+            // so concurrent readers never see a torn value
+            std::atomic<int64_t>& v = cells[index].value;
+            v.store(v.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        } else {
+            overflow.value.fetch_add(delta, std::memory_order_relaxed);
+        }
+    }
+
+    void increment() { add(1); }
+    ShardedCounter& operator++() { add(1); return *this; }
+    void operator++(int) { add(1); }
+
+    int64_t read(ReadMode mode = ReadMode::Exact) const {
+        int64_t sum = 0;
+        if (mode == ReadMode::Relaxed) {
+            for (const Cell& c : cells) sum += c.value.load(std::memory_order_relaxed);
+            return sum + overflow.value.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (const Cell& c : cells) sum += c.value.load(std::memory_order_acquire);
+        return sum + overflow.value.load(std::memory_order_acquire);
+    }
+
+    int64_t load() const { return read(ReadMode::Exact); }
+
+    // Not safe against concurrent add(): call only while no thread is updating
+    void reset() {
+        for (Cell& c : cells) c.value.store(0, std::memory_order_relaxed);
+        overflow.value.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // One cell per cache line so neighbouring threads never false-share
+    struct alignas(64) Cell {
+        std::atomic<int64_t> value{0};
+    };
+
+    Cell cells[MaxThreads];
+    Cell overflow;
+};
+
+#endif // SHARDED_COUNTER_H
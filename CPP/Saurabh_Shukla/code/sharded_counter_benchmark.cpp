@@ -0,0 +1,84 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "sharded_counter.h"
+
+/* Scaling of a contended std::atomic<int> against ShardedCounter, 1 to 64 threads.
+   Unlike the single-shot timedFunction() in multithreading_timing.cpp, every point is repeated
+   and the median is reported, and threads start together on a barrier so thread creation cost
+   is not part of the measurement.
+   Usage: ./sharded_counter_benchmark [increments_per_thread]   (default 1,000,000) */
+
+constexpr int kRepetitions = 5;
+
+// Starts 'threads' workers together, runs body(i) in each, returns elapsed seconds
+template <typename Body>
+double timeThreads(int threads, Body body) {
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body();
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template <typename Run>
+double medianSeconds(Run run) {
+    std::vector<double> samples;
+    for (int r = 0; r < kRepetitions; ++r) samples.push_back(run());
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    long perThread = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    std::cout << "Increments per thread: " << perThread << ", median of " << kRepetitions
+              << " runs, hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+    std::cout << std::setw(8) << "threads" << std::setw(20) << "atomic<int> Mops/s"
+              << std::setw(20) << "sharded Mops/s" << std::setw(10) << "speedup" << "\n";
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        std::atomic<int> counter(0);
+        ShardedCounter<> sharded;
+        bool ok = true;
+
+        double atomicSec = medianSeconds([&] {
+            counter.store(0);
+            double s = timeThreads(threads, [&] {
+                for (long i = 0; i < perThread; ++i) counter++;
+            });
+            ok = ok && counter.load() == static_cast<int>(threads * perThread);
+            return s;
+        });
+        double shardedSec = medianSeconds([&] {
+            sharded.reset();
+            double s = timeThreads(threads, [&] {
+                for (long i = 0; i < perThread; ++i) sharded.increment();
+            });
+            ok = ok && sharded.read(ReadMode::Exact) == threads * perThread;
+            return s;
+        });
+
+        double total = static_cast<double>(threads) * perThread / 1e6;
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(1)
+                  << std::setw(20) << total / atomicSec << std::setw(20) << total / shardedSec
+                  << std::setw(9) << std::setprecision(2) << atomicSec / shardedSec << "x"
+                  << (ok ? "" : "   COUNT MISMATCH") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,254 @@
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Ordered map for many threads that insert and read concurrently (a person index keyed by age),
+   where a mutex around std::map serializes every operation.
+   - Skip list: every node is on level 0, about 1/4 of them also on level 1, 1/16 on level 2...
+     A search walks the top level and drops down, O(log n) expected, and level 0 is a sorted
+     linked list, so lower_bound + ++it is a range scan.
+   - Lock-free: insert links the node into level 0 with one CAS on the predecessor's next
+     pointer, then into its upper levels one CAS each. A failed CAS means another node was
+     linked there meanwhile; the insert re-walks from the same predecessor at that level only.
+     Readers never write and never wait; a node becomes visible once its level-0 link is in.
+   - Insert-only (like the memtable skip lists of LevelDB/RocksDB): nodes are never unlinked,
+     so a pointer a reader holds stays valid without hazard pointers or epochs, and the ABA
+     problem cannot arise. Everything is freed when the list is destroyed.
+   - Nodes come from per-thread arenas: each inserting thread bump-allocates from its own
+     64 KiB chunks, so inserts never contend on malloc and a node's tower is sized exactly.
+   - Keys are unique (insert returns false when the key exists). Keys and values are const once
+     inserted; compose the key (age << 32 | id) when several entries share an age.
+*/
+
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class ConcurrentSkipList {
+    static constexpr int kMaxHeight = 16; // Plenty for 4^16 entries
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    struct alignas(std::atomic<void*>) Node {
+        const Key key;
+        const Value value;
+        const int height;
+
+        template <typename K, typename V>
+        Node(K&& k, V&& v, int h) : key(std::forward<K>(k)), value(std::forward<V>(v)), height(h) {}
+
+        // The tower of next pointers is allocated right after the node
+        std::atomic<Node*>* next() { return reinterpret_cast<std::atomic<Node*>*>(this + 1); }
+    };
+
+    // Bump allocator owned by one inserting thread
+    struct Arena {
+        std::vector<std::unique_ptr<char[]>> chunks;
+        char* cursor = nullptr;
+        char* end = nullptr;
+
+        void* allocate(size_t bytes) {
+            constexpr size_t kAlign = alignof(Node);
+            bytes = (bytes + kAlign - 1) & ~(kAlign - 1);
+            if (static_cast<size_t>(end - cursor) < bytes) {
+                size_t size = bytes > kChunkSize ? bytes : kChunkSize;
+                chunks.emplace_back(new char[size + kAlign]);
+                char* base = chunks.back().get();
+                cursor = base + ((kAlign - reinterpret_cast<uintptr_t>(base) % kAlign) % kAlign);
+                end = cursor + size;
+            }
+            void* p = cursor;
+            cursor += bytes;
+            return p;
+        }
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Node*;
+        using reference = const Node&;
+
+        const_iterator() = default;
+        const Key& key() const { return node->key; }
+        const Value& value() const { return node->value; }
+        const Node& operator*() const { return *node; }
+        const Node* operator->() const { return node; }
+        const_iterator& operator++() {
+            node = node->next()[0].load(std::memory_order_acquire);
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator& o) const { return node == o.node; }
+        bool operator!=(const const_iterator& o) const { return node != o.node; }
+
+    private:
+        friend class ConcurrentSkipList;
+        explicit const_iterator(Node* n) : node(n) {}
+        Node* node = nullptr;
+    };
+
+    explicit ConcurrentSkipList(Compare compare = Compare())
+        : less(std::move(compare)), instanceId(nextInstanceId().fetch_add(1, std::memory_order_relaxed)) {
+        for (auto& h : head) h.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+    ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+    // Not concurrent with any other operation
+    ~ConcurrentSkipList() {
+        if (!std::is_trivially_destructible<Key>::value || !std::is_trivially_destructible<Value>::value) {
+            for (Node* n = head[0].load(std::memory_order_relaxed); n;) {
+                Node* next = n->next()[0].load(std::memory_order_relaxed);
+                n->~Node();
+                n = next;
+            }
+        }
+    }
+
+    // Thread safe. Returns false (and leaves the list unchanged) if the key is already there.
+    template <typename K, typename V>
+    bool insert(K&& key, V&& value) {
+        int height = randomHeight();
+        Node* node = newNode(std::forward<K>(key), std::forward<V>(value), height);
+        int top = maxHeight.load(std::memory_order_relaxed);
+        while (height > top && !maxHeight.compare_exchange_weak(top, height, std::memory_order_relaxed)) {}
+
+        Node* preds[kMaxHeight];
+        Node* succs[kMaxHeight];
+        Node* pred = nullptr; // nullptr is the head
+        for (int level = kMaxHeight - 1; level >= 0; --level) {
+            pred = spliceAt(node->key, level, pred, &succs[level]);
+            preds[level] = pred;
+        }
+
+        for (int level = 0; level < height; ++level) {
+            while (true) {
+                if (level == 0 && preds[0] && !less(preds[0]->key, node->key)) {
+                    node->~Node(); // Lost the race to an equal key: the arena space is abandoned
+                    return false;
+                }
+                node->next()[level].store(succs[level], std::memory_order_relaxed);
+                // Release: the node's key, value and lower links are visible with the pointer
+                if (link(preds[level])[level].compare_exchange_strong(succs[level], node, std::memory_order_release,
+                                                                      std::memory_order_relaxed))
+                    break;
+                preds[level] = spliceAt(node->key, level, preds[level], &succs[level]);
+            }
+        }
+        count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // First entry whose key is not less than key
+    const_iterator lower_bound(const Key& key) const {
+        Node* pred = nullptr;
+        Node* succ = nullptr;
+        for (int level = maxHeight.load(std::memory_order_acquire) - 1; level >= 0; --level) {
+            while ((succ = link(pred)[level].load(std::memory_order_acquire)) && less(succ->key, key)) pred = succ;
+        }
+        return const_iterator(succ);
+    }
+
+    const_iterator find(const Key& key) const {
+        const_iterator it = lower_bound(key);
+        return it != end() && !less(key, it.key()) ? it : end();
+    }
+
+    bool contains(const Key& key) const { return find(key) != end(); }
+
+    // f(key, value) for every entry in [from, to), in key order
+    template <typename F>
+    void scan(const Key& from, const Key& to, F&& f) const {
+        for (const_iterator it = lower_bound(from); it != end() && less(it.key(), to); ++it) f(it.key(), it.value());
+    }
+
+    const_iterator begin() const { return const_iterator(head[0].load(std::memory_order_acquire)); }
+    const_iterator end() const { return const_iterator(); }
+
+    // Exact when no insert is running
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+private:
+    Compare less;
+    const uint64_t instanceId;
+    std::atomic<Node*> head[kMaxHeight];
+    std::atomic<int> maxHeight{1};
+    std::atomic<size_t> count{0};
+    std::mutex arenasMutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<Arena>>> arenas;
+
+    static std::atomic<uint64_t>& nextInstanceId() {
+        static std::atomic<uint64_t> id(1);
+        return id;
+    }
+
+    std::atomic<Node*>* link(Node* n) { return n ? n->next() : head; }
+    const std::atomic<Node*>* link(Node* n) const { return n ? n->next() : head; }
+
+    // Starting from pred, the last node at this level whose key is <= key, and its successor
+    Node* spliceAt(const Key& key, int level, Node* pred, Node** succ) const {
+        Node* next;
+        while ((next = link(pred)[level].load(std::memory_order_acquire)) && !less(key, next->key)) pred = next;
+        *succ = next;
+        return pred;
+    }
+
+    // 1 with probability 3/4, 2 with 3/16, ...
+    static int randomHeight() {
+        thread_local uint64_t state = 0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int height = 1;
+        for (uint64_t bits = state; height < kMaxHeight && (bits & 3) == 0; bits >>= 2) ++height;
+        return height;
+    }
+
+    Arena& localArena() {
+        // One-entry cache per thread; instance ids are never reused, so a stale entry cannot match
+        thread_local uint64_t cachedId = 0;
+        thread_local Arena* cachedArena = nullptr;
+        if (cachedId == instanceId) return *cachedArena;
+
+        std::lock_guard<std::mutex> lock(arenasMutex);
+        std::thread::id self = std::this_thread::get_id();
+        Arena* arena = nullptr;
+        for (auto& entry : arenas)
+            if (entry.first == self) arena = entry.second.get();
+        if (!arena) {
+            arenas.emplace_back(self, std::make_unique<Arena>());
+            arena = arenas.back().second.get();
+        }
+        cachedId = instanceId;
+        cachedArena = arena;
+        return *arena;
+    }
+
+    template <typename K, typename V>
+    Node* newNode(K&& key, V&& value, int height) {
+        void* memory = localArena().allocate(sizeof(Node) + height * sizeof(std::atomic<Node*>));
+        Node* node = ::new (memory) Node(std::forward<K>(key), std::forward<V>(value), height);
+        for (int i = 0; i < height; ++i) ::new (&node->next()[i]) std::atomic<Node*>(nullptr);
+        return node;
+    }
+};
+
+#endif // SKIP_LIST_H
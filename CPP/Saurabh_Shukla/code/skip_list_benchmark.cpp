@@ -0,0 +1,170 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <algorithm>
+#include <cstdlib>
+#include "skip_list.h"
+#include "../../../C/bench_harness.h"
+
+/* Person index keyed by (age, id), preloaded, then T threads run a mix of
+   20% insert, 70% find, 10% range scan (lower_bound of an age, next 16 entries):
+   - std::map under one std::mutex,
+   - ConcurrentSkipList (lock-free, per-thread node arenas).
+   The total number of operations is split over the threads; median of kRepetitions runs.
+   Usage: ./skip_list_benchmark [preloaded] [operations]   (default 1,000,000 and 2,000,000) */
+
+constexpr int kRepetitions = 3;
+
+// Sorts by age, then id: all persons of one age are adjacent
+static uint64_t personKey(uint32_t age, uint32_t id) { return static_cast<uint64_t>(age) << 32 | id; }
+
+// Starts 'threads' workers together, runs body(t) in each, returns elapsed seconds
+template <typename Body>
+double timeThreads(int threads, Body body) {
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            body(t);
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& w : workers) w.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template <typename Run>
+double medianSeconds(Run run) {
+    std::vector<double> samples;
+    for (int r = 0; r < kRepetitions; ++r) samples.push_back(run());
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+struct Rng {
+    uint64_t state;
+    uint64_t next() { return bench_next_random(&state); }
+};
+
+// Same operation sequence for both containers: thread t's rng is seeded from t only
+template <typename Insert, typename Find, typename Scan>
+uint64_t runMix(int t, long ops, uint32_t idRange, Insert insert, Find find, Scan scan) {
+    Rng rng{0x9E3779B97F4A7C15ull * static_cast<uint64_t>(t + 1)};
+    uint64_t checksum = 0;
+    for (long i = 0; i < ops; ++i) {
+        uint64_t r = rng.next();
+        uint32_t age = static_cast<uint32_t>(r % 100);
+        uint32_t id = static_cast<uint32_t>((r >> 8) % idRange);
+        unsigned kind = static_cast<unsigned>((r >> 40) % 10);
+        if (kind < 2) checksum += insert(personKey(age, id), id);
+        else if (kind < 9) checksum += find(personKey(age, id));
+        else checksum += scan(personKey(age, 0));
+    }
+    return checksum;
+}
+
+int main(int argc, char** argv) {
+    long preload = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    long operations = (argc > 2) ? std::atol(argv[2]) : 2000000;
+    uint32_t idRange = static_cast<uint32_t>(preload * 2);
+    std::cout << "Preloaded: " << preload << ", operations: " << operations << " split over the threads, median of "
+              << kRepetitions << " runs, hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+    std::cout << std::setw(8) << "threads" << std::setw(22) << "mutex+map Mops/s" << std::setw(20)
+              << "skip list Mops/s" << std::setw(10) << "speedup" << "\n";
+    int failures = 0;
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        long perThread = operations / threads;
+        bool ok = true;
+        uint64_t mapChecksum = 0, skipChecksum = 0; // Of the last run
+
+        double mapSec = medianSeconds([&] {
+            std::map<uint64_t, uint32_t> index;
+            std::mutex lock;
+            Rng fill{42};
+            for (long i = 0; i < preload; ++i) {
+                uint32_t id = static_cast<uint32_t>(fill.next() % idRange);
+                index.emplace(personKey(static_cast<uint32_t>(fill.next() % 100), id), id);
+            }
+            std::atomic<uint64_t> checksum(0);
+            double s = timeThreads(threads, [&](int t) {
+                checksum += runMix(
+                    t, perThread, idRange,
+                    [&](uint64_t key, uint32_t id) -> uint64_t {
+                        std::lock_guard<std::mutex> g(lock);
+                        return index.emplace(key, id).second;
+                    },
+                    [&](uint64_t key) -> uint64_t {
+                        std::lock_guard<std::mutex> g(lock);
+                        auto it = index.find(key);
+                        return it == index.end() ? 0 : it->second;
+                    },
+                    [&](uint64_t from) -> uint64_t {
+                        std::lock_guard<std::mutex> g(lock);
+                        uint64_t sum = 0;
+                        int n = 0;
+                        for (auto it = index.lower_bound(from); it != index.end() && n < 16; ++it, ++n) sum += it->second;
+                        return sum;
+                    });
+            });
+            mapChecksum = checksum.load();
+            return s;
+        });
+
+        double skipSec = medianSeconds([&] {
+            ConcurrentSkipList<uint64_t, uint32_t> index;
+            Rng fill{42};
+            for (long i = 0; i < preload; ++i) {
+                uint32_t id = static_cast<uint32_t>(fill.next() % idRange);
+                index.insert(personKey(static_cast<uint32_t>(fill.next() % 100), id), id);
+            }
+            std::atomic<uint64_t> checksum(0);
+            double s = timeThreads(threads, [&](int t) {
+                checksum += runMix(
+                    t, perThread, idRange,
+                    [&](uint64_t key, uint32_t id) -> uint64_t { return index.insert(key, id); },
+                    [&](uint64_t key) -> uint64_t {
+                        auto it = index.find(key);
+                        return it == index.end() ? 0 : it.value();
+                    },
+                    [&](uint64_t from) -> uint64_t {
+                        uint64_t sum = 0;
+                        int n = 0;
+                        for (auto it = index.lower_bound(from); it != index.end() && n < 16; ++it, ++n) sum += it.value();
+                        return sum;
+                    });
+            });
+            // Level 0 must be sorted and hold exactly size() entries
+            size_t n = 0;
+            uint64_t previous = 0;
+            for (auto it = index.begin(); it != index.end(); ++it, ++n) {
+                ok = ok && (n == 0 || previous < it.key());
+                previous = it.key();
+            }
+            ok = ok && n == index.size();
+            skipChecksum = checksum.load();
+            return s;
+        });
+
+        // One thread runs the same operation sequence on both: every insert, find and scan must agree
+        if (threads == 1) ok = ok && mapChecksum != 0 && mapChecksum == skipChecksum;
+        failures += !ok;
+
+        double total = static_cast<double>(perThread) * threads / 1e6;
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2) << std::setw(22) << total / mapSec
+                  << std::setw(20) << total / skipSec << std::setw(9) << mapSec / skipSec << "x"
+                  << (ok ? "" : "   CHECK FAILED") << "\n";
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/* Generational-index object pool ("slot map").
+   - Objects live packed in one std::vector (no holes), so iterating over live objects is a linear
+     scan of contiguous memory.
+   - A Handle is 64 bits: 32-bit slot index + 32-bit generation (odd while the slot is occupied).
+     The slot table maps an index to the object's position in the packed array and remembers the
+     slot's generation.
+   - Erasing bumps the slot's generation, so every old handle to it becomes stale. get() detects
+     that with one compare: O(1), no atomics, no refcounts (unlike weak_ptr::lock()).
+   - Erase moves the last object into the hole (swap-and-pop), so pointers/references into the
+     pool are invalidated by insert/erase. Handles are the stable way to refer to objects.
+   Single-threaded by design: share a SlotMap between threads only under external locking.
+*/
+
+struct SlotHandle {
+    uint64_t value = 0; // 0 is never a valid handle (generation 0 is even, i.e. free)
+
+    SlotHandle() = default;
+    SlotHandle(uint32_t index, uint32_t generation)
+        : value((static_cast<uint64_t>(generation) << 32) | index) {}
+
+    uint32_t index() const { return static_cast<uint32_t>(value); }
+    uint32_t generation() const { return static_cast<uint32_t>(value >> 32); }
+    explicit operator bool() const { return value != 0; }
+    bool operator==(const SlotHandle& o) const { return value == o.value; }
+    bool operator!=(const SlotHandle& o) const { return value != o.value; }
+};
+
+template <typename T>
+class SlotMap {
+public:
+    using Handle = SlotHandle;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    void reserve(size_t n) {
+        values.reserve(n);
+        denseToSlot.reserve(n);
+        slots.reserve(n);
+    }
+
+    template <typename... Args>
+    Handle emplace(Args&&... args) {
+        // Construct and grow everything first: if any of it throws, the map is left as it was
+        values.emplace_back(std::forward<Args>(args)...);
+        try {
+            denseToSlot.push_back(kNoSlot);
+            if (freeHead == kNoSlot) slots.push_back({kNoSlot, 0}); // Even generation: still free
+        } catch (...) {
+            values.pop_back();
+            if (denseToSlot.size() > values.size()) denseToSlot.pop_back();
+            throw;
+        }
+
+        // Nothing below can throw: commit the slot
+        uint32_t index;
+        if (freeHead != kNoSlot) {
+            index = freeHead;
+            freeHead = slots[index].denseOrNext; // Reuse a free slot
+        } else {
+            index = static_cast<uint32_t>(slots.size() - 1);
+        }
+        slots[index].generation += 1; // even (free) -> odd (occupied)
+        slots[index].denseOrNext = static_cast<uint32_t>(values.size() - 1);
+        denseToSlot.back() = index;
+        return Handle(index, slots[index].generation);
+    }
+
+    Handle insert(const T& value) { return emplace(value); }
+    Handle insert(T&& value) { return emplace(std::move(value)); }
+
+    // O(1) lookup; nullptr if the handle is stale or was never valid
+    T* get(Handle h) {
+        uint32_t index = h.index();
+        if (index >= slots.size()) return nullptr;
+        const Slot& s = slots[index];
+        // Odd generation = occupied; a free slot's even generation never matches a real handle
+        if (s.generation != h.generation() || (s.generation & 1) == 0) return nullptr;
+        return &values[s.denseOrNext];
+    }
+
+    const T* get(Handle h) const { return const_cast<SlotMap*>(this)->get(h); }
+    bool contains(Handle h) const { return get(h) != nullptr; }
+
+    // Returns false if the handle was already stale
+    bool erase(Handle h) {
+        if (!get(h)) return false;
+        uint32_t index = h.index();
+        uint32_t dense = slots[index].denseOrNext;
+        uint32_t last = static_cast<uint32_t>(values.size() - 1);
+
+        // Swap-and-pop keeps the packed array hole-free
+        if (dense != last) {
+            values[dense] = std::move(values[last]);
+            denseToSlot[dense] = denseToSlot[last];
+            slots[denseToSlot[dense]].denseOrNext = dense;
+        }
+        values.pop_back();
+        denseToSlot.pop_back();
+
+        release(index);
+        return true;
+    }
+
+    void clear() {
+        for (uint32_t index : denseToSlot) release(index);
+        values.clear();
+        denseToSlot.clear();
+    }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    // Cache-friendly iteration over live objects only (order changes on erase)
+    iterator begin() { return values.begin(); }
+    iterator end() { return values.end(); }
+    const_iterator begin() const { return values.begin(); }
+    const_iterator end() const { return values.end(); }
+
+    // Handle of the object at a packed position (e.g. while iterating)
+    Handle handleAt(size_t dense) const {
+        uint32_t index = denseToSlot[dense];
+        return Handle(index, slots[index].generation);
+    }
+
+private:
+    static constexpr uint32_t kNoSlot = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t denseOrNext; // Occupied: position in 'values'. Free: next free slot index.
+        uint32_t generation;  // Odd while occupied; bumped on erase and on reuse
+    };
+
+    std::vector<T> values;           // Packed live objects
+    std::vector<uint32_t> denseToSlot; // values[i] belongs to slots[denseToSlot[i]]
+    std::vector<Slot> slots;
+    uint32_t freeHead = kNoSlot;
+
+    // Odd -> even marks the slot free and makes every old handle stale. On wrap-around the free
+    // generation is 0 and the next occupant gets 1, so a default (0) Handle never becomes valid.
+    void release(uint32_t index) {
+        Slot& s = slots[index];
+        s.generation += 1;
+        s.denseOrNext = freeHead;
+        freeHead = index;
+    }
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include "slot_map.h"
+#include "../../../C/bench_harness.h"
+
+/* Observing objects without owning them:
+   - old design: std::vector<std::shared_ptr<Node>> owns the nodes, observers hold std::weak_ptr
+     and call lock() (an atomic CAS loop on the control block) for every access,
+   - new design: SlotMap<Node> owns the nodes in contiguous storage, observers hold 64-bit
+     handles, and a stale handle is detected by one generation compare.
+   Usage: ./slot_map_benchmark [nodes] [bench_harness options]   (default 1,000,000 nodes) */
+
+// Same shape as the Node/SafeNode demo in smart_unique_weak_shared_pointers.cpp
+struct Node {
+    int data;
+    SlotHandle next; // Replaces std::weak_ptr<SafeNode> next
+    explicit Node(int val) : data(val) {}
+};
+
+struct SharedNode {
+    int data;
+    std::weak_ptr<SharedNode> next;
+    explicit SharedNode(int val) : data(val) {}
+};
+
+// ✅ The cycle demo from smart_unique_weak_shared_pointers.cpp with handles instead of weak_ptr
+void handleCycleDemo() {
+    SlotMap<Node> nodes;
+    SlotHandle node1 = nodes.emplace(1);
+    SlotHandle node2 = nodes.emplace(2);
+    nodes.get(node1)->next = node2; // No ownership, no refcount, no leak
+    nodes.get(node2)->next = node1;
+
+    nodes.erase(node2);
+    Node* n1 = nodes.get(node1);
+    std::cout << "node1 -> next is " << (nodes.get(n1->next) ? "alive" : "stale (detected)") << "\n";
+    nodes.emplace(3); // Reuses node2's slot with a new generation
+    std::cout << "after reuse, old handle is " << (nodes.get(n1->next) ? "alive (BUG)" : "still stale") << "\n\n";
+}
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+    std::thread([] {}).join(); // Make shared_ptr/weak_ptr use their real (atomic) code path
+
+    handleCycleDemo();
+
+    // Build both containers with the same contents
+    SlotMap<Node> slotMap;
+    slotMap.reserve(count);
+    std::vector<SlotHandle> handles;
+    std::vector<std::shared_ptr<SharedNode>> owners;
+    std::vector<std::weak_ptr<SharedNode>> observers;
+    for (size_t i = 0; i < count; ++i) {
+        handles.push_back(slotMap.emplace(static_cast<int>(i)));
+        owners.push_back(std::make_shared<SharedNode>(static_cast<int>(i)));
+    }
+    // Shuffle the heap objects' order relative to the vector, as after a long-running program.
+    // Handles go through the same permutation: owners[i] and handles[i] stay the same node.
+    std::mt19937_64 rng(42);
+    std::vector<uint32_t> perm(count);
+    for (size_t i = 0; i < count; ++i) perm[i] = static_cast<uint32_t>(i);
+    std::shuffle(perm.begin(), perm.end(), rng);
+    std::vector<std::shared_ptr<SharedNode>> shuffledOwners(count);
+    std::vector<SlotHandle> shuffledHandles(count);
+    for (size_t i = 0; i < count; ++i) {
+        shuffledOwners[i] = std::move(owners[perm[i]]);
+        shuffledHandles[i] = handles[perm[i]];
+    }
+    owners.swap(shuffledOwners);
+    handles.swap(shuffledHandles);
+    for (auto& sp : owners) observers.push_back(sp);
+
+    // Random lookup order shared by both designs
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(i);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    // ✅ Random lookups through observers
+    bench_set_items(bench::run(&session, "lookup_random/weak_ptr_lock", [&](uint64_t iters) {
+        long sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            if (auto sp = observers[order[i % count]].lock()) sum += sp->data;
+        }
+        bench::doNotOptimize(sum);
+    }), 1);
+    bench_set_items(bench::run(&session, "lookup_random/slot_map_get", [&](uint64_t iters) {
+        long sum = 0;
+        for (uint64_t i = 0; i < iters; ++i) {
+            if (Node* n = slotMap.get(handles[order[i % count]])) sum += n->data;
+        }
+        bench::doNotOptimize(sum);
+    }), 1);
+
+    // ✅ Iteration over all live objects (one iteration = one full pass)
+    bench_set_items(bench::run(&session, "iterate_all/vector_shared_ptr", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            long sum = 0;
+            for (const auto& sp : owners) sum += sp->data;
+            bench::doNotOptimize(sum);
+        }
+    }), static_cast<double>(count));
+    bench_set_items(bench::run(&session, "iterate_all/slot_map", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            long sum = 0;
+            for (const Node& n : slotMap) sum += n.data;
+            bench::doNotOptimize(sum);
+        }
+    }), static_cast<double>(count));
+
+    // ✅ Half of the objects destroyed: lookups now hit stale observers 50% of the time
+    for (size_t i = 0; i < count; i += 2) {
+        slotMap.erase(handles[i]);
+        owners[i].reset();
+    }
+    bench_set_items(bench::run(&session, "lookup_half_stale/weak_ptr_lock", [&](uint64_t iters) {
+        long alive = 0;
+        for (uint64_t i = 0; i < iters; ++i) alive += observers[order[i % count]].lock() ? 1 : 0;
+        bench::doNotOptimize(alive);
+    }), 1);
+    bench_set_items(bench::run(&session, "lookup_half_stale/slot_map_get", [&](uint64_t iters) {
+        long alive = 0;
+        for (uint64_t i = 0; i < iters; ++i) alive += slotMap.get(handles[order[i % count]]) ? 1 : 0;
+        bench::doNotOptimize(alive);
+    }), 1);
+
+    std::cout << "\nLive after erase: slot map " << slotMap.size() << ", shared_ptr "
+              << std::count_if(owners.begin(), owners.end(), [](const std::shared_ptr<SharedNode>& p) { return p != nullptr; })
+              << "\n";
+
+    // ✅ Both designs must see the same stale set and the same surviving values
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Node* n = slotMap.get(handles[i]);
+        std::shared_ptr<SharedNode> sp = observers[i].lock();
+        mismatches += (n != nullptr) != (sp != nullptr) || (n && n->data != sp->data);
+    }
+    std::cout << "check same stale set: " << (mismatches ? "MISMATCH" : "ok") << "\n";
+    int rc = bench_session_finish(&session);
+    return mismatches ? 1 : rc;
+}
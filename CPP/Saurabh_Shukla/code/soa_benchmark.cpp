@@ -0,0 +1,97 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include "soa_vector.h"
+#include "../../../C/bench_harness.h"
+
+/* Age scans over Person records (the struct from vector.cpp):
+   - AoS: std::vector<Person>, every scan strides over 40-byte structs (32 of them std::string),
+   - SoA: SoAVector<Person, &Person::name, &Person::age>, scans read the dense age column,
+     either directly (column<&Person::age>()) or through the proxy iterators.
+   Usage: ./soa_benchmark [persons] [bench_harness options]   (default 10,000,000) */
+
+struct Person {
+    std::string name;
+    int age;
+};
+
+using PersonSoA = SoAVector<Person, &Person::name, &Person::age>;
+
+template <typename Body>
+void runScan(bench_session_t* session, const char* name, size_t count, Body body) {
+    bench_result_t* r = bench::run(session, name, [&](uint64_t iters) {
+        for (uint64_t i = 0; i < iters; ++i) bench::doNotOptimize(body());
+    });
+    bench_set_items(r, static_cast<double>(count));
+    bench_set_bytes(r, static_cast<double>(count * sizeof(int))); // Useful bytes: one age per person
+}
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    const char* names[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Mallory", "Trent", "Peggy"};
+    std::mt19937 rng(11);
+    std::vector<Person> aos;
+    PersonSoA soa;
+    aos.reserve(count);
+    soa.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Person p{names[rng() % 8], static_cast<int>(rng() % 90)};
+        soa.push_back(p);
+        aos.push_back(std::move(p));
+    }
+    std::cout << "sizeof(Person) = " << sizeof(Person) << " bytes per age read in AoS, "
+              << sizeof(int) << " in SoA\n\n";
+
+    // ✅ Aggregate: sum of all ages
+    runScan(&session, "sum_age/aos", count, [&] {
+        long long sum = 0;
+        for (const Person& p : aos) sum += p.age;
+        return sum;
+    });
+    runScan(&session, "sum_age/soa_column", count, [&] {
+        long long sum = 0;
+        for (int age : soa.column<&Person::age>()) sum += age;
+        return sum;
+    });
+    runScan(&session, "sum_age/soa_iterator", count, [&] {
+        long long sum = 0;
+        for (auto it = soa.cbegin(); it != soa.cend(); ++it) sum += it->get<&Person::age>();
+        return sum;
+    });
+
+    // ✅ Filter: count and sum of the ages in [30, 40)
+    runScan(&session, "filter_30s/aos", count, [&] {
+        long long sum = 0, hits = 0;
+        for (const Person& p : aos) {
+            bool in = p.age >= 30 && p.age < 40;
+            hits += in;
+            sum += in ? p.age : 0;
+        }
+        return sum + hits;
+    });
+    runScan(&session, "filter_30s/soa_column", count, [&] {
+        long long sum = 0, hits = 0;
+        for (int age : soa.column<&Person::age>()) {
+            bool in = age >= 30 && age < 40;
+            hits += in;
+            sum += in ? age : 0;
+        }
+        return sum + hits;
+    });
+
+    // ✅ Same answers from both layouts, and the proxies round-trip whole records
+    long long a = 0, s = 0;
+    for (const Person& p : aos) a += p.age;
+    for (auto ref : soa) s += ref.get<&Person::age>();
+    Person last = soa.back();
+    int failures = !(a == s && last.name == aos.back().name && last.age == aos.back().age);
+    std::cout << "\nsum check: " << (failures ? "MISMATCH" : "ok") << ", last = " << last.name << " (" << last.age
+              << ")\n";
+    int rc = bench_session_finish(&session);
+    return failures ? 1 : rc;
+}
@@ -0,0 +1,244 @@
+#ifndef SOA_VECTOR_H
+#define SOA_VECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Structure-of-arrays container: SoAVector<Person, &Person::name, &Person::age> stores every listed
+   member in its own contiguous std::vector instead of one vector of whole structs.
+   - A scan that reads only 'age' walks a dense int array: no std::string bytes are dragged through
+     the cache, and loops over column<&Person::age>() auto-vectorize.
+   - push_back/insert/erase take and give whole T objects, so code written against
+     std::vector<T> mostly keeps working. Members that are not listed are not stored.
+   - operator[] and iterators return a proxy Reference (there is no T object in memory to point
+     at): ref.get<&Person::age>() reads/writes one field, ref = person stores all fields, and
+     T(ref) (or ref.load()) assembles a copy. Iterators are random access.
+   - erase keeps the order (shifts every column, O(n)); erase_unordered moves the last element
+     into the hole (O(1)), like the slot map in slot_map.h.
+*/
+
+namespace soa_detail {
+template <typename M>
+struct MemberTraits;
+
+template <typename C, typename F>
+struct MemberTraits<F C::*> {
+    using Class = C;
+    using Field = F;
+};
+
+template <auto M>
+using FieldOf = typename MemberTraits<decltype(M)>::Field;
+
+template <auto A, auto B>
+constexpr bool sameMember() {
+    if constexpr (std::is_same_v<decltype(A), decltype(B)>) return A == B;
+    else return false;
+}
+
+template <auto M, auto... Ms>
+constexpr size_t indexOf() {
+    constexpr bool matches[] = {sameMember<M, Ms>()...};
+    for (size_t i = 0; i < sizeof...(Ms); ++i)
+        if (matches[i]) return i;
+    return sizeof...(Ms);
+}
+} // namespace soa_detail
+
+template <typename T, auto... Members>
+class SoAVector {
+    static_assert(sizeof...(Members) > 0, "SoAVector needs at least one member");
+    static_assert((std::is_same_v<typename soa_detail::MemberTraits<decltype(Members)>::Class, T> && ...),
+                  "every member pointer must belong to T");
+
+    using Columns = std::tuple<std::vector<soa_detail::FieldOf<Members>>...>;
+
+    template <auto M>
+    static constexpr size_t columnIndex() {
+        constexpr size_t i = soa_detail::indexOf<M, Members...>();
+        static_assert(i < sizeof...(Members), "member is not stored in this SoAVector");
+        return i;
+    }
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    // Proxy for element i; Const selects read-only access
+    template <bool Const>
+    class BasicReference {
+        using Owner = std::conditional_t<Const, const SoAVector, SoAVector>;
+
+    public:
+        BasicReference(Owner* o, size_t i) : owner(o), index(i) {}
+
+        template <auto M>
+        decltype(auto) get() const {
+            return std::get<columnIndex<M>()>(owner->columns)[index];
+        }
+
+        T load() const {
+            T value{};
+            ((value.*Members = std::get<columnIndex<Members>()>(owner->columns)[index]), ...);
+            return value;
+        }
+        operator T() const { return load(); }
+
+        const BasicReference& operator=(const T& value) const {
+            static_assert(!Const, "assignment through a const reference");
+            ((std::get<columnIndex<Members>()>(owner->columns)[index] = value.*Members), ...);
+            return *this;
+        }
+
+    private:
+        Owner* owner;
+        size_t index;
+    };
+
+    using reference = BasicReference<false>;
+    using const_reference = BasicReference<true>;
+
+    template <bool Const>
+    class BasicIterator {
+        using Owner = std::conditional_t<Const, const SoAVector, SoAVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = BasicReference<Const>;
+
+        // Lets it->get<&T::field>() work on a temporary proxy
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        BasicIterator() = default;
+        BasicIterator(Owner* o, size_t i) : owner(o), index(i) {}
+        template <bool C = Const, std::enable_if_t<!C, int> = 0>
+        operator BasicIterator<true>() const { return BasicIterator<true>(owner, index); }
+
+        reference operator*() const { return reference(owner, index); }
+        pointer operator->() const { return pointer{reference(owner, index)}; }
+        reference operator[](difference_type n) const { return reference(owner, index + n); }
+
+        BasicIterator& operator++() { ++index; return *this; }
+        BasicIterator operator++(int) { BasicIterator old = *this; ++index; return old; }
+        BasicIterator& operator--() { --index; return *this; }
+        BasicIterator operator--(int) { BasicIterator old = *this; --index; return old; }
+        BasicIterator& operator+=(difference_type n) { index += n; return *this; }
+        BasicIterator& operator-=(difference_type n) { index -= n; return *this; }
+        BasicIterator operator+(difference_type n) const { return BasicIterator(owner, index + n); }
+        BasicIterator operator-(difference_type n) const { return BasicIterator(owner, index - n); }
+        friend BasicIterator operator+(difference_type n, const BasicIterator& it) { return it + n; }
+        difference_type operator-(const BasicIterator& o) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(o.index);
+        }
+
+        bool operator==(const BasicIterator& o) const { return index == o.index; }
+        bool operator!=(const BasicIterator& o) const { return index != o.index; }
+        bool operator<(const BasicIterator& o) const { return index < o.index; }
+        bool operator>(const BasicIterator& o) const { return index > o.index; }
+        bool operator<=(const BasicIterator& o) const { return index <= o.index; }
+        bool operator>=(const BasicIterator& o) const { return index >= o.index; }
+
+        size_t position() const { return index; }
+
+    private:
+        Owner* owner = nullptr;
+        size_t index = 0;
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    SoAVector() = default;
+    SoAVector(std::initializer_list<T> init) {
+        reserve(init.size());
+        for (const T& value : init) push_back(value);
+    }
+
+    size_t size() const { return std::get<0>(columns).size(); }
+    bool empty() const { return size() == 0; }
+
+    void reserve(size_t n) {
+        forEachColumn([n](auto& column) { column.reserve(n); });
+    }
+    void clear() {
+        forEachColumn([](auto& column) { column.clear(); });
+    }
+
+    void push_back(const T& value) { ((std::get<columnIndex<Members>()>(columns).push_back(value.*Members)), ...); }
+    void push_back(T&& value) {
+        ((std::get<columnIndex<Members>()>(columns).push_back(std::move(value.*Members))), ...);
+    }
+
+    iterator insert(const_iterator pos, const T& value) {
+        size_t i = pos.position();
+        ((insertAt(std::get<columnIndex<Members>()>(columns), i, value.*Members)), ...);
+        return iterator(this, i);
+    }
+
+    // Order-preserving erase: O(n - i) moves per column
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t b = first.position(), e = last.position();
+        forEachColumn([b, e](auto& column) { column.erase(column.begin() + b, column.begin() + e); });
+        return iterator(this, b);
+    }
+
+    // O(1) erase that moves the last element into position i (does not keep the order)
+    void erase_unordered(size_t i) {
+        forEachColumn([i](auto& column) {
+            if (i + 1 != column.size()) column[i] = std::move(column.back());
+            column.pop_back();
+        });
+    }
+
+    void pop_back() {
+        forEachColumn([](auto& column) { column.pop_back(); });
+    }
+
+    reference operator[](size_t i) { return reference(this, i); }
+    const_reference operator[](size_t i) const { return const_reference(this, i); }
+    reference front() { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // ✅ Direct access to one field's contiguous array (the fast path for scans)
+    template <auto M>
+    std::vector<soa_detail::FieldOf<M>>& column() {
+        return std::get<columnIndex<M>()>(columns);
+    }
+    template <auto M>
+    const std::vector<soa_detail::FieldOf<M>>& column() const {
+        return std::get<columnIndex<M>()>(columns);
+    }
+
+private:
+    Columns columns;
+
+    template <typename F>
+    void forEachColumn(F&& f) {
+        std::apply([&f](auto&... column) { (f(column), ...); }, columns);
+    }
+
+    template <typename Column, typename Field>
+    static void insertAt(Column& column, size_t i, const Field& value) {
+        column.insert(column.begin() + i, value);
+    }
+};
+
+#endif // SOA_VECTOR_H
@@ -0,0 +1,206 @@
+#ifndef SSO_STRING_H
+#define SSO_STRING_H
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+/* Production replacement for MyNamespace::String (dynamic_copy_constructor.cpp) and the deep-copy
+   mode of CopyExample (deep_shallow_copy.cpp).
+   - Small-string optimisation: up to kLocalCapacity characters live inside the object itself,
+     so short strings (names, keys, tags) never touch the heap.
+   - Move construction/assignment steals the heap buffer instead of copying it; std::vector
+     growth and std::sort then move strings around for free (the move operations are noexcept).
+   - Length is cached: size() is O(1), copies use memcpy instead of strlen + strcpy.
+   - reserve()/append() grow geometrically (x2), so n appends cost O(n) amortised.
+*/
+
+namespace MyNamespace {
+
+class SsoString {
+public:
+    static constexpr size_t kLocalCapacity = 15; // Characters stored in-place (plus '\0')
+
+    SsoString() noexcept : ptr(local), len(0) { local[0] = '\0'; }
+
+    SsoString(const char* s) : SsoString(s, std::strlen(s)) {}
+
+    SsoString(const char* s, size_t n) : ptr(local), len(0) {
+        local[0] = '\0';
+        assign(s, n);
+    }
+
+    // Copy Constructor (deep copy, but only allocates when the string does not fit in-place)
+    SsoString(const SsoString& other) : SsoString(other.ptr, other.len) {}
+
+    // Move Constructor: steals the heap buffer, or copies the (at most 16) in-place bytes
+    SsoString(SsoString&& other) noexcept : ptr(local), len(other.len) {
+        if (other.isLocal()) {
+            std::memcpy(local, other.local, other.len + 1);
+        } else {
+            ptr = other.ptr;
+            cap = other.cap;
+            other.ptr = other.local;
+        }
+        other.len = 0;
+        other.local[0] = '\0';
+    }
+
+    SsoString& operator=(const SsoString& other) {
+        if (this != &other) assign(other.ptr, other.len);
+        return *this;
+    }
+
+    SsoString& operator=(SsoString&& other) noexcept {
+        if (this == &other) return *this;
+        if (!other.isLocal()) {
+            release();
+            ptr = other.ptr;
+            cap = other.cap;
+            len = other.len;
+            other.ptr = other.local;
+        } else {
+            // Reuse our own buffer (in-place or heap, it is large enough for <= 15 chars)
+            std::memcpy(ptr, other.local, other.len + 1);
+            len = other.len;
+        }
+        other.len = 0;
+        other.local[0] = '\0';
+        return *this;
+    }
+
+    SsoString& operator=(const char* s) { return assign(s, std::strlen(s)); }
+
+    ~SsoString() { release(); }
+
+    SsoString& assign(const char* s, size_t n) {
+        if (n > capacity()) {
+            // Allocate first, so 's' may point into our own buffer
+            char* fresh = new char[n + 1];
+            std::memcpy(fresh, s, n);
+            release();
+            ptr = fresh;
+            cap = n;
+        } else {
+            std::memmove(ptr, s, n);
+        }
+        len = n;
+        ptr[len] = '\0';
+        return *this;
+    }
+
+    // ✅ Growth policy
+    void reserve(size_t n) {
+        if (n <= capacity()) return;
+        char* fresh = new char[n + 1];
+        std::memcpy(fresh, ptr, len + 1);
+        release();
+        ptr = fresh;
+        cap = n;
+    }
+
+    SsoString& append(const char* s, size_t n) {
+        if (len + n > capacity()) {
+            size_t doubled = capacity() * 2;
+            size_t needed = len + n;
+            // Copy out first when 's' aliases our buffer, since reserve() frees it
+            if (s >= ptr && s < ptr + len + 1) {
+                size_t offset = static_cast<size_t>(s - ptr);
+                reserve(needed > doubled ? needed : doubled);
+                s = ptr + offset;
+            } else {
+                reserve(needed > doubled ? needed : doubled);
+            }
+        }
+        std::memcpy(ptr + len, s, n);
+        len += n;
+        ptr[len] = '\0';
+        return *this;
+    }
+
+    SsoString& append(const char* s) { return append(s, std::strlen(s)); }
+    SsoString& append(const SsoString& s) { return append(s.ptr, s.len); }
+    SsoString& operator+=(const SsoString& s) { return append(s); }
+    SsoString& operator+=(const char* s) { return append(s); }
+    void push_back(char c) { append(&c, 1); }
+
+    void clear() noexcept {
+        len = 0;
+        ptr[0] = '\0';
+    }
+
+    // Gives heap memory back if the contents fit in-place again
+    void shrink_to_fit() {
+        if (isLocal() || len == cap) return;
+        if (len <= kLocalCapacity) {
+            char* old = ptr;
+            std::memcpy(local, old, len + 1);
+            delete[] old;
+            ptr = local;
+        } else {
+            char* fresh = new char[len + 1];
+            std::memcpy(fresh, ptr, len + 1);
+            delete[] ptr;
+            ptr = fresh;
+            cap = len;
+        }
+    }
+
+    size_t size() const noexcept { return len; }
+    size_t length() const noexcept { return len; }
+    bool empty() const noexcept { return len == 0; }
+    size_t capacity() const noexcept { return isLocal() ? kLocalCapacity : cap; }
+    const char* c_str() const noexcept { return ptr; }
+    const char* data() const noexcept { return ptr; }
+    char* data() noexcept { return ptr; }
+    char& operator[](size_t i) noexcept { return ptr[i]; }
+    const char& operator[](size_t i) const noexcept { return ptr[i]; }
+
+    char& at(size_t i) {
+        if (i >= len) throw std::out_of_range("SsoString::at");
+        return ptr[i];
+    }
+
+    int compare(const SsoString& other) const noexcept {
+        size_t n = len < other.len ? len : other.len;
+        int r = std::memcmp(ptr, other.ptr, n);
+        if (r != 0) return r;
+        return len < other.len ? -1 : (len > other.len ? 1 : 0);
+    }
+
+    // Function to display the string
+    void display() const { std::cout << "String: " << ptr << std::endl; }
+
+    friend bool operator==(const SsoString& a, const SsoString& b) noexcept {
+        return a.len == b.len && std::memcmp(a.ptr, b.ptr, a.len) == 0; // Length check first: O(1) reject
+    }
+    friend bool operator!=(const SsoString& a, const SsoString& b) noexcept { return !(a == b); }
+    friend bool operator<(const SsoString& a, const SsoString& b) noexcept { return a.compare(b) < 0; }
+    friend std::ostream& operator<<(std::ostream& os, const SsoString& s) { return os.write(s.ptr, s.len); }
+
+private:
+    char* ptr;   // Points at 'local' for small strings, at a heap buffer otherwise
+    size_t len;  // Cached length (no strlen)
+    union {
+        size_t cap;                      // Heap capacity (excluding '\0')
+        char local[kLocalCapacity + 1];  // In-place storage
+    };
+
+    bool isLocal() const noexcept { return ptr == local; }
+
+    void release() noexcept {
+        if (!isLocal()) delete[] ptr;
+        ptr = local;
+    }
+};
+
+inline SsoString operator+(SsoString a, const SsoString& b) {
+    a.append(b);
+    return a;
+}
+
+} // End of namespace MyNamespace
+
+#endif // SSO_STRING_H
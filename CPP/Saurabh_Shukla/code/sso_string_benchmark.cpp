@@ -0,0 +1,140 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "sso_string.h"
+#include "../../../C/bench_harness.h"
+
+/* vector<String> workloads (push_back, sort, copy) for:
+   - LegacyString: MyNamespace::String from dynamic_copy_constructor.cpp, which is also what the
+     deep mode of CopyExample in deep_shallow_copy.cpp does (new char[strlen+1] on
+     every construction and copy, no move). Logging removed and a deep copy-assignment added,
+     otherwise std::sort would double-free through the implicit shallow operator=.
+   - MyNamespace::SsoString from sso_string.h,
+   - std::string as a reference point.
+   Usage: ./sso_string_benchmark [strings] [bench_harness options]   (default 100,000) */
+
+static std::atomic<uint64_t> allocationCount(0);
+
+static void* countedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// ✅ Baseline: the existing deep-copy class, minus the logging
+class LegacyString {
+public:
+    LegacyString(const char* s) {
+        str = new char[strlen(s) + 1];
+        strcpy(str, s);
+    }
+    LegacyString(const LegacyString& other) {
+        str = new char[strlen(other.str) + 1];
+        strcpy(str, other.str);
+    }
+    LegacyString& operator=(const LegacyString& other) {
+        if (this != &other) {
+            char* fresh = new char[strlen(other.str) + 1];
+            strcpy(fresh, other.str);
+            delete[] str;
+            str = fresh;
+        }
+        return *this;
+    }
+    ~LegacyString() { delete[] str; }
+    friend bool operator<(const LegacyString& a, const LegacyString& b) { return strcmp(a.str, b.str) < 0; }
+
+private:
+    char* str;
+};
+
+// Mixed workload: ~70% short names (fit in SSO), ~30% long strings (heap in every design)
+std::vector<std::string> makeInputs(size_t count) {
+    static const char* first[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Mallory", "Trent", "Peggy"};
+    std::mt19937 rng(7);
+    std::vector<std::string> inputs;
+    inputs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string s = first[rng() % 8];
+        s += std::to_string(rng() % 100000);
+        if (rng() % 10 < 3) s += "_with_a_long_descriptive_suffix_" + std::to_string(i);
+        inputs.push_back(s);
+    }
+    return inputs;
+}
+
+template <typename Str>
+void runWorkloads(bench_session_t* session, const std::string& label, const std::vector<std::string>& inputs) {
+    size_t n = inputs.size();
+
+    auto runCounted = [&](const std::string& name, auto body) {
+        uint64_t before = allocationCount.load();
+        uint64_t ops = 0;
+        bench_result_t* r = bench::run(session, name.c_str(), [&](uint64_t iters) {
+            for (uint64_t i = 0; i < iters; ++i) body();
+            ops += iters;
+        });
+        if (r) {
+            bench_set_items(r, static_cast<double>(n));
+            std::cout << "    allocations per string: "
+                      << static_cast<double>(allocationCount.load() - before) / (static_cast<double>(ops) * n) << "\n";
+        }
+    };
+
+    // push_back without reserve: exercises vector growth (copy vs move of elements)
+    runCounted("push_back/" + label, [&] {
+        std::vector<Str> v;
+        for (const std::string& s : inputs) v.push_back(Str(s.c_str()));
+        bench::doNotOptimize(v.data());
+    });
+
+    std::vector<Str> source;
+    for (const std::string& s : inputs) source.emplace_back(s.c_str());
+
+    // sort: swaps are copies for LegacyString, moves for the others. One iteration = copy + sort.
+    runCounted("copy_then_sort/" + label, [&] {
+        std::vector<Str> v = source;
+        std::sort(v.begin(), v.end());
+        bench::doNotOptimize(v.data());
+    });
+
+    runCounted("copy/" + label, [&] {
+        std::vector<Str> v = source;
+        bench::doNotOptimize(v.data());
+    });
+}
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    std::vector<std::string> inputs = makeInputs(count);
+    std::cout << "sizeof(LegacyString) = " << sizeof(LegacyString)
+              << ", sizeof(SsoString) = " << sizeof(MyNamespace::SsoString)
+              << ", sizeof(std::string) = " << sizeof(std::string) << "\n\n";
+
+    runWorkloads<LegacyString>(&session, "legacy", inputs);
+    runWorkloads<MyNamespace::SsoString>(&session, "sso", inputs);
+    runWorkloads<std::string>(&session, "std_string", inputs);
+
+    // ✅ Quick functional check of the growth policy and moves
+    MyNamespace::SsoString s("Hello");
+    for (int i = 0; i < 5; ++i) s += ", World";
+    MyNamespace::SsoString moved = std::move(s);
+    std::cout << "\n" << moved << " (size " << moved.size() << ", capacity " << moved.capacity() << ")\n";
+
+    return bench_session_finish(&session);
+}
@@ -0,0 +1,257 @@
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/* Concurrent string interner for data sets that repeat the same strings over and over
+   (Person::name in vector.cpp, student_t::name/city in interface_file_on_disk.c).
+   - intern(s) returns a stable 32-bit id; equal strings always get the same id, so string
+     equality becomes an integer compare and the id itself is a perfect hash.
+   - Bytes live in arena chunks (bump allocation, never moved or freed until the interner dies),
+     stored as [uint32 length][bytes]['\0']: view(id) is a std::string_view that stays valid for
+     the lifetime of the interner, and data() is also a C string.
+   - The hash table is split into 64 stripes, picked by the low bits of the hash. Each stripe
+     has its own shared_mutex, open-addressing table, arena and id block list, so threads
+     interning different strings rarely touch the same lock. Lookups of strings that are already
+     interned (the common case) take the stripe's lock in shared mode only.
+   - view(id) takes no lock: each stripe maps ids to entries through blocks of doubling size
+     (64, 128, 256, ...) that are never reallocated; block pointers are published with release
+     stores. An id obtained from intern()/find() on any thread may be viewed on any thread.
+*/
+
+class StringInterner {
+public:
+    using Id = uint32_t;
+    static constexpr Id kInvalid = 0xFFFFFFFFu;
+
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // Returns the id of 's', adding it if this is the first time it is seen
+    Id intern(std::string_view s) {
+        uint64_t h = hashOf(s);
+        uint32_t stripeIndex = static_cast<uint32_t>(h & kStripeMask);
+        Stripe& st = stripes[stripeIndex];
+        uint32_t tag = static_cast<uint32_t>(h >> 32);
+        {
+            std::shared_lock<std::shared_mutex> lock(st.mutex);
+            uint32_t local = st.lookup(s, tag);
+            if (local != kNoEntry) return makeId(local, stripeIndex);
+        }
+        std::unique_lock<std::shared_mutex> lock(st.mutex);
+        uint32_t local = st.lookup(s, tag); // Another thread may have added it in between
+        if (local == kNoEntry) local = st.insert(s, tag);
+        return makeId(local, stripeIndex);
+    }
+
+    // Returns the id of 's', or kInvalid if it was never interned
+    Id find(std::string_view s) const {
+        uint64_t h = hashOf(s);
+        uint32_t stripeIndex = static_cast<uint32_t>(h & kStripeMask);
+        const Stripe& st = stripes[stripeIndex];
+        std::shared_lock<std::shared_mutex> lock(st.mutex);
+        uint32_t local = st.lookup(s, static_cast<uint32_t>(h >> 32));
+        return local == kNoEntry ? kInvalid : makeId(local, stripeIndex);
+    }
+
+    std::string_view view(Id id) const {
+        const Stripe& st = stripes[id & kStripeMask];
+        uint32_t local = id >> kStripeBits;
+        uint32_t block, offset;
+        locate(local, block, offset);
+        return Stripe::entryView(st.blocks[block].load(std::memory_order_acquire)[offset]);
+    }
+
+    const char* c_str(Id id) const { return view(id).data(); }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const Stripe& st : stripes) n += st.count.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    /* Every id handed out so far is below idLimit(). Ids are (index in stripe) * 64 + stripe,
+       so they are nearly dense: a std::vector of idLimit() slots can stand in for a hash map
+       keyed by id. */
+    size_t idLimit() const {
+        size_t most = 0;
+        for (const Stripe& st : stripes) {
+            size_t n = st.count.load(std::memory_order_relaxed);
+            if (n > most) most = n;
+        }
+        return most << kStripeBits;
+    }
+
+    // Heap bytes held by the interner (arena chunks, hash tables, id blocks)
+    size_t memoryBytes() const {
+        size_t bytes = sizeof(*this);
+        for (const Stripe& st : stripes) {
+            std::shared_lock<std::shared_mutex> lock(st.mutex);
+            bytes += st.arenaBytes + st.blockBytes + st.table.capacity() * sizeof(Slot) +
+                     st.chunks.capacity() * sizeof(void*);
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr uint32_t kStripeBits = 6;
+    static constexpr uint32_t kStripes = 1u << kStripeBits;
+    static constexpr uint64_t kStripeMask = kStripes - 1;
+    static constexpr uint32_t kFirstBlockBits = 6;                 // Block b holds 64 << b ids
+    static constexpr uint32_t kMaxLocal = 1u << (32 - kStripeBits); // Ids per stripe
+    static constexpr uint32_t kMaxBlocks = 32 - kStripeBits - kFirstBlockBits + 1;
+    static constexpr uint32_t kNoEntry = 0xFFFFFFFFu;
+    static constexpr size_t kFirstChunkSize = 1024;
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    struct Slot {
+        uint32_t tag;   // High 32 bits of the hash (also picks the bucket)
+        uint32_t entry; // Stripe-local index + 1, 0 = empty
+    };
+
+    struct alignas(64) Stripe {
+        mutable std::shared_mutex mutex;
+        std::vector<Slot> table;
+        std::atomic<uint32_t> count{0};
+        std::atomic<const char**> blocks[kMaxBlocks] = {};
+        std::vector<std::unique_ptr<char[]>> chunks;
+        char* cursor = nullptr;
+        size_t remaining = 0;
+        size_t arenaBytes = 0;
+        size_t blockBytes = 0;
+
+        ~Stripe() {
+            for (auto& b : blocks) delete[] b.load(std::memory_order_relaxed);
+        }
+
+        static std::string_view entryView(const char* p) {
+            uint32_t len;
+            std::memcpy(&len, p, sizeof(len));
+            return std::string_view(p + sizeof(len), len);
+        }
+
+        const char* entryAt(uint32_t local) const {
+            uint32_t block, offset;
+            locate(local, block, offset);
+            return blocks[block].load(std::memory_order_relaxed)[offset];
+        }
+
+        uint32_t lookup(std::string_view s, uint32_t tag) const {
+            if (table.empty()) return kNoEntry;
+            size_t mask = table.size() - 1;
+            for (size_t i = tag & mask;; i = (i + 1) & mask) {
+                const Slot& slot = table[i];
+                if (slot.entry == 0) return kNoEntry;
+                if (slot.tag == tag && entryView(entryAt(slot.entry - 1)) == s) return slot.entry - 1;
+            }
+        }
+
+        // Caller holds the lock exclusively and has checked that 's' is absent
+        uint32_t insert(std::string_view s, uint32_t tag) {
+            uint32_t local = count.load(std::memory_order_relaxed);
+            if (local >= kMaxLocal - (1u << kFirstBlockBits))
+                throw std::length_error("StringInterner: id space exhausted");
+            if ((local + 1) * 4 > table.size() * 3) grow(); // Load factor <= 3/4
+
+            const char* stored = store(s);
+            uint32_t blockIndex, offset;
+            locate(local, blockIndex, offset);
+            const char** block = blocks[blockIndex].load(std::memory_order_relaxed);
+            if (!block) {
+                size_t ids = size_t(1) << (kFirstBlockBits + blockIndex);
+                block = new const char*[ids];
+                blockBytes += ids * sizeof(const char*);
+                blocks[blockIndex].store(block, std::memory_order_release);
+            }
+            block[offset] = stored;
+
+            size_t mask = table.size() - 1;
+            size_t i = tag & mask;
+            while (table[i].entry != 0) i = (i + 1) & mask;
+            table[i] = {tag, local + 1};
+            count.store(local + 1, std::memory_order_release);
+            return local;
+        }
+
+        void grow() {
+            std::vector<Slot> bigger(table.empty() ? 64 : table.size() * 2, Slot{0, 0});
+            size_t mask = bigger.size() - 1;
+            for (const Slot& slot : table) {
+                if (slot.entry == 0) continue;
+                size_t i = slot.tag & mask;
+                while (bigger[i].entry != 0) i = (i + 1) & mask;
+                bigger[i] = slot;
+            }
+            table.swap(bigger);
+        }
+
+        // Copies [length][bytes]['\0'] into the arena
+        const char* store(std::string_view s) {
+            size_t need = sizeof(uint32_t) + s.size() + 1;
+            if (need > remaining) {
+                // Chunks double from 1 KiB up to kChunkSize, so 64 stripes cost little for small
+                // vocabularies. Strings bigger than a quarter chunk get a chunk of their own,
+                // so the current chunk's tail is not wasted.
+                size_t regular = arenaBytes < kFirstChunkSize ? kFirstChunkSize
+                                 : arenaBytes < kChunkSize    ? arenaBytes
+                                                              : kChunkSize;
+                bool own = need > regular / 4;
+                size_t chunk = own ? need : regular;
+                chunks.emplace_back(new char[chunk]);
+                arenaBytes += chunk;
+                if (!own) {
+                    cursor = chunks.back().get();
+                    remaining = chunk;
+                } else {
+                    char* single = chunks.back().get();
+                    writeEntry(single, s);
+                    return single;
+                }
+            }
+            char* p = cursor;
+            writeEntry(p, s);
+            cursor += need;
+            remaining -= need;
+            return p;
+        }
+
+        static void writeEntry(char* p, std::string_view s) {
+            uint32_t len = static_cast<uint32_t>(s.size());
+            std::memcpy(p, &len, sizeof(len));
+            std::memcpy(p + sizeof(len), s.data(), s.size());
+            p[sizeof(len) + s.size()] = '\0';
+        }
+    };
+
+    Stripe stripes[kStripes];
+
+    static uint64_t hashOf(std::string_view s) {
+        uint64_t h = std::hash<std::string_view>{}(s);
+        h ^= h >> 29; // Mix, so the stripe (low bits) and the bucket/tag (high bits) are independent
+        h *= 0xBF58476D1CE4E5B9ull;
+        return h ^ (h >> 32);
+    }
+
+    // Stripe-local index -> (block, offset): block b starts at 64 * (2^b - 1)
+    static void locate(uint32_t local, uint32_t& block, uint32_t& offset) {
+        uint32_t v = local + (1u << kFirstBlockBits);
+        uint32_t top = 31 - static_cast<uint32_t>(__builtin_clz(v));
+        block = top - kFirstBlockBits;
+        offset = v - (1u << top);
+    }
+
+    static Id makeId(uint32_t local, uint32_t stripeIndex) { return (local << kStripeBits) | stripeIndex; }
+};
+
+#endif // STRING_INTERNER_H
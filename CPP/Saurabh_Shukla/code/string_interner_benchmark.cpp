@@ -0,0 +1,215 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+#include "string_interner.h"
+#include "../../../C/bench_harness.h"
+
+/* Synthetic people records with heavily repeated names and cities:
+   - StringRecord: Person from vector.cpp plus a city, every field a std::string,
+   - InternedRecord: the same record with StringInterner ids (4 bytes per string),
+   - student_t from interface_file_on_disk.c (char name[128], char city[128]), memory only.
+   Reports heap bytes per layout, then equality/hash/group-by speed and concurrent intern()
+   throughput. Usage: ./string_interner_benchmark [records] [bench_harness options]
+   (default 10,000,000 records) */
+
+static std::atomic<size_t> liveHeapBytes(0);
+
+static void* trackedAlloc(std::size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    liveHeapBytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    return p;
+}
+static void trackedFree(void* p) noexcept {
+    if (!p) return;
+    liveHeapBytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+void* operator new(std::size_t size) { return trackedAlloc(size); }
+void* operator new[](std::size_t size) { return trackedAlloc(size); }
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { trackedFree(p); }
+
+struct StringRecord {
+    std::string name;
+    std::string city;
+    int age;
+};
+
+struct InternedRecord {
+    StringInterner::Id name;
+    StringInterner::Id city;
+    int age;
+};
+
+typedef struct student_ { // As in interface_file_on_disk.c
+    int roll_no;
+    int marks;
+    char name[128];
+    char city[128];
+} student_t;
+
+// ~4,000 distinct full names (a third longer than 15 chars, so they leave std::string's SSO) and 40 cities
+struct Vocabulary {
+    std::vector<std::string> names;
+    std::vector<std::string> cities;
+
+    Vocabulary() {
+        const char* first[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Mallory", "Trent", "Peggy",
+                               "Victor", "Walter", "Christopher", "Alexandra", "Maximilian", "Anastasia",
+                               "Bartholomew", "Gwendolyn"};
+        const char* last[] = {"Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller", "Davis",
+                              "Rodriguez", "Martinez", "Hernandez", "Lopez", "Gonzalez", "Wilson", "Anderson",
+                              "Thomas", "Taylor", "Moore", "Jackson", "Martin", "Lee", "Perez", "Thompson",
+                              "White", "Harris", "Sanchez", "Clark", "Ramirez", "Lewis", "Robinson", "Walker",
+                              "Young"};
+        for (const char* f : first)
+            for (const char* l : last)
+                for (int suffix = 0; suffix < 8; ++suffix)
+                    names.push_back(std::string(f) + " " + l + (suffix ? " " + std::to_string(suffix) : ""));
+        const char* c[] = {"Bangalore", "Mumbai", "Delhi", "Chennai", "Hyderabad", "Pune", "Kolkata",
+                           "Ahmedabad", "Jaipur", "Lucknow", "Kanpur", "Nagpur", "Indore", "Thane", "Bhopal",
+                           "Visakhapatnam", "Patna", "Vadodara", "Ghaziabad", "Ludhiana", "Agra", "Nashik",
+                           "Faridabad", "Meerut", "Rajkot", "Varanasi", "Srinagar", "Aurangabad", "Dhanbad",
+                           "Amritsar", "Navi Mumbai", "Allahabad", "Ranchi", "Howrah", "Coimbatore",
+                           "Jabalpur", "Gwalior", "Vijayawada", "Jodhpur", "Thiruvananthapuram"};
+        cities.assign(std::begin(c), std::end(c));
+    }
+};
+
+struct RecordChoice {
+    uint32_t name, city;
+    int age;
+};
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1 && argv[1][0] != '-') ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    static bench_session_t session;
+    bench_session_init(&session, argc, argv);
+
+    Vocabulary vocab;
+    std::vector<RecordChoice> choices(count);
+    std::mt19937 rng(2024);
+    for (RecordChoice& c : choices) {
+        c.name = static_cast<uint32_t>(rng() % vocab.names.size());
+        c.city = static_cast<uint32_t>(rng() % vocab.cities.size());
+        c.age = static_cast<int>(18 + rng() % 60);
+    }
+
+    // ✅ Memory: heap bytes each layout holds for 'count' records
+    size_t before = liveHeapBytes.load();
+    std::vector<StringRecord> stringRecords;
+    stringRecords.reserve(count);
+    for (const RecordChoice& c : choices)
+        stringRecords.push_back({vocab.names[c.name], vocab.cities[c.city], c.age});
+    size_t stringBytes = liveHeapBytes.load() - before;
+
+    before = liveHeapBytes.load();
+    StringInterner interner;
+    std::vector<InternedRecord> internedRecords;
+    internedRecords.reserve(count);
+    for (const RecordChoice& c : choices)
+        internedRecords.push_back({interner.intern(vocab.names[c.name]), interner.intern(vocab.cities[c.city]), c.age});
+    size_t internedBytes = liveHeapBytes.load() - before;
+    size_t studentBytes = count * sizeof(student_t); // Computed, not allocated
+
+    std::cout << count << " records, " << interner.size() << " distinct strings\n"
+              << "  student_t (char[128] x2):  " << studentBytes / (1 << 20) << " MiB\n"
+              << "  std::string fields:        " << stringBytes / (1 << 20) << " MiB\n"
+              << "  interned ids + interner:   " << internedBytes / (1 << 20) << " MiB (interner itself "
+              << interner.memoryBytes() / 1024 << " KiB), " << static_cast<double>(stringBytes) / internedBytes
+              << "x smaller than std::string, " << static_cast<double>(studentBytes) / internedBytes
+              << "x smaller than student_t\n\n";
+
+    // ✅ Equality: count the people called 'target' living in 'targetCity'
+    const std::string target = vocab.names[choices[count / 2].name];
+    const std::string targetCity = vocab.cities[choices[count / 2].city];
+    bench_set_items(bench::run(&session, "equality/std_string", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            size_t hits = 0;
+            for (const StringRecord& r : stringRecords) hits += (r.name == target && r.city == targetCity);
+            bench::doNotOptimize(hits);
+        }
+    }), static_cast<double>(count));
+    bench_set_items(bench::run(&session, "equality/interned", [&](uint64_t iters) {
+        StringInterner::Id id = interner.find(target), cityId = interner.find(targetCity);
+        for (uint64_t it = 0; it < iters; ++it) {
+            size_t hits = 0;
+            for (const InternedRecord& r : internedRecords) hits += (r.name == id && r.city == cityId);
+            bench::doNotOptimize(hits);
+        }
+    }), static_cast<double>(count));
+
+    // ✅ Hashing every name (the inner loop of any hash join / unordered_map keyed by name)
+    bench_set_items(bench::run(&session, "hash/std_string", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            size_t acc = 0;
+            for (const StringRecord& r : stringRecords) acc ^= std::hash<std::string>{}(r.name);
+            bench::doNotOptimize(acc);
+        }
+    }), static_cast<double>(count));
+    bench_set_items(bench::run(&session, "hash/interned", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            size_t acc = 0;
+            for (const InternedRecord& r : internedRecords) acc ^= r.name * 0x9E3779B97F4A7C15ull;
+            bench::doNotOptimize(acc);
+        }
+    }), static_cast<double>(count));
+
+    // ✅ Group by city: hash map keyed by string vs array indexed by id
+    bench_set_items(bench::run(&session, "group_by_city/std_string", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            std::unordered_map<std::string, size_t> perCity;
+            for (const StringRecord& r : stringRecords) ++perCity[r.city];
+            bench::doNotOptimize(perCity.size());
+        }
+    }), static_cast<double>(count));
+    size_t idLimit = interner.idLimit();
+    bench_set_items(bench::run(&session, "group_by_city/interned", [&](uint64_t iters) {
+        for (uint64_t it = 0; it < iters; ++it) {
+            std::vector<size_t> perCity(idLimit);
+            for (const InternedRecord& r : internedRecords) ++perCity[r.city];
+            bench::doNotOptimize(perCity.data());
+            bench::clobberMemory();
+        }
+    }), static_cast<double>(count));
+
+    // ✅ Concurrent intern() of existing names (shared-lock fast path), 1..8 threads
+    size_t lookups = count < 1000000 ? count : 1000000;
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        std::string name = "intern_hits/" + std::to_string(threads) + "_threads";
+        bench_set_items(bench::run(&session, name.c_str(), [&](uint64_t iters) {
+            for (uint64_t it = 0; it < iters; ++it) {
+                std::vector<std::thread> pool;
+                for (unsigned t = 0; t < threads; ++t) {
+                    pool.emplace_back([&, t] {
+                        uint64_t acc = 0;
+                        for (size_t i = t; i < lookups; i += threads) acc += interner.intern(vocab.names[choices[i].name]);
+                        bench::doNotOptimize(acc);
+                    });
+                }
+                for (auto& th : pool) th.join();
+            }
+        }), static_cast<double>(lookups));
+    }
+
+    // ✅ Sanity check: every id maps back to its string
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; i += 997) {
+        mismatches += interner.view(internedRecords[i].name) != stringRecords[i].name;
+        mismatches += interner.view(internedRecords[i].city) != stringRecords[i].city;
+    }
+    std::cout << "\nround-trip mismatches: " << mismatches << "\n";
+    int rc = bench_session_finish(&session);
+    return mismatches ? 1 : rc;
+}
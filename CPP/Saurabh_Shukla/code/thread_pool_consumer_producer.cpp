@@ -7,20 +7,20 @@
 #include <vector>
 #include <queue>
 #include <condition_variable>
-#include <functional>
+#include "mpmc_queue.h"
+#include "inplace_function.h"
+#include "sharded_counter.h"
+#include "../../../C/bench_harness.h"
 
 // ✅ Shared Resources for Synchronization
 std::mutex mtx1, mtx2;  // Mutex for deadlock example
-std::atomic<int> counter(0); // Atomic variable to prevent race conditions
-std::queue<int> dataQueue; // Shared queue for producer-consumer
-std::mutex queueMutex; // Mutex for protecting queue
-std::condition_variable queueCV; // Condition variable for producer-consumer
-bool done = false; // Flag to stop consumer
+ShardedCounter<> counter; // Per-thread padded cells prevent races without cache-line ping-pong
+BlockingMPMCQueue<int> dataQueue(64); // Lock-free bounded queue for producer-consumer
 
-// 🚨 Prevents: Race Condition ✅ (Atomic counter)
+// 🚨 Prevents: Race Condition ✅ (Sharded counter)
 void safeIncrement() {
     for (int i = 0; i < 1000; ++i) {
-        counter++; // Atomic operation prevents race conditions.
+        counter++; // Uncontended update of this thread's cell.
     }
 }
 
@@ -38,21 +38,23 @@ void detachedFunction() {
     std::cout << "Detached thread executed after main function.\n";
 }
 
-// 🚨 Prevents: Inaccurate Timing ✅ (Using std::chrono)
-void timedFunction() {
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    std::thread t1(safeIncrement);
-    std::thread t2(safeIncrement);
-    
-    t1.join();
-    t2.join(); // Ensure threads complete execution before proceeding
-
-    auto end = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> duration = end - start;
-    
-    std::cout << "Final Counter Value: " << counter.load() << "\n";
-    std::cout << "Execution Time: " << duration.count() << " seconds\n";
+// 🚨 Prevents: Inaccurate Timing ✅ (Warm-up, repetitions and median via the benchmark harness)
+void timedFunction(int argc, char** argv) {
+    static bench_session_t session; // Large result table, keep it off the stack
+    bench_session_init(&session, argc, argv); // --reps=, --json=, ...
+
+    bench::run(&session, "two_threads_safeIncrement", [](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            counter.reset(); // Each run starts from zero
+            std::thread t1(safeIncrement);
+            std::thread t2(safeIncrement);
+            t1.join();
+            t2.join(); // Ensure threads complete execution before proceeding
+        }
+    });
+    bench_session_finish(&session);
+
+    std::cout << "Final Counter Value: " << counter.load() << "\n"; // Last run: 2 x 1000
 }
 
 // 🚨 Prevents: Manual Thread Management Issues ✅ (Using std::async)
@@ -62,29 +64,21 @@ int computeValue() {
 }
 
 // ✅ Producer-Consumer Model
-// 🚨 Prevents: Busy-Waiting ✅ (Using condition variables)
+// 🚨 Prevents: Busy-Waiting ✅ (Consumer sleeps on a futex only while the queue is empty)
+// 🚨 Prevents: Data Race on the stop flag ✅ (close() is atomic, unlike a plain `bool done`)
 void producer() {
     for (int i = 1; i <= 5; ++i) {
         std::this_thread::sleep_for(std::chrono::milliseconds(500)); // Simulate work
-        std::lock_guard<std::mutex> lock(queueMutex);
-        dataQueue.push(i);
+        dataQueue.push(i); // Lock-free, wakes the consumer only if it is sleeping
         std::cout << "Produced: " << i << "\n";
-        queueCV.notify_one(); // Notify consumer
     }
-    done = true; // Stop flag for consumer
-    queueCV.notify_one();
+    dataQueue.close(); // Stop signal for consumer
 }
 
 void consumer() {
-    while (true) {
-        std::unique_lock<std::mutex> lock(queueMutex);
-        queueCV.wait(lock, [] { return !dataQueue.empty() || done; }); // Wait until queue is non-empty or done
-        while (!dataQueue.empty()) {
-            int item = dataQueue.front();
-            dataQueue.pop();
-            std::cout << "Consumed: " << item << "\n";
-        }
-        if (done) break; // Stop if producer is done
+    int item;
+    while (dataQueue.pop(item)) { // Blocks while empty, returns false once closed and drained
+        std::cout << "Consumed: " << item << "\n";
     }
 }
 
@@ -92,11 +86,13 @@ void consumer() {
 // 🚨 Prevents: Overhead of Creating/Destroying Threads ✅ (Using a fixed pool)
 class ThreadPool {
 public:
+    using Task = inplace_function<void(), 64>; // Captures up to 64 bytes, stored without allocating
+
     explicit ThreadPool(size_t numThreads) {
         for (size_t i = 0; i < numThreads; ++i) {
             workers.emplace_back([this] {
                 while (true) {
-                    std::function<void()> task;
+                    Task task;
                     {
                         std::unique_lock<std::mutex> lock(queueMutex);
                         condition.wait(lock, [this] { return !tasks.empty() || stop; });
@@ -111,7 +107,7 @@ public:
     }
 
     // Enqueue task
-    void enqueue(std::function<void()> task) {
+    void enqueue(Task task) {
         {
             std::lock_guard<std::mutex> lock(queueMutex);
             tasks.push(std::move(task));
@@ -133,17 +129,17 @@ public:
 
 private:
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    std::queue<Task> tasks;
     std::mutex queueMutex;
     std::condition_variable condition;
     bool stop = false;
 };
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "Starting Extended Multithreading Example...\n";
 
     // ✅ Prevents: Race Conditions using atomic variables
-    timedFunction();
+    timedFunction(argc, argv);
 
     // ✅ Prevents: Deadlock by ensuring proper locking order
     std::thread deadlockThread1(deadlockSafeFunction);
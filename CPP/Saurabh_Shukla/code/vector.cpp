@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include "soa_vector.h"
 
 struct Person {
     std::string name;
@@ -14,5 +15,17 @@ int main() {
         std::cout << "Name: " << it->name << ", Age: " << it->age << std::endl;
     }
 
+    // Same records as a structure of arrays: names and ages in separate contiguous arrays.
+    // The iterator yields a proxy, so fields are reached with get<&Person::member>()
+    SoAVector<Person, &Person::name, &Person::age> columns = { {"Alice", 25}, {"Bob", 30}, {"Charlie", 22} };
+    for (auto it = columns.begin(); it != columns.end(); ++it) {
+        std::cout << "Name: " << it->get<&Person::name>() << ", Age: " << it->get<&Person::age>() << std::endl;
+    }
+
+    // Scans over one field only touch that field's array
+    int total = 0;
+    for (int age : columns.column<&Person::age>()) total += age;
+    std::cout << "Average age: " << total / static_cast<double>(columns.size()) << std::endl;
+
     return 0;
 }
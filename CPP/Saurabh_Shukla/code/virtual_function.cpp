@@ -26,6 +26,7 @@
 // 4. If a function is non-virtual, the function call is **resolved at compile-time** instead of using the vtable.
 
 #include <iostream>
+#include "closed_hierarchy.h"
 using namespace std;
 
 class Base {
@@ -46,6 +47,37 @@ public:
     void display() override { cout << "Derived::display" << endl; } 
 };
 
+// Static (CRTP) version of the same hierarchy: StaticBase<Derived> knows its derived type at
+// compile time, so show()/display() are resolved by the compiler, can be inlined, and the
+// objects carry no vptr. The price: there is no common base type to point at, so code that
+// works on "any StaticBase" is a template (see callThroughBase below).
+template <typename Derived>
+class StaticBase : public StaticInterface<Derived> {
+public:
+    int x;
+
+    void show() const { this->self().showImpl(); }
+    void display() const { this->self().displayImpl(); }
+
+    // Defaults, used when Derived does not provide its own (like a non-overridden virtual)
+    void showImpl() const { cout << "StaticBase::show" << endl; }
+    void displayImpl() const { cout << "StaticBase::display" << endl; }
+};
+
+class StaticDerived : public StaticBase<StaticDerived> {
+public:
+    int y;
+
+    void showImpl() const { cout << "StaticDerived::show" << endl; }
+    void displayImpl() const { cout << "StaticDerived::display" << endl; }
+};
+
+template <typename D>
+void callThroughBase(const StaticBase<D>& b) {
+    b.show();    // Compiles to a direct call to StaticDerived::showImpl()
+    b.display();
+}
+
 int main() {
     Base* bptr; // Base class pointer
     Derived d;  // Derived class object
@@ -67,5 +99,11 @@ int main() {
     // 3. Since Derived class overrides `display()`, `Derived::display()` is called.
     bptr->display(); 
 
+    // Compile-time dispatch: same output, no vtable lookup
+    StaticDerived sd;
+    callThroughBase(sd);
+    cout << "sizeof(Derived) = " << sizeof(Derived) << " (with vptr), sizeof(StaticDerived) = "
+         << sizeof(StaticDerived) << " (no vptr)" << endl;
+
     return 0;
 }